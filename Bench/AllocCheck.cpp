@@ -0,0 +1,111 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+// Heap allocation check of the portable hot path, built with BASS_ALLOC_TRACKING.
+// Fails if the simulated steady-state loop allocates after the warm-up,
+// prints the allocating sites of the simulated load.
+//
+// Usage: AllocCheck
+
+#include "stdafx.h"
+#include "AllocTracker.h"
+#include "BassHelper.h"
+#include "Trace.h"
+#include "Utils/BitReader.h"
+#include "TagCorpus.h"
+
+#include <cstdio>
+
+#ifndef BASS_ALLOC_TRACKING
+#error "AllocCheck requires BASS_ALLOC_TRACKING"
+#endif
+
+static size_t g_sink = 0;
+
+// the tag reading of BassDecoder::Load
+static void SimulateLoad(const std::vector<uint8_t>& id3v2, const std::vector<char>& ogg)
+{
+	ALLOC_SCOPE(SCOPE_Load, "ReadTagsID3v2");
+
+	ContentTags tags;
+	auto pResources = std::make_unique<std::list<DSMResource>>();
+	ReadTagsID3v2((const char*)id3v2.data(), tags, pResources);
+
+	ALLOC_SITE("ReadTagsOgg");
+	ReadTagsOgg(ogg.data(), tags, pResources);
+
+	ALLOC_SITE("ContentTags copy");
+	ContentTags copy = tags;
+
+	g_sink += copy.Title.size() + pResources->size();
+}
+
+// the per-buffer work of FillBuffer that does not depend on BASS
+static void SimulateFillBuffer(const std::vector<uint8_t>& block, uint32_t i)
+{
+	Trace::Scope trace(Trace::EV_FillBuffer, (uint32_t)block.size());
+
+	BitReader br(block.data(), block.size());
+	while (br.GetBitsLeft() >= 32) {
+		g_sink += br.ReadBits(11) + br.ReadBits(21);
+	}
+	Trace::Counter(Trace::EV_NetData, i);
+}
+
+int main()
+{
+	int errors = 0;
+
+	// self-test, the tracker must see a scoped allocation and a steady-state violation
+	{
+		AllocTracker::SteadyStateCheck check(AllocTracker::SCOPE_Seek, 1);
+		for (int i = 0; i < 3; i++) {
+			check.Begin();
+			ALLOC_SCOPE(SCOPE_Seek, "self-test");
+			std::vector<int> v(16);
+			g_sink += v.size();
+			check.End();
+		}
+		if (AllocTracker::GetStats(AllocTracker::SCOPE_Seek).count < 3 || AllocTracker::GetSteadyStateAllocs() != 2) {
+			fprintf(stderr, "ERROR: AllocTracker self-test failed\n");
+			errors++;
+		}
+		AllocTracker::Reset();
+	}
+
+	TagCorpus::ID3v2Params params;
+	params.pictureSize = 16 * 1024;
+	const auto id3v2 = TagCorpus::MakeID3v2Tag(params, 1);
+	const auto ogg = TagCorpus::MakeVorbisComments(12, 32, 0, 2);
+	const std::vector<uint8_t> block(2048, 0x5A);
+
+	SimulateLoad(id3v2, ogg);
+
+	Trace::Enable(true);
+
+	AllocTracker::SteadyStateCheck check(AllocTracker::SCOPE_FillBuffer, 4);
+	for (uint32_t i = 0; i < 10000; i++) {
+		check.Begin();
+		ALLOC_ENTER(SCOPE_FillBuffer, "FillBuffer");
+		SimulateFillBuffer(block, i);
+		ALLOC_LEAVE();
+		check.End();
+	}
+
+	Trace::Enable(false);
+
+	printf("%ls\n", AllocTracker::GetReport().c_str());
+
+	if (AllocTracker::GetStats(AllocTracker::SCOPE_Load).count == 0) {
+		fprintf(stderr, "ERROR: no allocations attributed to Load\n");
+		errors++;
+	}
+	if (AllocTracker::GetSteadyStateAllocs()) {
+		fprintf(stderr, "ERROR: the steady-state loop allocates\n");
+		errors++;
+	}
+	printf("checksum: %zu\n", g_sink);
+
+	return errors ? 1 : 0;
+}
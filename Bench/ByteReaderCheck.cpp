@@ -0,0 +1,199 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+// Unit check of ByteReader, ByteSpan and the bit readers with known byte patterns:
+// 24-bit reads (no sign extension, byte order), bulk array reads with and without the swap,
+// MSB-first and LSB-first bit reads near the end of the buffer, 64-bit bit reads
+// and the error flag of the reads past the end.
+//
+// Usage: ByteReaderCheck
+
+#include "stdafx.h"
+#include "Utils/BitReader.h"
+
+#include <cstdio>
+
+static int g_errors = 0;
+
+#define CHECK(expr) \
+	if (!(expr)) { \
+		fprintf(stderr, "ERROR: %s:%d: %s\n", __FILE__, __LINE__, #expr); \
+		g_errors++; \
+	}
+
+static void CheckByteReader()
+{
+	const uint8_t data[] = { 0x01, 0x02, 0xFF, 0x80, 0x7F, 0xFE, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+
+	// the high bit of the third byte is not a sign
+	{
+		ByteReader br(data);
+		br.SetSize(sizeof(data));
+		CHECK(br.Read24Le() == 0xFF0201);
+		CHECK(br.Read24Be() == 0x807FFE);
+		CHECK(br.GetPos() == 6);
+		CHECK(!br.GetError());
+	}
+	{
+		ByteSpan span(data, sizeof(data));
+		CHECK(span.Read24Be() == 0x0102FF);
+		CHECK(span.Read24Le() == 0xFE7F80);
+		CHECK(span.GetRemainder() == sizeof(data) - 6);
+	}
+
+	// fixed size reads
+	{
+		ByteReader br(data + 6);
+		br.SetSize(8);
+		CHECK(br.Read16Le() == 0x2211);
+		CHECK(br.Read16Be() == 0x3344);
+		CHECK(br.Read32Le() == 0x88776655);
+		CHECK(br.GetRemainder() == 0);
+		CHECK(!br.GetError());
+
+		br.Seek(0);
+		CHECK(br.Read64Be() == 0x1122334455667788ull);
+		br.Seek(0);
+		CHECK(br.Read64Le() == 0x8877665544332211ull);
+	}
+
+	// past the end: zero, the error flag, the position at the end
+	{
+		ByteReader br(data);
+		br.SetSize(2);
+		CHECK(br.Read24Le() == 0);
+		CHECK(br.GetError());
+		CHECK(br.GetRemainder() == 0);
+	}
+	{
+		ByteReader br(data);
+		br.SetSize(5);
+		CHECK(br.Read32Be() == 0x0102FF80);
+		CHECK(br.Read24Be() == 0);
+		CHECK(br.GetError());
+	}
+}
+
+static void CheckReadArray()
+{
+	const uint8_t data[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09 };
+
+	{
+		ByteReader br(data);
+		br.SetSize(sizeof(data));
+		uint16_t le[2] = {};
+		uint16_t be[2] = {};
+		CHECK(br.ReadArray16Le(le, 2));
+		CHECK(br.ReadArray16Be(be, 2));
+		CHECK(le[0] == 0x0201 && le[1] == 0x0403);
+		CHECK(be[0] == 0x0506 && be[1] == 0x0708);
+		CHECK(br.GetPos() == 8);
+		CHECK(!br.GetError());
+	}
+	{
+		ByteReader br(data);
+		br.SetSize(sizeof(data));
+		uint32_t le[1] = {};
+		uint32_t be[1] = {};
+		CHECK(br.ReadArray32Le(le, 1));
+		CHECK(br.ReadArray32Be(be, 1));
+		CHECK(le[0] == 0x04030201);
+		CHECK(be[0] == 0x05060708);
+	}
+
+	// the whole array is checked before anything is read
+	{
+		ByteReader br(data);
+		br.SetSize(sizeof(data));
+		uint16_t dst[5] = { 0xAAAA, 0xAAAA, 0xAAAA, 0xAAAA, 0xAAAA };
+		CHECK(!br.ReadArray16Be(dst, 5));
+		CHECK(dst[0] == 0xAAAA);
+		CHECK(br.GetError());
+		CHECK(br.GetRemainder() == 0);
+	}
+	{
+		ByteReader br(data);
+		br.SetSize(sizeof(data));
+		uint16_t dst[1] = {};
+		CHECK(br.ReadArray16Le(dst, 0));
+		CHECK(br.GetPos() == 0 && !br.GetError());
+	}
+}
+
+static void CheckBitReader()
+{
+	// 1011 0101 0011 1100 ...
+	const uint8_t data[] = { 0xB5, 0x3C, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A };
+
+	{
+		BitReader br(data, sizeof(data));
+		CHECK(br.ReadBits(3) == 0x5);
+		CHECK(br.ReadBits(5) == 0x15);
+		CHECK(br.ShowBits(4) == 0x3);
+		CHECK(br.ReadBits(4) == 0x3);
+		CHECK(br.ReadBit());
+		CHECK(br.ReadBits(3) == 0x4);
+		CHECK(br.GetBitPos() == 16);
+		// 64-bit reads, the high part first
+		CHECK(br.ReadBits64(40) == 0x0102030405ull);
+		CHECK(br.ReadBits64(33) == (0x06070809ull << 1));
+		CHECK(br.GetBitsLeft() == 7);
+		CHECK(br.ReadBits(7) == 0x0A);
+		CHECK(!br.GetError());
+		CHECK(br.ReadBits(1) == 0);
+		CHECK(br.GetError());
+	}
+	{
+		BitReaderLsb br(data, sizeof(data));
+		CHECK(br.ReadBits(3) == 0x5);
+		CHECK(br.ReadBits(5) == 0x16);
+		CHECK(br.ReadBits(4) == 0xC);
+		CHECK(br.ReadBits(4) == 0x3);
+		// 64-bit reads, the low part first
+		CHECK(br.ReadBits64(40) == 0x0504030201ull);
+		CHECK(br.ReadBits64(40) == 0x0A09080706ull);
+		CHECK(br.GetBitsLeft() == 0);
+		CHECK(!br.GetError());
+	}
+
+	// reads that end in the last bytes, the 64-bit load is not used there
+	{
+		const uint8_t tail[] = { 0x80, 0x00, 0x01 };
+		BitReader br(tail, sizeof(tail));
+		br.SkipBits(1);
+		CHECK(br.ReadBits(23) == 0x000001);
+		CHECK(br.GetBitsLeft() == 0 && !br.GetError());
+
+		BitReaderLsb lsb(tail, sizeof(tail));
+		CHECK(lsb.ReadBits(24) == 0x010080);
+		CHECK(lsb.ReadBits(32) == 0);
+		CHECK(lsb.GetError());
+	}
+
+	{
+		BitReader br(data, sizeof(data));
+		br.ReadBits(3);
+		br.ByteAlign();
+		CHECK(br.GetBitPos() == 8);
+		CHECK(br.GetPtr() == data + 1);
+		CHECK(br.ReadBits(32) == 0x3C010203);
+		CHECK(!br.SkipBits(100));
+		CHECK(br.GetError() && br.GetBitsLeft() == 0);
+	}
+}
+
+int main()
+{
+	CheckByteReader();
+	CheckReadArray();
+	CheckBitReader();
+
+	if (g_errors) {
+		fprintf(stderr, "%d checks failed\n", g_errors);
+		return 1;
+	}
+	printf("ByteReader checks passed\n");
+
+	return 0;
+}
@@ -0,0 +1,282 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+// Range cache of remote files against a simulated HTTP server with a limited bandwidth
+// and a request latency: cold and warm playback, seeks, a changed resource and eviction.
+// Then the throughput of parallel range requests with 1 to 8 connections.
+//
+// Usage: HttpCacheBench [--quick]
+
+#include "stdafx.h"
+#include "HttpFile.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+// in-process stand-in of a HTTP server that supports range requests
+struct SimServer {
+	std::vector<uint8_t> data;
+	double bandwidth;     // bytes per second of one connection
+	double latency;       // seconds until the first byte of a response
+	std::atomic<uint64_t> netBytes = 0;
+	std::atomic<uint64_t> requests = 0;
+};
+
+class SimStream : public HttpStream
+{
+	SimServer& m_server;
+	uint64_t m_pos = 0;
+	uint64_t m_end = 0;
+	uint64_t m_sent = 0;
+	std::chrono::steady_clock::time_point m_start;
+	std::atomic<bool> m_cancelled = false;
+
+public:
+	SimStream(SimServer& server) : m_server(server) {}
+
+	bool Open(uint64_t pos, uint64_t end) override
+	{
+		std::this_thread::sleep_for(std::chrono::duration<double>(m_server.latency));
+		if (m_cancelled) {
+			return false;
+		}
+		m_server.requests++;
+		m_pos = pos;
+		m_end = std::min<uint64_t>(end, m_server.data.size());
+		m_sent = 0;
+		m_start = std::chrono::steady_clock::now();
+		return pos < m_end;
+	}
+
+	size_t Read(void* buffer, size_t size) override
+	{
+		const size_t n = (size_t)std::min<uint64_t>({ size, m_end - m_pos, 64 * 1024 });
+		if (!n || m_cancelled) {
+			return 0;
+		}
+		m_sent += n;
+		std::this_thread::sleep_until(m_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(m_sent / m_server.bandwidth)));
+		memcpy(buffer, m_server.data.data() + m_pos, n);
+		m_pos += n;
+		m_server.netBytes += n;
+		return n;
+	}
+
+	void Cancel() override
+	{
+		m_cancelled = true;
+	}
+};
+
+struct PlayResult {
+	double seconds;
+	uint64_t netBytes;
+	uint64_t requests;
+	bool ok;
+};
+
+// reads [start, end) in blocks of the size BASS uses for buffered files
+static bool ReadRange(HttpFile& file, const std::vector<uint8_t>& data, uint64_t start, uint64_t end)
+{
+	std::vector<uint8_t> buffer(64 * 1024);
+	if (!file.Seek(start)) {
+		return false;
+	}
+	for (uint64_t pos = start; pos < end; ) {
+		const size_t n = file.Read(buffer.data(), (size_t)std::min<uint64_t>(buffer.size(), end - pos));
+		if (!n || memcmp(buffer.data(), data.data() + pos, n) != 0) {
+			return false;
+		}
+		pos += n;
+	}
+	return true;
+}
+
+template <typename F>
+static PlayResult Play(SimServer& server, std::shared_ptr<RangeCacheEntry> entry, unsigned connections, F&& reads)
+{
+	const uint64_t netBytes = server.netBytes;
+	const uint64_t requests = server.requests;
+
+	const auto start = std::chrono::steady_clock::now();
+	bool ok;
+	{
+		HttpFile file([&] { return std::make_unique<SimStream>(server); }, server.data.size(), std::move(entry), connections);
+		ok = reads(file);
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	return { seconds, server.netBytes - netBytes, server.requests - requests, ok };
+}
+
+template <typename F>
+static PlayResult Play(SimServer& server, RangeCache& cache, const std::wstring& url, const std::wstring& validator, F&& reads)
+{
+	return Play(server, cache.Open(url, validator, server.data.size()), 1, reads);
+}
+
+int main(int argc, char* argv[])
+{
+	bool quick = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0) {
+			quick = true;
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--quick]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	const size_t fileSize = quick ? 4 * 1024 * 1024 : 32 * 1024 * 1024;
+	int errors = 0;
+
+	SimServer server;
+	server.data.resize(fileSize);
+	std::mt19937 rng(3);
+	for (auto& b : server.data) {
+		b = (uint8_t)rng();
+	}
+	server.bandwidth = quick ? 64.0 * 1024 * 1024 : 16.0 * 1024 * 1024;
+	server.latency = 0.02;
+
+	const fs::path dir = fs::temp_directory_path() / "HttpCacheBench";
+	std::error_code ec;
+	fs::remove_all(dir, ec);
+	std::wstring directory = dir.wstring();
+	directory += fs::path::preferred_separator;
+
+	const auto& data = server.data;
+	const uint64_t size = data.size();
+	auto Sequential = [&](HttpFile& file) { return ReadRange(file, data, 0, size); };
+
+	printf("%zu MiB file, %.0f MiB/s, %.0f ms latency\n", fileSize / (1024 * 1024), server.bandwidth / (1024 * 1024), server.latency * 1000);
+	printf("%-24s %10s %12s %10s\n", "case", "ms", "net KiB", "requests");
+
+	auto Report = [&](const char* name, const PlayResult& r) {
+		printf("%-24s %10.1f %12llu %10llu\n", name, r.seconds * 1000, (unsigned long long)(r.netBytes / 1024), (unsigned long long)r.requests);
+		if (!r.ok) {
+			fprintf(stderr, "ERROR: %s: the content differs\n", name);
+			errors++;
+		}
+	};
+
+	{
+		RangeCache cache(directory, size * 4);
+		const PlayResult cold = Play(server, cache, L"http://sim/a.flac", L"\"v1\"", Sequential);
+		Report("cold", cold);
+		if (cold.netBytes != size) {
+			fprintf(stderr, "ERROR: cold playback downloaded %llu bytes\n", (unsigned long long)cold.netBytes);
+			errors++;
+		}
+	}
+	{
+		// a new cache object reads the entries from the disk, as in a new process
+		RangeCache cache(directory, size * 4);
+		const PlayResult warm = Play(server, cache, L"http://sim/a.flac", L"\"v1\"", Sequential);
+		Report("warm (new process)", warm);
+		if (warm.netBytes || warm.requests) {
+			fprintf(stderr, "ERROR: warm playback downloaded %llu bytes\n", (unsigned long long)warm.netBytes);
+			errors++;
+		}
+
+		// seeks forward and back, only the gaps are downloaded
+		const PlayResult seek = Play(server, cache, L"http://sim/b.flac", L"\"v1\"", [&](HttpFile& file) {
+			return ReadRange(file, data, 0, size / 4)
+				&& ReadRange(file, data, size * 3 / 4, size)
+				&& ReadRange(file, data, size / 8, size / 2)
+				&& ReadRange(file, data, 0, size);
+		});
+		Report("seeks", seek);
+		if (seek.netBytes != size) {
+			fprintf(stderr, "ERROR: the seeks downloaded %llu bytes, expected %llu\n", (unsigned long long)seek.netBytes, (unsigned long long)size);
+			errors++;
+		}
+
+		const PlayResult changed = Play(server, cache, L"http://sim/a.flac", L"\"v2\"", Sequential);
+		Report("changed resource", changed);
+		if (changed.netBytes != size) {
+			fprintf(stderr, "ERROR: a changed resource was served from the cache\n");
+			errors++;
+		}
+	}
+	{
+		// room for two files, the least recently used entries are removed
+		RangeCache cache(directory, size * 2 + size / 2);
+		const PlayResult evict = Play(server, cache, L"http://sim/c.flac", L"\"v1\"", Sequential);
+		Report("eviction", evict);
+
+		RangeCacheStats_t stats;
+		cache.GetStats(stats);
+		printf("cache: %llu entries, %llu KiB of %llu KiB, %llu evicted\n", (unsigned long long)stats.entries,
+			(unsigned long long)(stats.totalBytes / 1024), (unsigned long long)(stats.maxBytes / 1024), (unsigned long long)stats.evictedEntries);
+		if (stats.totalBytes > stats.maxBytes || stats.evictedEntries == 0) {
+			fprintf(stderr, "ERROR: the cache size is not bounded\n");
+			errors++;
+		}
+
+		// the most recent entry is still cached
+		const PlayResult recent = Play(server, cache, L"http://sim/c.flac", L"\"v1\"", Sequential);
+		if (recent.netBytes) {
+			fprintf(stderr, "ERROR: the most recent entry was evicted\n");
+			errors++;
+		}
+	}
+
+	// parallel range requests, the bandwidth of one connection is the bottleneck
+	server.bandwidth = quick ? 8.0 * 1024 * 1024 : 4.0 * 1024 * 1024;
+	server.latency = 0.05;
+	printf("\nparallel requests, %.0f MiB/s per connection, %.0f ms latency\n", server.bandwidth / (1024 * 1024), server.latency * 1000);
+	printf("%-24s %10s %12s %10s %10s\n", "connections", "ms", "net KiB", "requests", "MiB/s");
+
+	double single = 0;
+	for (unsigned connections : { 1, 2, 4, 8 }) {
+		const PlayResult r = Play(server, nullptr, connections, Sequential);
+		const double rate = size / r.seconds / (1024 * 1024);
+		printf("%-24u %10.1f %12llu %10llu %10.1f\n", connections, r.seconds * 1000,
+			(unsigned long long)(r.netBytes / 1024), (unsigned long long)r.requests, rate);
+		if (!r.ok) {
+			fprintf(stderr, "ERROR: %u connections: the content differs\n", connections);
+			errors++;
+		}
+		if (connections == 1) {
+			single = rate;
+		}
+		else if (connections == 4 && rate < single * 2) {
+			fprintf(stderr, "ERROR: 4 connections are not faster than one (%.1f MiB/s, %.1f MiB/s)\n", rate, single);
+			errors++;
+		}
+	}
+
+	{
+		// seeks with parallel requests, the downloaded chunks are added to the range cache
+		RangeCache cache(directory, size * 4);
+		const PlayResult seek = Play(server, cache.Open(L"http://sim/d.flac", L"\"v1\"", size), 4, [&](HttpFile& file) {
+			return ReadRange(file, data, 0, size / 4)
+				&& ReadRange(file, data, size * 3 / 4, size)
+				&& ReadRange(file, data, size / 8, size / 2)
+				&& ReadRange(file, data, 0, size);
+		});
+		Report("parallel seeks", seek);
+
+		const PlayResult warm = Play(server, cache.Open(L"http://sim/d.flac", L"\"v1\"", size), 4, Sequential);
+		Report("parallel warm", warm);
+		if (warm.netBytes) {
+			fprintf(stderr, "ERROR: the chunks were not added to the range cache\n");
+			errors++;
+		}
+	}
+
+	fs::remove_all(dir, ec);
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+// Memory-mapped file input against buffered reads: fread in blocks of the size
+// BASS reads, MappedFile::Read with sliding views and with the whole file mapped,
+// and direct access to the mapping, as BASS does with a stream created from memory.
+// The file is read once before the measurement, so all the cases read the page cache.
+//
+// Usage: MappedFileBench [--quick] [file]
+//   file - e.g. a multi-GB DSD or WAV file, by default a generated file is used
+
+#include "stdafx.h"
+#include "MappedFile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+
+namespace fs = std::filesystem;
+
+#define READ_BLOCK (64 * 1024)
+
+#ifdef _WIN32
+#define fseek64 _fseeki64
+#else
+#define fseek64 fseeko
+#endif
+
+struct ReadResult {
+	double seconds;
+	uint64_t bytes;
+	uint64_t checksum;
+};
+
+// a checksum over all the bytes, so the data is really read
+static inline uint64_t Checksum(uint64_t sum, const uint8_t* data, size_t size)
+{
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		uint64_t v;
+		memcpy(&v, data + i, 8);
+		sum = (sum ^ v) * 0x100000001B3ull;
+	}
+	for (; i < size; i++) {
+		sum = (sum ^ data[i]) * 0x100000001B3ull;
+	}
+	return sum;
+}
+
+template <typename F>
+static ReadResult Measure(F&& read)
+{
+	const auto start = std::chrono::steady_clock::now();
+	ReadResult r = {};
+	read(r);
+	r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return r;
+}
+
+static ReadResult ReadStdio(const fs::path& path)
+{
+	return Measure([&](ReadResult& r) {
+		FILE* f = fopen(path.string().c_str(), "rb");
+		if (!f) {
+			return;
+		}
+		std::vector<uint8_t> buffer(READ_BLOCK);
+		size_t n;
+		while ((n = fread(buffer.data(), 1, buffer.size(), f)) > 0) {
+			r.checksum = Checksum(r.checksum, buffer.data(), n);
+			r.bytes += n;
+		}
+		fclose(f);
+	});
+}
+
+static ReadResult ReadMapped(const fs::path& path, size_t viewSize)
+{
+	return Measure([&](ReadResult& r) {
+		MappedFile file(viewSize);
+		if (!file.Open(path.wstring())) {
+			return;
+		}
+		std::vector<uint8_t> buffer(READ_BLOCK);
+		size_t n;
+		while ((n = file.Read(buffer.data(), buffer.size())) > 0) {
+			r.checksum = Checksum(r.checksum, buffer.data(), n);
+			r.bytes += n;
+		}
+	});
+}
+
+static ReadResult ReadDirect(const fs::path& path)
+{
+	return Measure([&](ReadResult& r) {
+		MappedFile file;
+		if (!file.Open(path.wstring()) || !file.GetData()) {
+			return;
+		}
+		const uint8_t* data = file.GetData();
+		const uint64_t length = file.GetLength();
+		for (uint64_t pos = 0; pos < length; pos += READ_BLOCK) {
+			file.Prefetch(pos);
+			const size_t n = (size_t)std::min<uint64_t>(READ_BLOCK, length - pos);
+			r.checksum = Checksum(r.checksum, data + pos, n);
+			r.bytes += n;
+		}
+	});
+}
+
+// random seeks and reads must return the same bytes as the file
+static bool CheckSeeks(const fs::path& path, size_t viewSize)
+{
+	FILE* f = fopen(path.string().c_str(), "rb");
+	MappedFile file(viewSize);
+	if (!f || !file.Open(path.wstring())) {
+		if (f) {
+			fclose(f);
+		}
+		return false;
+	}
+
+	std::mt19937_64 rng(5);
+	std::vector<uint8_t> expected(READ_BLOCK * 3);
+	std::vector<uint8_t> actual(READ_BLOCK * 3);
+	bool ok = true;
+	for (int i = 0; i < 200 && ok; i++) {
+		const uint64_t pos = rng() % file.GetLength();
+		const size_t size = (size_t)(rng() % actual.size()) + 1;
+
+		fseek64(f, pos, SEEK_SET);
+		const size_t n1 = fread(expected.data(), 1, size, f);
+		const size_t n2 = file.Seek(pos) ? file.Read(actual.data(), size) : 0;
+		ok = (n1 == n2) && memcmp(expected.data(), actual.data(), n1) == 0;
+	}
+	fclose(f);
+
+	return ok;
+}
+
+int main(int argc, char* argv[])
+{
+	bool quick = false;
+	fs::path path;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0) {
+			quick = true;
+		}
+		else if (argv[i][0] != '-' && path.empty()) {
+			path = argv[i];
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--quick] [file]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	bool generated = false;
+	if (path.empty()) {
+		// a size that is not a multiple of the view size, the last view is partial
+		const size_t size = quick ? 48 * 1024 * 1024 + 12345 : 1024 * 1024 * 1024 + 12345;
+		path = fs::temp_directory_path() / "MappedFileBench.bin";
+		FILE* f = fopen(path.string().c_str(), "wb");
+		if (!f) {
+			fprintf(stderr, "ERROR: can not create %s\n", path.string().c_str());
+			return 1;
+		}
+		std::mt19937 rng(7);
+		std::vector<uint32_t> block(1024 * 1024 / 4);
+		for (size_t written = 0; written < size; ) {
+			for (auto& v : block) {
+				v = rng();
+			}
+			const size_t n = std::min(block.size() * 4, size - written);
+			fwrite(block.data(), 1, n, f);
+			written += n;
+		}
+		fclose(f);
+		generated = true;
+	}
+
+	int errors = 0;
+	// small views in the quick mode, so the view changes are tested
+	const size_t viewSize = quick ? 4 * 1024 * 1024 : MAPPEDFILE_VIEW_SIZE;
+
+	const ReadResult warmup = ReadStdio(path);
+	printf("%s: %.1f MiB\n", path.string().c_str(), warmup.bytes / (1024.0 * 1024));
+	printf("%-28s %10s %10s\n", "input", "ms", "MiB/s");
+
+	auto Report = [&](const char* name, const ReadResult& r) {
+		printf("%-28s %10.1f %10.0f\n", name, r.seconds * 1000, r.bytes / r.seconds / (1024 * 1024));
+		if (r.bytes != warmup.bytes || r.checksum != warmup.checksum) {
+			fprintf(stderr, "ERROR: %s: the content differs\n", name);
+			errors++;
+		}
+	};
+
+	Report("fread, 64 KiB blocks", ReadStdio(path));
+	Report("mapped views, Read()", ReadMapped(path, viewSize));
+	if (sizeof(void*) == 8) {
+		Report("mapped file, Read()", ReadMapped(path, 0));
+		Report("mapped file, direct access", ReadDirect(path));
+	}
+
+	if (!CheckSeeks(path, viewSize)) {
+		fprintf(stderr, "ERROR: a read after a seek differs\n");
+		errors++;
+	}
+
+	if (generated) {
+		std::error_code ec;
+		fs::remove(path, ec);
+	}
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+// Scaling of the split MIDI rendering over 1-16 workers.
+// BASSMIDI is not available here, each stream renders the voices of its MIDI channels
+// with a simple oscillator bank, the streams are summed with AudioMixer::MixAdd.
+// Fails if the mixed output differs from the single stream rendering.
+//
+// Usage: MidiMixBench [--quick]
+
+#include "stdafx.h"
+#include "AudioMixer.h"
+#include "WorkerPool.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#define MIDI_CHANNELS    16
+#define BLOCK_FRAMES     4096
+#define SAMPLE_RATE      44100
+#define OUT_CHANNELS     2
+
+// a sine oscillator, rotated by a complex multiplication
+struct Voice {
+	float re, im;
+	float cosStep, sinStep;
+	float gainL, gainR;
+};
+
+struct Song {
+	std::vector<Voice> voices[MIDI_CHANNELS];
+
+	Song(int voicesPerChannel)
+	{
+		for (int ch = 0; ch < MIDI_CHANNELS; ch++) {
+			for (int v = 0; v < voicesPerChannel; v++) {
+				const double freq = 55.0 * std::pow(2.0, (ch * 7 + v * 5) % 60 / 12.0);
+				const double step = 2 * 3.14159265358979 * freq / SAMPLE_RATE;
+				const float pan = (float)((ch + v) % 9) / 8;
+				const float gain = 0.5f / (MIDI_CHANNELS * voicesPerChannel);
+				voices[ch].push_back({ 1.0f, 0.0f, (float)std::cos(step), (float)std::sin(step), gain * (1 - pan), gain * pan });
+			}
+		}
+	}
+};
+
+// one BASSMIDI stream that plays the channels with (channel % streamCount == streamIndex)
+struct RenderContext {
+	Song* song;
+	size_t streamCount;
+	std::vector<float>* buffers;
+};
+
+static void RenderStream(void* context, size_t streamIndex)
+{
+	const RenderContext& ctx = *(const RenderContext*)context;
+	float* out = ctx.buffers[streamIndex].data();
+	memset(out, 0, BLOCK_FRAMES * OUT_CHANNELS * sizeof(float));
+
+	for (size_t ch = streamIndex; ch < MIDI_CHANNELS; ch += ctx.streamCount) {
+		for (auto& v : ctx.song->voices[ch]) {
+			float re = v.re, im = v.im;
+			for (int i = 0; i < BLOCK_FRAMES; i++) {
+				out[i * 2]     += re * v.gainL;
+				out[i * 2 + 1] += re * v.gainR;
+				const float r = re * v.cosStep - im * v.sinStep;
+				im = re * v.sinStep + im * v.cosStep;
+				re = r;
+			}
+			v.re = re;
+			v.im = im;
+		}
+	}
+}
+
+// renders the blocks, returns the seconds per block
+static double Render(int voicesPerChannel, size_t streamCount, int blocks, std::vector<int16_t>& output)
+{
+	Song song(voicesPerChannel);
+	std::vector<float> buffers[MIDI_CHANNELS];
+	for (size_t i = 0; i < streamCount; i++) {
+		buffers[i].resize(BLOCK_FRAMES * OUT_CHANNELS);
+	}
+	RenderContext ctx = { &song, streamCount, buffers };
+	WorkerPool pool(streamCount - 1);
+
+	output.resize((size_t)blocks * BLOCK_FRAMES * OUT_CHANNELS);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int b = 0; b < blocks; b++) {
+		pool.Run(RenderStream, &ctx, streamCount);
+		for (size_t i = 1; i < streamCount; i++) {
+			AudioMixer::MixAdd(buffers[0].data(), buffers[i].data(), BLOCK_FRAMES * OUT_CHANNELS);
+		}
+		AudioMixer::ConvertToInt16(output.data() + (size_t)b * BLOCK_FRAMES * OUT_CHANNELS, buffers[0].data(), BLOCK_FRAMES * OUT_CHANNELS);
+	}
+
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / blocks;
+}
+
+int main(int argc, char* argv[])
+{
+	bool quick = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0) {
+			quick = true;
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--quick]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	const int voicesPerChannel = quick ? 16 : 128;
+	const int blocks = quick ? 8 : 64;
+	const std::vector<size_t> workers = quick ? std::vector<size_t>{ 1, 2, 4 } : std::vector<size_t>{ 1, 2, 3, 4, 6, 8, 12, 16 };
+	int errors = 0;
+
+	// mixer self-test, odd sizes use the scalar tail
+	{
+		float a[11], b[11];
+		int16_t pcm[11];
+		for (int i = 0; i < 11; i++) {
+			a[i] = i * 0.125f - 0.5f;
+			b[i] = 0.5f;
+		}
+		AudioMixer::MixAdd(a, b, 11);
+		AudioMixer::ConvertToInt16(pcm, a, 11);
+		for (int i = 0; i < 11; i++) {
+			const int expected = std::min(32767, (int)std::lround(i * 0.125 * 32768));
+			if (pcm[i] != expected) {
+				fprintf(stderr, "ERROR: mixer self-test failed at %d: %d != %d\n", i, pcm[i], expected);
+				errors++;
+				break;
+			}
+		}
+	}
+
+	std::vector<int16_t> reference;
+	const double blockSeconds = (double)BLOCK_FRAMES / SAMPLE_RATE;
+
+	printf("%d voices, %d blocks of %d frames\n", voicesPerChannel * MIDI_CHANNELS, blocks, BLOCK_FRAMES);
+	printf("%8s %12s %10s %10s\n", "streams", "ms/block", "realtime", "speedup");
+
+	double baseTime = 0;
+	for (const size_t n : workers) {
+		std::vector<int16_t> output;
+		const double time = Render(voicesPerChannel, n, blocks, output);
+		if (n == 1) {
+			reference = output;
+			baseTime = time;
+		}
+		else {
+			// only the summation order differs, so a sample may differ by one step
+			for (size_t i = 0; i < output.size(); i++) {
+				if (std::abs(output[i] - reference[i]) > 1) {
+					fprintf(stderr, "ERROR: %zu streams, sample %zu differs: %d != %d\n", n, i, output[i], reference[i]);
+					errors++;
+					break;
+				}
+			}
+		}
+		printf("%8zu %12.3f %9.1fx %9.2fx\n", n, time * 1000, blockSeconds / time, baseTime / time);
+	}
+
+	return errors ? 1 : 0;
+}
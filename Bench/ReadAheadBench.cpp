@@ -0,0 +1,241 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+// Read-ahead of files on network shares against a simulated share with a request latency
+// and a link bandwidth: small synchronous reads, as BASS makes them, against the adaptive
+// ring of large reads. The decoder is simulated by a fixed processing time per read.
+//
+// Usage: ReadAheadBench [--quick]
+
+#include "stdafx.h"
+#include "ReadAheadFile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+#define DECODER_READ (16 * 1024) // bytes of a BASS read
+
+// Requests are answered after the latency, the transfers share the link one after another.
+struct SimShare {
+	std::vector<uint8_t> data;
+	double latency;   // seconds
+	double bandwidth; // bytes per second
+	Clock::time_point linkFree = {};
+	uint64_t requests = 0;
+};
+
+class SimReader : public AsyncReader
+{
+	struct Request {
+		Clock::time_point done;
+		uint64_t pos;
+		void* buffer;
+		size_t size;
+	};
+
+	SimShare& m_share;
+	Request m_requests[READAHEAD_MAX_DEPTH] = {};
+
+public:
+	SimReader(SimShare& share) : m_share(share) {}
+
+	uint64_t GetLength() override { return m_share.data.size(); }
+
+	bool Start(unsigned slot, uint64_t pos, void* buffer, size_t size) override
+	{
+		const auto now = Clock::now();
+		const auto arrival = now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_share.latency));
+		const auto start = std::max(arrival, m_share.linkFree);
+		m_share.linkFree = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(size / m_share.bandwidth));
+		m_share.requests++;
+
+		m_requests[slot] = { m_share.linkFree, pos, buffer, size };
+		return true;
+	}
+
+	bool IsDone(unsigned slot) override
+	{
+		return Clock::now() >= m_requests[slot].done;
+	}
+
+	size_t Wait(unsigned slot) override
+	{
+		const Request& r = m_requests[slot];
+		std::this_thread::sleep_until(r.done);
+		const size_t n = (size_t)std::min<uint64_t>(r.size, m_share.data.size() - r.pos);
+		memcpy(r.buffer, m_share.data.data() + r.pos, n);
+		return n;
+	}
+
+	void Cancel(unsigned /*slot*/) override
+	{
+		// the transfer still occupies the link
+	}
+};
+
+static void Decode(double seconds)
+{
+	const auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+	while (Clock::now() < end) {
+	}
+}
+
+struct RunResult {
+	double seconds;
+	double waitSeconds;
+	uint64_t requests;
+	bool ok;
+};
+
+// direct synchronous reads, each one is a round trip
+static RunResult RunDirect(SimShare& share, double decodeTime)
+{
+	SimReader reader(share);
+	std::vector<uint8_t> buffer(DECODER_READ);
+	const uint64_t requests = share.requests;
+	double wait = 0;
+	bool ok = true;
+
+	const auto start = Clock::now();
+	for (uint64_t pos = 0; pos < share.data.size(); pos += DECODER_READ) {
+		const size_t size = (size_t)std::min<uint64_t>(DECODER_READ, share.data.size() - pos);
+		const auto t0 = Clock::now();
+		reader.Start(0, pos, buffer.data(), size);
+		const size_t n = reader.Wait(0);
+		wait += std::chrono::duration<double>(Clock::now() - t0).count();
+		ok = ok && n == size && memcmp(buffer.data(), share.data.data() + pos, n) == 0;
+		Decode(decodeTime);
+	}
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	return { seconds, wait, share.requests - requests, ok };
+}
+
+static RunResult RunReadAhead(SimShare& share, double decodeTime, ReadAheadStats_t& stats)
+{
+	ReadAheadFile file(std::make_unique<SimReader>(share));
+	std::vector<uint8_t> buffer(DECODER_READ);
+	const uint64_t requests = share.requests;
+	bool ok = true;
+
+	const auto start = Clock::now();
+	for (uint64_t pos = 0; pos < share.data.size(); pos += DECODER_READ) {
+		const size_t n = file.Read(buffer.data(), buffer.size());
+		ok = ok && n == std::min<uint64_t>(DECODER_READ, share.data.size() - pos)
+			&& memcmp(buffer.data(), share.data.data() + pos, n) == 0;
+		Decode(decodeTime);
+	}
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	file.GetStats(stats);
+
+	return { seconds, stats.stallTimeNs / 1e9, share.requests - requests, ok };
+}
+
+// seeks inside and outside of the ring return the right data
+static bool CheckSeeks(SimShare& share)
+{
+	// the cancelled reads still occupy the link
+	const double latency = share.latency;
+	const double bandwidth = share.bandwidth;
+	share.latency = 0.0005;
+	share.bandwidth = 4096.0 * 1024 * 1024;
+
+	ReadAheadFile file(std::make_unique<SimReader>(share));
+	std::mt19937_64 rng(9);
+	std::vector<uint8_t> buffer(DECODER_READ * 4);
+	bool ok = true;
+	uint64_t pos = 0;
+	for (int i = 0; i < 300 && ok; i++) {
+		switch (rng() % 3) {
+		case 0: pos = rng() % share.data.size(); break;                                            // anywhere
+		case 1: pos = std::min<uint64_t>(pos + rng() % (1024 * 1024), share.data.size()); break; // ahead
+		case 2: pos -= std::min<uint64_t>(pos, rng() % (64 * 1024)); break;                        // back
+		}
+		const size_t size = (size_t)(rng() % buffer.size()) + 1;
+		const size_t expected = (size_t)std::min<uint64_t>(size, share.data.size() - pos);
+		const size_t n = file.Seek(pos) ? file.Read(buffer.data(), size) : 0;
+		ok = n == expected && memcmp(buffer.data(), share.data.data() + pos, n) == 0;
+		pos += n;
+	}
+
+	share.latency = latency;
+	share.bandwidth = bandwidth;
+	return ok;
+}
+
+int main(int argc, char* argv[])
+{
+	bool quick = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0) {
+			quick = true;
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--quick]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	SimShare share;
+	share.data.resize(quick ? 8 * 1024 * 1024 + 333 : 64 * 1024 * 1024 + 333);
+	std::mt19937 rng(11);
+	for (auto& b : share.data) {
+		b = (uint8_t)rng();
+	}
+	share.latency = quick ? 0.002 : 0.005;
+	share.bandwidth = 100.0 * 1024 * 1024;
+	// about 40 MiB/s of input, a high bitrate lossless file decoded faster than realtime
+	const double decodeTime = DECODER_READ / (40.0 * 1024 * 1024);
+
+	int errors = 0;
+
+	printf("%.1f MiB file, %.0f ms latency, %.0f MiB/s, %u KiB reads\n", share.data.size() / (1024.0 * 1024),
+		share.latency * 1000, share.bandwidth / (1024 * 1024), DECODER_READ / 1024);
+	printf("%-24s %10s %10s %10s\n", "input", "ms", "wait ms", "requests");
+
+	const RunResult direct = RunDirect(share, decodeTime);
+	printf("%-24s %10.1f %10.1f %10llu\n", "direct reads", direct.seconds * 1000, direct.waitSeconds * 1000, (unsigned long long)direct.requests);
+
+	ReadAheadStats_t stats;
+	const RunResult ahead = RunReadAhead(share, decodeTime, stats);
+	printf("%-24s %10.1f %10.1f %10llu\n", "read-ahead", ahead.seconds * 1000, ahead.waitSeconds * 1000, (unsigned long long)ahead.requests);
+	printf("read-ahead: %llu stalls, %.1f ms max, latency %.1f ms, %u x %zu KiB\n", (unsigned long long)stats.stalls,
+		stats.stallMaxNs / 1e6, stats.latencyNs / 1e6, stats.depth, stats.blockSize / 1024);
+
+	if (!direct.ok || !ahead.ok) {
+		fprintf(stderr, "ERROR: the content differs\n");
+		errors++;
+	}
+	if (ahead.waitSeconds * 4 > direct.waitSeconds) {
+		fprintf(stderr, "ERROR: the read-ahead waits %.1f ms, the direct reads %.1f ms\n", ahead.waitSeconds * 1000, direct.waitSeconds * 1000);
+		errors++;
+	}
+	// a slow share, the ring must grow until the reads stop waiting
+	share.latency = 0.025;
+	ReadAheadStats_t slowStats;
+	const RunResult slow = RunReadAhead(share, decodeTime, slowStats);
+	printf("%-24s %10.1f %10.1f %10llu\n", "read-ahead, 25 ms", slow.seconds * 1000, slow.waitSeconds * 1000, (unsigned long long)slow.requests);
+	printf("read-ahead: %llu stalls, %.1f ms max, latency %.1f ms, %u x %zu KiB\n", (unsigned long long)slowStats.stalls,
+		slowStats.stallMaxNs / 1e6, slowStats.latencyNs / 1e6, slowStats.depth, slowStats.blockSize / 1024);
+	if (!slow.ok) {
+		fprintf(stderr, "ERROR: the content differs\n");
+		errors++;
+	}
+	if ((uint64_t)slowStats.depth * slowStats.blockSize <= READAHEAD_INITIAL_DEPTH * READAHEAD_MIN_BLOCK) {
+		fprintf(stderr, "ERROR: the read-ahead did not adapt to the latency\n");
+		errors++;
+	}
+
+	if (!CheckSeeks(share)) {
+		fprintf(stderr, "ERROR: a read after a seek differs\n");
+		errors++;
+	}
+
+	return errors ? 1 : 0;
+}
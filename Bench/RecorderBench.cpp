@@ -0,0 +1,183 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+// Stream recorder: latency of Write() on the download thread and the content of the files.
+//
+// Usage: RecorderBench [--quick]
+
+#include "stdafx.h"
+#include "StreamRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+struct RunResult {
+	double avgNs;
+	double maxNs;
+	double seconds;
+	RecordStats_t stats;
+	std::vector<size_t> fileSizes; // expected, the bytes between the splits
+};
+
+// writes the data in chunks of the size of network reads, splits every splitBytes,
+// paced - waits a little after each buffer, like a real stream
+static RunResult Run(const fs::path& dir, const std::vector<uint8_t>& data, size_t splitBytes, bool paced)
+{
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<size_t> chunkSize(1, 16 * 1024);
+
+	RunResult result = {};
+	double totalNs = 0;
+	uint64_t writes = 0;
+	size_t nextSplit = splitBytes;
+	size_t lastSplit = 0;
+	size_t sinceSleep = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	{
+		std::wstring directory = dir.wstring();
+		directory += fs::path::preferred_separator;
+		StreamRecorder recorder(directory, L"bin", L"Title 1");
+
+		for (size_t pos = 0; pos < data.size(); ) {
+			const size_t n = std::min(chunkSize(rng), data.size() - pos);
+
+			const auto t0 = std::chrono::steady_clock::now();
+			recorder.Write(data.data() + pos, n);
+			const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+			totalNs += ns;
+			result.maxNs = std::max(result.maxNs, ns);
+			writes++;
+
+			pos += n;
+			if (splitBytes && pos >= nextSplit && pos < data.size()) {
+				recorder.Split(L"Title " + std::to_wstring(pos / splitBytes + 1));
+				result.fileSizes.push_back(pos - lastSplit);
+				lastSplit = pos;
+				nextSplit += splitBytes;
+			}
+			sinceSleep += n;
+			if (paced && sinceSleep >= RECORD_BUFFER_SIZE / 2) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				sinceSleep = 0;
+			}
+		}
+		result.fileSizes.push_back(data.size() - lastSplit);
+		recorder.GetStats(result.stats);
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	result.avgNs = totalNs / writes;
+
+	return result;
+}
+
+static bool ReadFiles(const fs::path& dir, std::vector<uint8_t>& content, std::vector<size_t>& fileSizes)
+{
+	std::vector<fs::path> files;
+	for (const auto& entry : fs::directory_iterator(dir)) {
+		files.push_back(entry.path());
+	}
+	// the names start with the time and the file number
+	std::sort(files.begin(), files.end());
+
+	content.clear();
+	fileSizes.clear();
+	for (const auto& file : files) {
+		std::ifstream in(file, std::ios::binary);
+		if (!in) {
+			return false;
+		}
+		const size_t size = content.size();
+		content.insert(content.end(), std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		fileSizes.push_back(content.size() - size);
+	}
+
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	bool quick = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0) {
+			quick = true;
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--quick]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	const size_t dataSize = quick ? 4 * 1024 * 1024 : 64 * 1024 * 1024;
+	const size_t splitBytes = quick ? 1536 * 1024 : 16 * 1024 * 1024;
+	int errors = 0;
+
+	std::vector<uint8_t> data(dataSize);
+	std::mt19937 rng(2);
+	for (auto& b : data) {
+		b = (uint8_t)rng();
+	}
+
+	const fs::path dir = fs::temp_directory_path() / "RecorderBench";
+
+	printf("%zu MiB in chunks of 1..16 KiB, buffer %d KiB\n", dataSize / (1024 * 1024), RECORD_BUFFER_SIZE / 1024);
+	printf("%8s %10s %10s %10s %8s %10s %10s\n", "mode", "avg ns", "max us", "MiB/s", "files", "dropped", "max queue");
+
+	for (const bool paced : { true, false }) {
+		std::error_code ec;
+		fs::remove_all(dir, ec);
+		fs::create_directories(dir);
+
+		const RunResult r = Run(dir, data, splitBytes, paced);
+		const RecordStats_t& s = r.stats;
+		printf("%8s %10.1f %10.1f %10.1f %8llu %10llu %10llu\n", paced ? "paced" : "burst",
+			r.avgNs, r.maxNs / 1000, dataSize / r.seconds / (1024 * 1024),
+			(unsigned long long)s.files, (unsigned long long)s.droppedBytes, (unsigned long long)s.maxQueuedBytes);
+
+		std::vector<uint8_t> content;
+		std::vector<size_t> fileSizes;
+		if (!ReadFiles(dir, content, fileSizes)) {
+			fprintf(stderr, "ERROR: can not read the recorded files\n");
+			errors++;
+		}
+		else if (s.writeErrors) {
+			fprintf(stderr, "ERROR: %llu write errors\n", (unsigned long long)s.writeErrors);
+			errors++;
+		}
+		else if (content.size() + s.droppedBytes != dataSize) {
+			// the stats are taken before the recorder writes the last buffers
+			fprintf(stderr, "ERROR: %zu bytes recorded, %llu dropped, %zu written\n", content.size(), (unsigned long long)s.droppedBytes, dataSize);
+			errors++;
+		}
+		else if (paced) {
+			// the writer keeps up with a paced stream, the files must be exact
+			// and each one must be cut at the byte where Split() was called
+			if (s.droppedBytes || content != data) {
+				fprintf(stderr, "ERROR: the recorded content differs\n");
+				errors++;
+			}
+			else if (fileSizes.size() != r.fileSizes.size()) {
+				fprintf(stderr, "ERROR: %zu files, expected %zu\n", fileSizes.size(), r.fileSizes.size());
+				errors++;
+			}
+			else if (fileSizes != r.fileSizes) {
+				fprintf(stderr, "ERROR: the files are not split at the split offsets\n");
+				errors++;
+			}
+		}
+	}
+
+	std::error_code ec;
+	fs::remove_all(dir, ec);
+
+	return errors ? 1 : 0;
+}
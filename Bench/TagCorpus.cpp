@@ -0,0 +1,435 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "TagCorpus.h"
+#include <cstring>
+#include <iterator>
+
+namespace TagCorpus
+{
+	static const char* const id3v22TextIds[] = { "TT2", "TP1", "TP2", "TAL", "TCO", "TRK", "TYE", "TCM" };
+	static const char* const id3v2TextIds[]  = { "TIT2", "TPE1", "TPE2", "TALB", "TCON", "TRCK", "TYER", "TCOM" };
+
+	static const char* const keyListNames[] = { "Title", "Artist", "Album", "Comment", "Genre", "Year", "Track", "Composer" };
+	static const char* const vorbisNames[]  = { "TITLE", "ARTIST", "ALBUM", "COMMENT", "GENRE", "DATE", "TRACKNUMBER", "composer" };
+
+	// random code points: mostly ASCII, some Latin-1 and Cyrillic characters
+	static std::u32string MakeText(size_t length, bool latin1Only, Random& rnd)
+	{
+		std::u32string text(length, U' ');
+		for (auto& ch : text) {
+			const uint32_t r = rnd.Range(0, 99);
+			if (r < 70) {
+				ch = (r % 9 == 0) ? U' ' : (char32_t)rnd.Range('a', 'z');
+			}
+			else if (r < 85 || latin1Only) {
+				ch = (char32_t)rnd.Range(0xC0, 0xFF);
+			}
+			else {
+				ch = (char32_t)rnd.Range(0x0410, 0x044F);
+			}
+		}
+		return text;
+	}
+
+	static void AppendUtf8(std::string& str, const std::u32string& text)
+	{
+		for (const char32_t ch : text) {
+			if (ch < 0x80) {
+				str.push_back((char)ch);
+			}
+			else if (ch < 0x800) {
+				str.push_back((char)(0xC0 | (ch >> 6)));
+				str.push_back((char)(0x80 | (ch & 0x3F)));
+			}
+			else {
+				str.push_back((char)(0xE0 | (ch >> 12)));
+				str.push_back((char)(0x80 | ((ch >> 6) & 0x3F)));
+				str.push_back((char)(0x80 | (ch & 0x3F)));
+			}
+		}
+	}
+
+	// ID3v2 encoded string, optionally with a terminator
+	static void AppendEncoded(std::vector<uint8_t>& out, int encoding, const std::u32string& text, bool terminate)
+	{
+		switch (encoding) {
+		case 0: // ISO-8859-1
+			for (const char32_t ch : text) {
+				out.push_back((uint8_t)ch);
+			}
+			if (terminate) {
+				out.push_back(0);
+			}
+			break;
+		case 1: // UTF-16 with BOM (little-endian)
+			out.push_back(0xFF);
+			out.push_back(0xFE);
+			for (const char32_t ch : text) {
+				out.push_back((uint8_t)ch);
+				out.push_back((uint8_t)(ch >> 8));
+			}
+			if (terminate) {
+				out.insert(out.end(), 2, 0);
+			}
+			break;
+		case 2: // UTF-16BE without BOM
+			for (const char32_t ch : text) {
+				out.push_back((uint8_t)(ch >> 8));
+				out.push_back((uint8_t)ch);
+			}
+			if (terminate) {
+				out.insert(out.end(), 2, 0);
+			}
+			break;
+		default: { // UTF-8
+			std::string str;
+			AppendUtf8(str, text);
+			out.insert(out.end(), str.begin(), str.end());
+			if (terminate) {
+				out.push_back(0);
+			}
+			break;
+		}
+		}
+	}
+
+	static void Unsynchronise(std::vector<uint8_t>& data)
+	{
+		std::vector<uint8_t> out;
+		out.reserve(data.size() + data.size() / 64);
+		for (const uint8_t b : data) {
+			out.push_back(b);
+			if (b == 0xFF) {
+				out.push_back(0x00);
+			}
+		}
+		data.swap(out);
+	}
+
+	static void AppendSyncSafe(std::vector<uint8_t>& out, uint32_t value)
+	{
+		out.push_back((uint8_t)((value >> 21) & 0x7F));
+		out.push_back((uint8_t)((value >> 14) & 0x7F));
+		out.push_back((uint8_t)((value >> 7) & 0x7F));
+		out.push_back((uint8_t)(value & 0x7F));
+	}
+
+	static void AppendBe32(std::vector<uint8_t>& out, uint32_t value)
+	{
+		out.push_back((uint8_t)(value >> 24));
+		out.push_back((uint8_t)(value >> 16));
+		out.push_back((uint8_t)(value >> 8));
+		out.push_back((uint8_t)value);
+	}
+
+	static void AppendFrame(std::vector<uint8_t>& out, int version, const char* id, const std::vector<uint8_t>& data, uint16_t flags)
+	{
+		const uint32_t size = (uint32_t)data.size();
+		if (version == 2) {
+			out.insert(out.end(), id, id + 3);
+			out.push_back((uint8_t)(size >> 16));
+			out.push_back((uint8_t)(size >> 8));
+			out.push_back((uint8_t)size);
+		}
+		else {
+			out.insert(out.end(), id, id + 4);
+			if (version == 4) {
+				AppendSyncSafe(out, size);
+			}
+			else {
+				AppendBe32(out, size);
+			}
+			out.push_back((uint8_t)(flags >> 8));
+			out.push_back((uint8_t)flags);
+		}
+		out.insert(out.end(), data.begin(), data.end());
+	}
+
+	std::vector<uint8_t> MakePicture(size_t size, Random& rnd)
+	{
+		std::vector<uint8_t> picture(size);
+		for (size_t i = 0; i < size; i++) {
+			// plenty of 0xFF bytes to make unsynchronisation matter
+			const uint64_t r = rnd.Next();
+			picture[i] = ((r >> 40) & 15) == 0 ? 0xFF : (uint8_t)(r >> 32);
+		}
+		if (size >= 4) {
+			picture[0] = 0xFF; picture[1] = 0xD8; picture[2] = 0xFF; picture[3] = 0xE0;
+		}
+		return picture;
+	}
+
+	std::string Base64Encode(const uint8_t* data, size_t size)
+	{
+		static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+		std::string str;
+		str.reserve((size + 2) / 3 * 4);
+
+		size_t i = 0;
+		for (; i + 2 < size; i += 3) {
+			const uint32_t v = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+			str.push_back(table[(v >> 18) & 63]);
+			str.push_back(table[(v >> 12) & 63]);
+			str.push_back(table[(v >> 6) & 63]);
+			str.push_back(table[v & 63]);
+		}
+		if (i < size) {
+			uint32_t v = data[i] << 16;
+			if (i + 1 < size) {
+				v |= data[i + 1] << 8;
+			}
+			str.push_back(table[(v >> 18) & 63]);
+			str.push_back(table[(v >> 12) & 63]);
+			str.push_back(i + 1 < size ? table[(v >> 6) & 63] : '=');
+			str.push_back('=');
+		}
+
+		return str;
+	}
+
+	std::vector<uint8_t> MakeID3v2Tag(const ID3v2Params& params, uint64_t seed)
+	{
+		Random rnd(seed);
+		const int version = params.version;
+		const bool latin1 = (params.encoding == 0);
+
+		std::vector<uint8_t> frames;
+		std::vector<uint8_t> data;
+
+		for (int i = 0; i < params.textFrames; i++) {
+			const size_t n = std::size(id3v2TextIds);
+			const char* id = (version == 2) ? id3v22TextIds[i % n] : id3v2TextIds[i % n];
+			data.clear();
+			data.push_back((uint8_t)params.encoding);
+			AppendEncoded(data, params.encoding, MakeText(params.textLength, latin1, rnd), false);
+			AppendFrame(frames, version, id, data, 0);
+		}
+
+		// comment with an empty content description
+		data.clear();
+		data.push_back((uint8_t)params.encoding);
+		data.insert(data.end(), { 'e', 'n', 'g' });
+		AppendEncoded(data, params.encoding, {}, true);
+		AppendEncoded(data, params.encoding, MakeText(params.textLength * 2, latin1, rnd), false);
+		AppendFrame(frames, version, version == 2 ? "COM" : "COMM", data, 0);
+
+		if (params.pictureSize) {
+			data.clear();
+			data.push_back((uint8_t)params.encoding);
+			if (version == 2) {
+				data.insert(data.end(), { 'J', 'P', 'G' });
+			}
+			else {
+				const char mime[] = "image/jpeg";
+				data.insert(data.end(), mime, mime + sizeof(mime)); // with null
+			}
+			data.push_back(3); // front cover
+			AppendEncoded(data, params.encoding, MakeText(8, latin1, rnd), true);
+			const auto picture = MakePicture(params.pictureSize, rnd);
+			data.insert(data.end(), picture.begin(), picture.end());
+
+			uint16_t flags = 0;
+			if (version == 4) {
+				const uint32_t dataLen = (uint32_t)data.size();
+				if (params.unsync) {
+					Unsynchronise(data);
+					flags |= 0x0002;
+				}
+				if (params.dataLength) {
+					std::vector<uint8_t> tmp;
+					tmp.reserve(data.size() + 4);
+					AppendSyncSafe(tmp, dataLen);
+					tmp.insert(tmp.end(), data.begin(), data.end());
+					data.swap(tmp);
+					flags |= 0x0001;
+				}
+			}
+			AppendFrame(frames, version, version == 2 ? "PIC" : "APIC", data, flags);
+		}
+
+		uint8_t tagFlags = 0;
+		if (params.unsync && version != 4) {
+			Unsynchronise(frames);
+			tagFlags |= 0x80;
+		}
+
+		frames.insert(frames.end(), 256, 0); // padding
+
+		std::vector<uint8_t> tag = { 'I', 'D', '3', (uint8_t)version, 0, tagFlags };
+		tag.reserve(10 + frames.size());
+		AppendSyncSafe(tag, (uint32_t)frames.size());
+		tag.insert(tag.end(), frames.begin(), frames.end());
+
+		return tag;
+	}
+
+	std::vector<uint8_t> MakeID3v1Tag(uint64_t seed)
+	{
+		Random rnd(seed);
+		std::vector<uint8_t> tag(128, 0);
+		memcpy(tag.data(), "TAG", 3);
+
+		auto Fill = [&](size_t pos, size_t len) {
+			const size_t n = rnd.Range((uint32_t)len / 2, (uint32_t)len);
+			const auto text = MakeText(n, true, rnd);
+			for (size_t i = 0; i < n; i++) {
+				tag[pos + i] = (uint8_t)text[i];
+			}
+		};
+
+		Fill(3, 30);  // title
+		Fill(33, 30); // artist
+		Fill(63, 30); // album
+		memcpy(&tag[93], "2026", 4);
+		Fill(97, 28); // comment
+		tag[125] = 0;
+		tag[126] = (uint8_t)rnd.Range(1, 20); // track
+		tag[127] = (uint8_t)rnd.Range(0, 125); // genre
+
+		return tag;
+	}
+
+	std::vector<char> MakeVorbisComments(size_t fields, size_t valueLength, size_t pictureSize, uint64_t seed)
+	{
+		Random rnd(seed);
+		std::string list;
+
+		for (size_t i = 0; i < fields; i++) {
+			list.append(vorbisNames[i % std::size(vorbisNames)]);
+			list.push_back('=');
+			AppendUtf8(list, MakeText(valueLength, false, rnd));
+			list.push_back('\0');
+		}
+
+		if (pictureSize) {
+			std::vector<uint8_t> block;
+			const char mime[] = "image/jpeg";
+			const char desc[] = "cover";
+			AppendBe32(block, 3);
+			AppendBe32(block, (uint32_t)strlen(mime));
+			block.insert(block.end(), mime, mime + strlen(mime));
+			AppendBe32(block, (uint32_t)strlen(desc));
+			block.insert(block.end(), desc, desc + strlen(desc));
+			AppendBe32(block, 500); // width
+			AppendBe32(block, 500); // height
+			AppendBe32(block, 24);  // depth
+			AppendBe32(block, 0);   // colors
+			AppendBe32(block, (uint32_t)pictureSize);
+			const auto picture = MakePicture(pictureSize, rnd);
+			block.insert(block.end(), picture.begin(), picture.end());
+
+			list.append("METADATA_BLOCK_PICTURE=");
+			list.append(Base64Encode(block.data(), block.size()));
+			list.push_back('\0');
+		}
+
+		list.push_back('\0');
+
+		return std::vector<char>(list.begin(), list.end());
+	}
+
+	std::vector<char> MakeKeyList(size_t fields, size_t valueLength, uint64_t seed)
+	{
+		Random rnd(seed);
+		std::string list;
+
+		for (size_t i = 0; i < fields; i++) {
+			list.append(keyListNames[i % std::size(keyListNames)]);
+			list.push_back('=');
+			AppendUtf8(list, MakeText(valueLength, false, rnd));
+			if (i % 4 == 3) {
+				list.append("   "); // trailing spaces are trimmed for comments
+			}
+			list.push_back('\0');
+		}
+		list.push_back('\0');
+
+		return std::vector<char>(list.begin(), list.end());
+	}
+
+	std::string MakeIcyMetadata(size_t titleLength, uint64_t seed)
+	{
+		Random rnd(seed);
+		std::string str("StreamTitle='");
+		auto text = MakeText(titleLength, false, rnd);
+		for (auto& ch : text) {
+			if (ch == U'\'') {
+				ch = U' ';
+			}
+		}
+		AppendUtf8(str, text);
+		str.append("';StreamUrl='http://example.com/");
+		str.append(std::to_string(rnd.Next() % 100000));
+		str.append("';");
+
+		return str;
+	}
+
+	static void AppendLe32(std::vector<uint8_t>& out, uint32_t value)
+	{
+		out.push_back((uint8_t)value);
+		out.push_back((uint8_t)(value >> 8));
+		out.push_back((uint8_t)(value >> 16));
+		out.push_back((uint8_t)(value >> 24));
+	}
+
+	static void AppendChunk(std::vector<uint8_t>& out, const char* id, const std::vector<uint8_t>& data)
+	{
+		out.insert(out.end(), id, id + 4);
+		AppendLe32(out, (uint32_t)data.size());
+		out.insert(out.end(), data.begin(), data.end());
+		if (data.size() & 1) {
+			out.push_back(0);
+		}
+	}
+
+	static void AppendList(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data)
+	{
+		std::vector<uint8_t> list(type, type + 4);
+		list.insert(list.end(), data.begin(), data.end());
+		AppendChunk(out, "LIST", list);
+	}
+
+	std::vector<uint8_t> MakeSoundFont(const std::string& name, uint32_t presets, size_t sampleSize, uint64_t seed)
+	{
+		Random rnd(seed);
+
+		std::vector<uint8_t> info;
+		AppendChunk(info, "ifil", { 2, 0, 1, 0 });
+		AppendChunk(info, "isng", { 'E', 'M', 'U', '8', '0', '0', '0', 0 });
+		std::vector<uint8_t> inam(name.begin(), name.end());
+		inam.push_back(0);
+		AppendChunk(info, "INAM", inam);
+
+		std::vector<uint8_t> sdta;
+		std::vector<uint8_t> samples(sampleSize);
+		for (auto& b : samples) {
+			b = (uint8_t)rnd.Next();
+		}
+		AppendChunk(sdta, "smpl", samples);
+
+		std::vector<uint8_t> pdta;
+		std::vector<uint8_t> phdr((presets + 1) * 38);
+		for (uint32_t i = 0; i <= presets; i++) {
+			const std::string presetName = (i < presets) ? "Preset " + std::to_string(i) : "EOP";
+			memcpy(&phdr[i * 38], presetName.c_str(), std::min<size_t>(presetName.size(), 19));
+		}
+		AppendChunk(pdta, "phdr", phdr);
+		for (const char* id : { "pbag", "pmod", "pgen", "inst", "ibag", "imod", "igen", "shdr" }) {
+			AppendChunk(pdta, id, {});
+		}
+
+		std::vector<uint8_t> body = { 's', 'f', 'b', 'k' };
+		AppendList(body, "INFO", info);
+		AppendList(body, "sdta", sdta);
+		AppendList(body, "pdta", pdta);
+
+		std::vector<uint8_t> file;
+		AppendChunk(file, "RIFF", body);
+
+		return file;
+	}
+}
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// Deterministic generator of synthetic tag data for the parser benchmarks.
+// The same seed always produces the same bytes.
+//
+
+namespace TagCorpus
+{
+	class Random
+	{
+		uint64_t m_state;
+
+	public:
+		Random(uint64_t seed) : m_state(seed ? seed : 0x9E3779B97F4A7C15ull) {}
+
+		uint64_t Next()
+		{
+			// xorshift64*
+			m_state ^= m_state >> 12;
+			m_state ^= m_state << 25;
+			m_state ^= m_state >> 27;
+			return m_state * 2685821657736338717ull;
+		}
+
+		uint32_t Range(uint32_t lo, uint32_t hi) // [lo, hi]
+		{
+			return lo + (uint32_t)(Next() % (hi - lo + 1));
+		}
+	};
+
+	struct ID3v2Params
+	{
+		int version        = 3;     // 2, 3 or 4
+		int encoding       = 0;     // 0 - ISO-8859-1, 1 - UTF-16 with BOM, 2 - UTF-16BE, 3 - UTF-8
+		int textFrames     = 6;     // TIT2/TPE1/TPE2/... frames
+		size_t textLength  = 24;    // characters in each text frame
+		size_t pictureSize = 0;     // size of APIC/PIC data, 0 - no picture
+		bool unsync        = false; // ID3v2.3 - tag unsynchronisation, ID3v2.4 - picture frame unsynchronisation
+		bool dataLength    = false; // ID3v2.4 - data length indicator in the picture frame
+	};
+
+	std::vector<uint8_t> MakePicture(size_t size, Random& rnd);
+
+	std::string Base64Encode(const uint8_t* data, size_t size);
+
+	// complete ID3v2 tag with header and padding
+	std::vector<uint8_t> MakeID3v2Tag(const ID3v2Params& params, uint64_t seed);
+
+	// 128 byte ID3v1.1 tag
+	std::vector<uint8_t> MakeID3v1Tag(uint64_t seed);
+
+	// BASS_TAG_OGG: a series of null-terminated "KEY=value" strings, ending with a double null.
+	// If pictureSize > 0, a Base64 METADATA_BLOCK_PICTURE field is added.
+	std::vector<char> MakeVorbisComments(size_t fields, size_t valueLength, size_t pictureSize, uint64_t seed);
+
+	// BASS_TAG_APE/BASS_TAG_MP4/BASS_TAG_WMA: a series of null-terminated "Key=value" strings, ending with a double null.
+	std::vector<char> MakeKeyList(size_t fields, size_t valueLength, uint64_t seed);
+
+	// BASS_TAG_META: "StreamTitle='...';StreamUrl='...';"
+	std::string MakeIcyMetadata(size_t titleLength, uint64_t seed);
+
+	// SoundFont 2 file: INFO list with ifil/INAM, sdta list with a smpl chunk of sampleSize bytes,
+	// pdta list with presets + 1 phdr records and empty other hydra chunks
+	std::vector<uint8_t> MakeSoundFont(const std::string& name, uint32_t presets, size_t sampleSize, uint64_t seed);
+}
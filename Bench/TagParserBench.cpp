@@ -0,0 +1,435 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+// Benchmarks for the metadata parsers.
+//
+// Usage: TagParserBench [--quick] [--filter <substring>] [--min-time <ms>] [--json <file>]
+//
+// Results are printed as a table and optionally written as JSON:
+// { "benchmark": "TagParserBench", "results": [ { "name", "bytes", "iterations", "ns_per_tag", "mb_per_s" }, ... ] }
+
+#include "stdafx.h"
+#include "BassHelper.h"
+#include "ID3v2Tag.h"
+#include "SF2Header.h"
+#include "Utils/BitReader.h"
+#include "TagCorpus.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+struct BenchResult
+{
+	std::string name;
+	size_t bytes = 0;
+	uint64_t iterations = 0;
+	double nsPerTag = 0;
+	double mbPerSec = 0;
+};
+
+static double g_minTimeSec = 0.25;
+static bool g_quick = false;
+static const char* g_filter = nullptr;
+static std::vector<BenchResult> g_results;
+static size_t g_sink = 0; // keeps the results of the parsers alive, printed at the end
+static int g_errors = 0;
+
+template <typename F>
+static void RunBench(const std::string& name, size_t bytes, F&& func)
+{
+	if (g_filter && name.find(g_filter) == std::string::npos) {
+		return;
+	}
+
+	using clock = std::chrono::steady_clock;
+
+	g_sink += func(); // warm up
+
+	uint64_t iterations = 0;
+	uint64_t batch = 1;
+	double elapsed = 0;
+
+	while (elapsed < g_minTimeSec) {
+		const auto start = clock::now();
+		for (uint64_t i = 0; i < batch; i++) {
+			g_sink += func();
+		}
+		elapsed += std::chrono::duration<double>(clock::now() - start).count();
+		iterations += batch;
+		if (batch < (1u << 20)) {
+			batch *= 2;
+		}
+	}
+
+	BenchResult result;
+	result.name       = name;
+	result.bytes      = bytes;
+	result.iterations = iterations;
+	result.nsPerTag   = elapsed * 1e9 / iterations;
+	result.mbPerSec   = (double)bytes * iterations / elapsed / 1e6;
+
+	printf("%-64s %10zu B %12.1f ns/tag %10.1f MB/s\n", name.c_str(), bytes, result.nsPerTag, result.mbPerSec);
+	fflush(stdout);
+
+	g_results.emplace_back(result);
+}
+
+static std::string SizeStr(size_t size)
+{
+	char buf[32];
+	if (size >= 1024 * 1024) {
+		snprintf(buf, sizeof(buf), "%zuM", size / (1024 * 1024));
+	}
+	else if (size >= 1024) {
+		snprintf(buf, sizeof(buf), "%zuK", size / 1024);
+	}
+	else {
+		snprintf(buf, sizeof(buf), "%zu", size);
+	}
+	return buf;
+}
+
+static const char* const encodingNames[] = { "iso8859", "utf16bom", "utf16be", "utf8" };
+
+static void BenchID3v2(const TagCorpus::ID3v2Params& params, uint64_t seed)
+{
+	const auto tag = TagCorpus::MakeID3v2Tag(params, seed);
+
+	std::string suffix = "/v2." + std::to_string(params.version) + "/" + encodingNames[params.encoding]
+		+ "/pic=" + SizeStr(params.pictureSize);
+	if (params.unsync) {
+		suffix += "/unsync";
+	}
+	if (params.dataLength) {
+		suffix += "/dlen";
+	}
+
+	RunBench("ParseID3v2Tag" + suffix, tag.size(), [&]() {
+		ID3v2TagInfo tagInfo = {};
+		std::list<ID3v2Frame> frames;
+		ParseID3v2Tag(tag.data(), tagInfo, frames);
+		return frames.size();
+	});
+
+	ID3v2TagInfo tagInfo = {};
+	std::list<ID3v2Frame> frames;
+	if (!ParseID3v2Tag(tag.data(), tagInfo, frames)) {
+		fprintf(stderr, "ERROR: the generated tag '%s' is not parsed\n", suffix.c_str());
+		g_errors++;
+		return;
+	}
+
+	std::vector<ID3v2Frame> textFrames;
+	const ID3v2Frame* pictFrame = nullptr;
+	size_t textBytes = 0;
+	for (const auto& frame : frames) {
+		if (frame.id == 'APIC' || frame.id == '\0PIC') {
+			pictFrame = &frame;
+		}
+		else if (frame.id != 'COMM' && frame.id != '\0COM') {
+			textFrames.emplace_back(frame);
+			textBytes += frame.size;
+		}
+	}
+
+	if (textFrames.size()) {
+		RunBench("GetID3v2FrameText" + suffix, textBytes, [&]() {
+			size_t len = 0;
+			for (const auto& frame : textFrames) {
+				len += GetID3v2FrameText(frame).size();
+			}
+			return len;
+		});
+	}
+
+	if (pictFrame) {
+		RunBench("GetID3v2FramePicture" + suffix, pictFrame->size, [&]() {
+			DSMResource resource;
+			GetID3v2FramePicture(tagInfo, *pictFrame, resource);
+			return resource.data.size();
+		});
+	}
+
+	RunBench("ReadTagsID3v2" + suffix, tag.size(), [&]() {
+		ContentTags tags;
+		auto pResources = std::make_unique<std::list<DSMResource>>();
+		ReadTagsID3v2((const char*)tag.data(), tags, pResources);
+		return tags.Title.size() + pResources->size();
+	});
+}
+
+static void BenchOgg(size_t fields, size_t pictureSize, uint64_t seed)
+{
+	const auto list = TagCorpus::MakeVorbisComments(fields, 32, pictureSize, seed);
+
+	RunBench("ReadTagsOgg/fields=" + std::to_string(fields) + "/pic=" + SizeStr(pictureSize), list.size(), [&]() {
+		ContentTags tags;
+		auto pResources = std::make_unique<std::list<DSMResource>>();
+		ReadTagsOgg(list.data(), tags, pResources);
+		return tags.Title.size() + pResources->size();
+	});
+}
+
+static void BenchCommon(size_t fields, size_t valueLength, uint64_t seed)
+{
+	const auto list = TagCorpus::MakeKeyList(fields, valueLength, seed);
+
+	RunBench("ReadTagsCommon/fields=" + std::to_string(fields) + "/len=" + std::to_string(valueLength), list.size(), [&]() {
+		ContentTags tags;
+		ReadTagsCommon(list.data(), tags);
+		return tags.Title.size();
+	});
+}
+
+static void BenchICY(size_t titleLength, uint64_t seed)
+{
+	const auto meta = TagCorpus::MakeIcyMetadata(titleLength, seed);
+
+	RunBench("ReadTagsICYStreamTitle/len=" + std::to_string(titleLength), meta.size(), [&]() {
+		std::wstring title;
+		ReadTagsICYStreamTitle(meta.c_str(), title);
+		return title.size();
+	});
+}
+
+static void BenchID3v1(uint64_t seed)
+{
+	const auto tag = TagCorpus::MakeID3v1Tag(seed);
+
+	RunBench("ReadTagsID3v1", tag.size(), [&]() {
+		ContentTags tags;
+		ReadTagsID3v1((const char*)tag.data(), tags);
+		return tags.Title.size();
+	});
+}
+
+static void BenchSF2(uint32_t presets, size_t sampleSize, uint64_t seed)
+{
+	const auto file = TagCorpus::MakeSoundFont("Bench SoundFont", presets, sampleSize, seed);
+
+	auto Read = [](void* context, uint64_t offset, void* buffer, size_t size) {
+		const auto& data = *static_cast<const std::vector<uint8_t>*>(context);
+		if (offset + size > data.size()) {
+			return false;
+		}
+		memcpy(buffer, data.data() + offset, size);
+		return true;
+	};
+
+	const std::string name = "ParseSF2Header/presets=" + std::to_string(presets) + "/smpl=" + SizeStr(sampleSize);
+
+	SF2Info info;
+	if (!ParseSF2Header(Read, (void*)&file, file.size(), info)
+			|| info.name != L"Bench SoundFont" || info.presets != presets || info.sampleDataSize != sampleSize
+			|| info.versionMajor != 2 || info.versionMinor != 1) {
+		fprintf(stderr, "ERROR: the generated SoundFont '%s' is not parsed\n", name.c_str());
+		g_errors++;
+		return;
+	}
+
+	// the sample data is not read, so the size does not depend on it
+	RunBench(name, file.size() - sampleSize, [&]() {
+		SF2Info info;
+		ParseSF2Header(Read, (void*)&file, file.size(), info);
+		return (size_t)info.presets;
+	});
+}
+
+static void BenchReaders(uint64_t seed)
+{
+	TagCorpus::Random rnd(seed);
+	std::vector<uint8_t> data(64 * 1024);
+	for (auto& b : data) {
+		b = (uint8_t)rnd.Next();
+	}
+	std::vector<uint32_t> values(data.size() / 4);
+
+	RunBench("ByteReader/Read32Be/64K", data.size(), [&]() {
+		ByteReader br(data.data());
+		br.SetSize(data.size());
+		for (auto& value : values) {
+			value = br.Read32Be();
+		}
+		return (size_t)values.back();
+	});
+
+	RunBench("ByteReader/GetSpan+Read32Be/64K", data.size(), [&]() {
+		ByteReader br(data.data());
+		br.SetSize(data.size());
+		ByteSpan span = br.GetSpan(values.size() * 4);
+		for (auto& value : values) {
+			value = span.Read32Be();
+		}
+		return (size_t)values.back();
+	});
+
+	RunBench("ByteReader/ReadArray32Be/64K", data.size(), [&]() {
+		ByteReader br(data.data());
+		br.SetSize(data.size());
+		br.ReadArray32Be(values.data(), values.size());
+		return (size_t)values.back();
+	});
+
+	// MPEG audio frame headers
+	RunBench("BitReader/MPEGHeader/64K", data.size(), [&]() {
+		size_t sum = 0;
+		for (size_t i = 0; i + 4 <= data.size(); i += 4) {
+			BitReader bits(&data[i], data.size() - i);
+			sum += bits.ReadBits(11); // sync
+			sum += bits.ReadBits(2);  // version
+			sum += bits.ReadBits(2);  // layer
+			sum += bits.ReadBit();    // protection
+			sum += bits.ReadBits(4);  // bitrate index
+			sum += bits.ReadBits(2);  // sample rate index
+			sum += bits.ReadBit();    // padding
+			sum += bits.ReadBit();    // private
+			sum += bits.ReadBits(2);  // channel mode
+			sum += bits.ReadBits(2);  // mode extension
+			sum += bits.ReadBits(4);  // copyright, original, emphasis
+		}
+		return sum;
+	});
+
+	// FLAC STREAMINFO blocks
+	RunBench("BitReader/FLACStreamInfo/64K", data.size(), [&]() {
+		size_t sum = 0;
+		for (size_t i = 0; i + 34 <= data.size(); i += 34) {
+			BitReader bits(&data[i], data.size() - i);
+			sum += bits.ReadBits(16); // min block size
+			sum += bits.ReadBits(16); // max block size
+			sum += bits.ReadBits(24); // min frame size
+			sum += bits.ReadBits(24); // max frame size
+			sum += bits.ReadBits(20); // sample rate
+			sum += bits.ReadBits(3);  // channels - 1
+			sum += bits.ReadBits(5);  // bits per sample - 1
+			sum += (size_t)bits.ReadBits64(36); // total samples
+			bits.SkipBits(128);       // MD5
+		}
+		return sum;
+	});
+}
+
+static bool WriteJson(const char* filename)
+{
+	FILE* f = fopen(filename, "wb");
+	if (!f) {
+		return false;
+	}
+
+	fprintf(f, "{\n  \"benchmark\": \"TagParserBench\",\n  \"results\": [\n");
+	for (size_t i = 0; i < g_results.size(); i++) {
+		const auto& r = g_results[i];
+		fprintf(f, "    { \"name\": \"%s\", \"bytes\": %zu, \"iterations\": %llu, \"ns_per_tag\": %.1f, \"mb_per_s\": %.3f }%s\n",
+			r.name.c_str(), r.bytes, (unsigned long long)r.iterations, r.nsPerTag, r.mbPerSec,
+			(i + 1 < g_results.size()) ? "," : "");
+	}
+	fprintf(f, "  ]\n}\n");
+
+	return fclose(f) == 0;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* jsonFile = nullptr;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0) {
+			g_quick = true;
+			g_minTimeSec = 0.005;
+		}
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			g_filter = argv[++i];
+		}
+		else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+			g_minTimeSec = atof(argv[++i]) / 1000.0;
+		}
+		else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+			jsonFile = argv[++i];
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--quick] [--filter <substring>] [--min-time <ms>] [--json <file>]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	const size_t pictureSizes[] = { 0, 16 * 1024, 1024 * 1024, 16 * 1024 * 1024 };
+	const size_t maxPictureSize = g_quick ? 16 * 1024 : SIZE_MAX;
+
+	uint64_t seed = 1;
+
+	// all versions and encodings
+	for (int version = 2; version <= 4; version++) {
+		for (int encoding = 0; encoding <= 3; encoding++) {
+			for (const size_t pictureSize : pictureSizes) {
+				if (pictureSize > maxPictureSize || pictureSize > 1024 * 1024) {
+					continue;
+				}
+				TagCorpus::ID3v2Params params;
+				params.version = version;
+				params.encoding = encoding;
+				params.pictureSize = pictureSize;
+				BenchID3v2(params, seed++);
+			}
+		}
+	}
+
+	// unsynchronisation and data length indicator
+	for (int version = 3; version <= 4; version++) {
+		for (int flags = 1; flags <= 3; flags++) {
+			const bool dataLength = (flags & 2) != 0;
+			if (dataLength && version != 4) {
+				continue;
+			}
+			for (const size_t pictureSize : pictureSizes) {
+				if (pictureSize == 0 || pictureSize > maxPictureSize) {
+					continue;
+				}
+				TagCorpus::ID3v2Params params;
+				params.version = version;
+				params.pictureSize = pictureSize;
+				params.unsync = (flags & 1) != 0;
+				params.dataLength = dataLength;
+				BenchID3v2(params, seed++);
+			}
+		}
+	}
+
+	for (const size_t fields : { 8, 64 }) {
+		for (const size_t pictureSize : pictureSizes) {
+			if (pictureSize <= maxPictureSize) {
+				BenchOgg(fields, pictureSize, seed++);
+			}
+		}
+	}
+
+	for (const size_t fields : { 4, 64, 1024 }) {
+		BenchCommon(fields, 32, seed++);
+	}
+	if (!g_quick) {
+		BenchCommon(16, 64 * 1024, seed++);
+	}
+
+	for (const size_t length : { 16, 128, 4000 }) {
+		BenchICY(length, seed++);
+	}
+
+	BenchID3v1(seed++);
+
+	BenchSF2(128, 64 * 1024, seed++);
+	if (!g_quick) {
+		BenchSF2(1024, 16 * 1024 * 1024, seed++);
+	}
+
+	BenchReaders(seed++);
+
+	if (jsonFile && !WriteJson(jsonFile)) {
+		fprintf(stderr, "ERROR: failed to write '%s'\n", jsonFile);
+		return 1;
+	}
+
+	printf("checksum: %zu\n", g_sink);
+
+	return g_errors ? 1 : 0;
+}
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+// Overhead of the trace ring.
+//
+// Usage: TraceBench [--quick]
+
+#include "stdafx.h"
+#include "Trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+static size_t g_sink = 0;
+
+template <typename F>
+static double MeasureNs(uint64_t iterations, F&& func)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (uint64_t i = 0; i < iterations; i++) {
+		func(i);
+	}
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+// roughly the work of decoding and copying one small audio buffer
+static size_t SimulatedWork(uint64_t i)
+{
+	static uint8_t buffer[2048];
+	size_t sum = 0;
+	for (size_t k = 0; k < sizeof(buffer); k++) {
+		buffer[k] = (uint8_t)(buffer[k] * 31 + i + k);
+		sum += buffer[k];
+	}
+	return sum;
+}
+
+int main(int argc, char* argv[])
+{
+	bool quick = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0) {
+			quick = true;
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--quick]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	const uint64_t iterations = quick ? 200000 : 10000000;
+	int errors = 0;
+
+	Trace::Enable(false);
+	const double disabledNs = MeasureNs(iterations, [](uint64_t i) {
+		Trace::Begin(Trace::EV_GetData);
+		Trace::End(Trace::EV_GetData, (uint32_t)i);
+	}) / 2;
+
+	Trace::Enable(true);
+	const double enabledNs = MeasureNs(iterations, [](uint64_t i) {
+		Trace::Begin(Trace::EV_GetData);
+		Trace::End(Trace::EV_GetData, (uint32_t)i);
+	}) / 2;
+
+	const uint64_t workIterations = iterations / 10;
+
+	Trace::Enable(false);
+	const double workNs = MeasureNs(workIterations, [](uint64_t i) {
+		g_sink += SimulatedWork(i);
+	});
+
+	Trace::Enable(true);
+	const double tracedWorkNs = MeasureNs(workIterations, [](uint64_t i) {
+		Trace::Scope scope(Trace::EV_FillBuffer);
+		Trace::Begin(Trace::EV_GetData);
+		g_sink += SimulatedWork(i);
+		Trace::End(Trace::EV_GetData, 2048);
+	});
+
+	printf("%-40s %10.2f ns/event\n", "disabled", disabledNs);
+	printf("%-40s %10.2f ns/event\n", "enabled", enabledNs);
+	printf("%-40s %10.1f ns\n", "2 KiB buffer, not traced", workNs);
+	printf("%-40s %10.1f ns (%+.2f%%)\n", "2 KiB buffer, 4 events", tracedWorkNs, (tracedWorkNs - workNs) * 100.0 / workNs);
+
+	// concurrent writers and export
+	Trace::Clear();
+	std::atomic<bool> stop = false;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([&stop]() {
+			uint32_t n = 0;
+			while (!stop.load(std::memory_order_relaxed)) {
+				Trace::Scope scope(Trace::EV_FillBuffer, n++);
+				Trace::Instant(Trace::EV_NetData, n);
+			}
+		});
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	size_t exported = 0;
+	const auto exportStart = std::chrono::steady_clock::now();
+	for (int k = 0; k < 10; k++) {
+		const std::string json = Trace::ExportChromeJson();
+		exported = json.size();
+		if (!json.starts_with("{\"displayTimeUnit") || json.find("\"FillBuffer\"") == std::string::npos) {
+			errors++;
+		}
+	}
+	const double exportMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - exportStart).count() / 10;
+
+	stop = true;
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	printf("%-40s %10.1f ms (%zu bytes)\n", "export, 4 writing threads", exportMs, exported);
+
+	Trace::Enable(false);
+
+	if (errors) {
+		fprintf(stderr, "ERROR: invalid trace export\n");
+	}
+	printf("checksum: %zu\n", g_sink);
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+// Unit check of the adaptive MIDI voice control with synthetic render loads:
+// the block at which the quality and the voice limit are lowered and raised,
+// the doubling of the raise wait after each lowering and its cap,
+// and the band between the thresholds where nothing changes.
+//
+// Usage: VoiceControllerCheck
+
+#include "stdafx.h"
+#include "VoiceController.h"
+
+#include <cstdio>
+
+#define AUDIO_NS 10000000ull // 10 ms blocks
+
+static int g_errors = 0;
+
+#define CHECK(expr) \
+	if (!(expr)) { \
+		fprintf(stderr, "ERROR: %s:%d: %s\n", __FILE__, __LINE__, #expr); \
+		g_errors++; \
+	}
+
+// feeds blocks with a constant load until the controller changes the state,
+// returns the number of blocks or 0 if nothing changed within maxBlocks
+static unsigned Run(VoiceController& vc, double load, int activeVoices, unsigned maxBlocks = 10000)
+{
+	for (unsigned i = 1; i <= maxBlocks; i++) {
+		if (vc.Update((uint64_t)(load * AUDIO_NS), AUDIO_NS, activeVoices)) {
+			return i;
+		}
+	}
+	return 0;
+}
+
+static void CheckSteps()
+{
+	VoiceController vc(128, 2);
+
+	// the average starts at zero, a full load crosses VOICECTRL_LOAD_HIGH on the 10th block
+	CHECK(Run(vc, 1.0, 128) == 10);
+	CHECK(vc.GetState().quality == 1 && vc.GetState().voices == 128);
+	CHECK(vc.GetLoad() > VOICECTRL_LOAD_HIGH);
+
+	// the quality is lowered first, then the voices, VOICECTRL_HOLD_DOWN blocks apart
+	CHECK(Run(vc, 1.0, 128) == VOICECTRL_HOLD_DOWN);
+	CHECK(vc.GetState().quality == 0 && vc.GetState().voices == 128);
+	CHECK(Run(vc, 1.0, 128) == VOICECTRL_HOLD_DOWN);
+	CHECK(vc.GetState().quality == 0 && vc.GetState().voices == 96);
+	CHECK(vc.GetDecreases() == 3);
+
+	// three lowerings, the raise waits VOICECTRL_HOLD_UP * 8 blocks;
+	// the voices are raised when they are used up
+	CHECK(Run(vc, 0.0, 96) == VOICECTRL_HOLD_UP * 8);
+	CHECK(vc.GetState().quality == 0 && vc.GetState().voices == 120);
+
+	// a raise does not change the wait, the quality is raised when the voices are not used up
+	CHECK(Run(vc, 0.0, 120 - 120 / 8 - 1) == VOICECTRL_HOLD_UP * 8);
+	CHECK(vc.GetState().quality == 1 && vc.GetState().voices == 120);
+	CHECK(vc.GetIncreases() == 2);
+
+	// the next lowering doubles the wait
+	CHECK(Run(vc, 1.0, 120) != 0);
+	CHECK(vc.GetState().quality == 0);
+	CHECK(Run(vc, 0.0, 0) == VOICECTRL_HOLD_UP * 16);
+	CHECK(vc.GetState().quality == 1);
+}
+
+static void CheckLimits()
+{
+	// the voices are lowered to VOICECTRL_MIN_VOICES, then nothing changes
+	{
+		VoiceController vc(40, 0);
+		CHECK(Run(vc, 1.0, 40) == 10);
+		CHECK(vc.GetState().voices == 30);
+		CHECK(Run(vc, 1.0, 40) == VOICECTRL_HOLD_DOWN);
+		CHECK(vc.GetState().voices == 22);
+		CHECK(Run(vc, 1.0, 40) == VOICECTRL_HOLD_DOWN);
+		CHECK(vc.GetState().voices == VOICECTRL_MIN_VOICES);
+		CHECK(Run(vc, 1.0, 40) == 0);
+		CHECK(vc.GetDecreases() == 3);
+	}
+
+	// the wait is capped at VOICECTRL_HOLD_UP_MAX
+	{
+		VoiceController vc(VOICECTRL_MAX_VOICES, VOICECTRL_MAX_QUALITY);
+		for (int i = 0; i < 8; i++) {
+			CHECK(Run(vc, 1.0, 0) != 0);
+		}
+		CHECK(Run(vc, 0.0, VOICECTRL_MAX_VOICES) == VOICECTRL_HOLD_UP_MAX);
+	}
+
+	// the voices and the quality at the maximum are not raised
+	{
+		VoiceController vc(VOICECTRL_MAX_VOICES + 100, VOICECTRL_MAX_QUALITY + 1);
+		CHECK(vc.GetState().voices == VOICECTRL_MAX_VOICES && vc.GetState().quality == VOICECTRL_MAX_QUALITY);
+		CHECK(Run(vc, 0.0, VOICECTRL_MAX_VOICES) == 0);
+	}
+}
+
+static void CheckBand()
+{
+	// a load between the thresholds changes nothing
+	VoiceController vc(128, 1);
+	CHECK(Run(vc, (VOICECTRL_LOAD_LOW + VOICECTRL_LOAD_HIGH) / 2, 128) == 0);
+	CHECK(Run(vc, VOICECTRL_LOAD_HIGH - 0.01, 128) == 0);
+	CHECK(vc.GetState().voices == 128 && vc.GetState().quality == 1);
+
+	// no audio, no update
+	CHECK(!vc.Update(AUDIO_NS, 0, 128));
+}
+
+int main()
+{
+	CheckSteps();
+	CheckLimits();
+	CheckBand();
+
+	if (g_errors) {
+		fprintf(stderr, "%d checks failed\n", g_errors);
+		return 1;
+	}
+	printf("VoiceController checks passed\n");
+
+	return 0;
+}
@@ -0,0 +1,694 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+// Members of ZIP archives: a stored member read from the mapping and through ZipRangeFile,
+// a deflated member decompressed by InflateFile, and random seeks in the deflated member
+// with the checkpoint index and without it (every backward seek decompresses from the start).
+// The archives are written by the benchmark, the deflate streams by a small greedy encoder
+// that alternates dynamic, fixed and stored blocks. One archive uses the ZIP64 records.
+//
+// Usage: ZipBench [--quick]
+
+#include "stdafx.h"
+#include "MappedFile.h"
+#include "ZipArchive.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <queue>
+#include <random>
+
+namespace fs = std::filesystem;
+
+#define READ_BLOCK  (16 * 1024) // bytes of a BASS read
+#define DEFLATE_BLOCK (64 * 1024) // input of a deflate block
+
+//
+// deflate encoder
+//
+
+class BitWriter
+{
+	std::vector<uint8_t>& m_out;
+	uint64_t m_buf = 0;
+	unsigned m_count = 0;
+
+public:
+	BitWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+	void Put(uint32_t value, unsigned n)
+	{
+		m_buf |= (uint64_t)value << m_count;
+		m_count += n;
+		while (m_count >= 8) {
+			m_out.push_back((uint8_t)m_buf);
+			m_buf >>= 8;
+			m_count -= 8;
+		}
+	}
+
+	// Huffman codes are written from the most significant bit
+	void PutCode(uint32_t code, unsigned len)
+	{
+		uint32_t reversed = 0;
+		for (unsigned i = 0; i < len; i++) {
+			reversed |= ((code >> i) & 1) << (len - 1 - i);
+		}
+		Put(reversed, len);
+	}
+
+	void Align()
+	{
+		if (m_count) {
+			Put(0, 8 - m_count);
+		}
+	}
+};
+
+static const uint16_t s_lengthBase[29] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint16_t s_distanceBase[30] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t s_codeLengthOrder[19] = {
+	16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+static unsigned ExtraBits(unsigned symbol, bool distance)
+{
+	if (distance) {
+		return symbol < 4 ? 0 : symbol / 2 - 1;
+	}
+	return (symbol < 8 || symbol == 28) ? 0 : symbol / 4 - 1;
+}
+
+// a literal (distance 0) or a match
+struct Token {
+	uint16_t length;
+	uint16_t distance;
+};
+
+struct Code {
+	std::vector<uint8_t> lengths;
+	std::vector<uint16_t> codes;
+};
+
+// Huffman code lengths, the frequencies are flattened until the longest code fits the limit
+static std::vector<uint8_t> BuildLengths(std::vector<uint32_t> freq, unsigned limit)
+{
+	const size_t n = freq.size();
+	std::vector<uint8_t> lengths(n);
+	for (;;) {
+		using Node = std::pair<uint64_t, size_t>;
+		std::priority_queue<Node, std::vector<Node>, std::greater<Node>> heap;
+		std::vector<size_t> parent(n * 2, SIZE_MAX);
+		for (size_t i = 0; i < n; i++) {
+			if (freq[i]) {
+				heap.push({ freq[i], i });
+			}
+		}
+		size_t next = n;
+		while (heap.size() > 1) {
+			const Node a = heap.top(); heap.pop();
+			const Node b = heap.top(); heap.pop();
+			parent[a.second] = parent[b.second] = next;
+			heap.push({ a.first + b.first, next++ });
+		}
+
+		unsigned maxLen = 0;
+		for (size_t i = 0; i < n; i++) {
+			unsigned len = 0;
+			for (size_t p = i; freq[i] && parent[p] != SIZE_MAX; p = parent[p]) {
+				len++;
+			}
+			lengths[i] = (uint8_t)len;
+			maxLen = std::max(maxLen, len);
+		}
+		if (maxLen <= limit) {
+			return lengths;
+		}
+		for (auto& f : freq) {
+			f = f ? f / 2 + 1 : 0;
+		}
+	}
+}
+
+static Code CanonicalCode(std::vector<uint8_t> lengths)
+{
+	Code code;
+	uint16_t count[16] = {};
+	for (const auto len : lengths) {
+		count[len]++;
+	}
+	count[0] = 0;
+	uint16_t next[16] = {};
+	for (unsigned len = 1; len < 16; len++) {
+		next[len] = (next[len - 1] + count[len - 1]) << 1;
+	}
+	code.codes.resize(lengths.size());
+	for (size_t i = 0; i < lengths.size(); i++) {
+		if (lengths[i]) {
+			code.codes[i] = next[lengths[i]]++;
+		}
+	}
+	code.lengths = std::move(lengths);
+	return code;
+}
+
+static unsigned LengthSymbol(unsigned length)
+{
+	return (unsigned)(std::upper_bound(std::begin(s_lengthBase), std::end(s_lengthBase), length) - std::begin(s_lengthBase)) - 1;
+}
+
+static unsigned DistanceSymbol(unsigned distance)
+{
+	return (unsigned)(std::upper_bound(std::begin(s_distanceBase), std::end(s_distanceBase), distance) - std::begin(s_distanceBase)) - 1;
+}
+
+static void WriteTokens(BitWriter& bw, const std::vector<Token>& tokens, const Code& lit, const Code& dist)
+{
+	for (const auto& t : tokens) {
+		if (!t.distance) {
+			bw.PutCode(lit.codes[t.length], lit.lengths[t.length]);
+			continue;
+		}
+		const unsigned ls = LengthSymbol(t.length);
+		bw.PutCode(lit.codes[257 + ls], lit.lengths[257 + ls]);
+		bw.Put(t.length - s_lengthBase[ls], ExtraBits(ls, false));
+		const unsigned ds = DistanceSymbol(t.distance);
+		bw.PutCode(dist.codes[ds], dist.lengths[ds]);
+		bw.Put(t.distance - s_distanceBase[ds], ExtraBits(ds, true));
+	}
+	bw.PutCode(lit.codes[256], lit.lengths[256]);
+}
+
+static void WriteDynamicBlock(BitWriter& bw, const std::vector<Token>& tokens, bool final)
+{
+	std::vector<uint32_t> litFreq(286), distFreq(30);
+	for (const auto& t : tokens) {
+		if (t.distance) {
+			litFreq[257 + LengthSymbol(t.length)]++;
+			distFreq[DistanceSymbol(t.distance)]++;
+		}
+		else {
+			litFreq[t.length]++;
+		}
+	}
+	litFreq[256] = 1;
+	// at least two codes of each tree
+	litFreq[0] += !litFreq[0];
+	distFreq[0] += !distFreq[0];
+	distFreq[1] += !distFreq[1];
+
+	const Code lit = CanonicalCode(BuildLengths(litFreq, 15));
+	const Code dist = CanonicalCode(BuildLengths(distFreq, 15));
+
+	// the code lengths of both trees, run-length coded
+	std::vector<uint8_t> all(lit.lengths);
+	all.insert(all.end(), dist.lengths.begin(), dist.lengths.end());
+	std::vector<std::pair<uint8_t, uint8_t>> runs; // symbol, extra bits value
+	for (size_t i = 0; i < all.size(); ) {
+		size_t run = 1;
+		while (i + run < all.size() && all[i + run] == all[i]) {
+			run++;
+		}
+		if (all[i] == 0 && run >= 11) {
+			run = std::min<size_t>(run, 138);
+			runs.push_back({ 18, (uint8_t)(run - 11) });
+		}
+		else if (all[i] == 0 && run >= 3) {
+			runs.push_back({ 17, (uint8_t)(run - 3) });
+		}
+		else if (i > 0 && all[i] == all[i - 1] && run >= 3) {
+			run = std::min<size_t>(run, 6);
+			runs.push_back({ 16, (uint8_t)(run - 3) });
+		}
+		else {
+			run = 1;
+			runs.push_back({ all[i], 0 });
+		}
+		i += run;
+	}
+
+	std::vector<uint32_t> clFreq(19);
+	for (const auto& r : runs) {
+		clFreq[r.first]++;
+	}
+	clFreq[0] += !clFreq[0];
+	clFreq[18] += !clFreq[18];
+	const Code cl = CanonicalCode(BuildLengths(clFreq, 7));
+	unsigned ncode = 19;
+	while (ncode > 4 && !cl.lengths[s_codeLengthOrder[ncode - 1]]) {
+		ncode--;
+	}
+
+	bw.Put(final, 1);
+	bw.Put(2, 2);
+	bw.Put(286 - 257, 5);
+	bw.Put(30 - 1, 5);
+	bw.Put(ncode - 4, 4);
+	for (unsigned i = 0; i < ncode; i++) {
+		bw.Put(cl.lengths[s_codeLengthOrder[i]], 3);
+	}
+	for (const auto& r : runs) {
+		bw.PutCode(cl.codes[r.first], cl.lengths[r.first]);
+		if (r.first >= 16) {
+			bw.Put(r.second, r.first == 16 ? 2 : r.first == 17 ? 3 : 7);
+		}
+	}
+	WriteTokens(bw, tokens, lit, dist);
+}
+
+static void WriteFixedBlock(BitWriter& bw, const std::vector<Token>& tokens, bool final)
+{
+	static const Code lit = [] {
+		std::vector<uint8_t> lengths(288, 8);
+		std::fill(lengths.begin() + 144, lengths.begin() + 256, 9);
+		std::fill(lengths.begin() + 256, lengths.begin() + 280, 7);
+		return CanonicalCode(lengths);
+	}();
+	static const Code dist = CanonicalCode(std::vector<uint8_t>(30, 5));
+
+	bw.Put(final, 1);
+	bw.Put(1, 2);
+	WriteTokens(bw, tokens, lit, dist);
+}
+
+static void WriteStoredBlock(BitWriter& bw, std::vector<uint8_t>& out, const uint8_t* data, size_t size, bool final)
+{
+	bw.Put(final, 1);
+	bw.Put(0, 2);
+	bw.Align();
+	bw.Put((uint32_t)size, 16);
+	bw.Put((uint32_t)~size & 0xFFFF, 16);
+	out.insert(out.end(), data, data + size);
+}
+
+// greedy matching with one hash entry per position, every third block is stored
+static std::vector<uint8_t> Deflate(const std::vector<uint8_t>& data)
+{
+	std::vector<uint8_t> out;
+	BitWriter bw(out);
+	std::vector<uint32_t> head(1 << 16, UINT32_MAX);
+	std::vector<Token> tokens;
+	size_t start = 0;
+
+	for (unsigned block = 0; ; block++) {
+		if (block % 3 == 2) {
+			const size_t end = std::min<size_t>(start + 65535, data.size());
+			WriteStoredBlock(bw, out, data.data() + start, end - start, end == data.size());
+			if (end == data.size()) {
+				break;
+			}
+			start = end;
+			continue;
+		}
+
+		const size_t end = std::min<size_t>(start + DEFLATE_BLOCK, data.size());
+		tokens.clear();
+		size_t i = start;
+		while (i < end) {
+			unsigned length = 0;
+			size_t match = 0;
+			if (i + 3 <= data.size()) {
+				const uint32_t hash = ((data[i] << 16 | data[i + 1] << 8 | data[i + 2]) * 2654435761u) >> 16;
+				match = head[hash];
+				head[hash] = (uint32_t)i;
+				if (match != UINT32_MAX && i - match <= 32768) {
+					const size_t limit = std::min<size_t>(258, data.size() - i);
+					while (length < limit && data[match + length] == data[i + length]) {
+						length++;
+					}
+				}
+			}
+			if (length >= 3) {
+				tokens.push_back({ (uint16_t)length, (uint16_t)(i - match) });
+				i += length;
+			}
+			else {
+				tokens.push_back({ data[i], 0 });
+				i++;
+			}
+		}
+
+		// a match can run past the block end, the next block starts after it
+		const bool final = i == data.size();
+		if (block % 3 == 0) {
+			WriteDynamicBlock(bw, tokens, final);
+		}
+		else {
+			WriteFixedBlock(bw, tokens, final);
+		}
+		if (final) {
+			break;
+		}
+		start = i;
+	}
+	bw.Align();
+
+	return out;
+}
+
+//
+// ZIP writer
+//
+
+static uint32_t Crc32(const std::vector<uint8_t>& data)
+{
+	static const auto table = [] {
+		std::vector<uint32_t> t(256);
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t c = i;
+			for (int k = 0; k < 8; k++) {
+				c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+			}
+			t[i] = c;
+		}
+		return t;
+	}();
+	uint32_t crc = UINT32_MAX;
+	for (const auto b : data) {
+		crc = table[(crc ^ b) & 0xFF] ^ (crc >> 8);
+	}
+	return ~crc;
+}
+
+struct Member {
+	std::string name;
+	uint16_t method;
+	const std::vector<uint8_t>* data;
+	const std::vector<uint8_t>* compressed;
+};
+
+static void Put16(std::vector<uint8_t>& v, uint32_t x) { v.push_back((uint8_t)x); v.push_back((uint8_t)(x >> 8)); }
+static void Put32(std::vector<uint8_t>& v, uint32_t x) { Put16(v, x & 0xFFFF); Put16(v, x >> 16); }
+static void Put64(std::vector<uint8_t>& v, uint64_t x) { Put32(v, (uint32_t)x); Put32(v, (uint32_t)(x >> 32)); }
+
+// with zip64 the sizes and offsets are in the ZIP64 extra fields and the ZIP64 end records
+static bool WriteZip(const fs::path& path, const std::vector<Member>& members, bool zip64)
+{
+	FILE* f = fopen(path.string().c_str(), "wb");
+	if (!f) {
+		return false;
+	}
+
+	std::vector<uint8_t> directory;
+	uint64_t pos = 0;
+	for (const auto& m : members) {
+		const uint32_t crc = Crc32(*m.data);
+		const uint64_t csize = m.compressed->size();
+		const uint64_t size = m.data->size();
+
+		std::vector<uint8_t> extra;
+		if (zip64) {
+			Put16(extra, 0x0001);
+			Put16(extra, 24);
+			Put64(extra, size);
+			Put64(extra, csize);
+			Put64(extra, pos);
+		}
+
+		std::vector<uint8_t> local;
+		Put32(local, 0x04034b50);
+		Put16(local, zip64 ? 45 : 20);
+		Put16(local, 0);
+		Put16(local, m.method);
+		Put32(local, 0); // time, date
+		Put32(local, crc);
+		Put32(local, zip64 ? UINT32_MAX : (uint32_t)csize);
+		Put32(local, zip64 ? UINT32_MAX : (uint32_t)size);
+		Put16(local, (uint32_t)m.name.size());
+		Put16(local, zip64 ? 20 : 0);
+		local.insert(local.end(), m.name.begin(), m.name.end());
+		if (zip64) {
+			Put16(local, 0x0001);
+			Put16(local, 16);
+			Put64(local, size);
+			Put64(local, csize);
+		}
+
+		Put32(directory, 0x02014b50);
+		Put16(directory, zip64 ? 45 : 20);
+		Put16(directory, zip64 ? 45 : 20);
+		Put16(directory, 0);
+		Put16(directory, m.method);
+		Put32(directory, 0);
+		Put32(directory, crc);
+		Put32(directory, zip64 ? UINT32_MAX : (uint32_t)csize);
+		Put32(directory, zip64 ? UINT32_MAX : (uint32_t)size);
+		Put16(directory, (uint32_t)m.name.size());
+		Put16(directory, (uint32_t)extra.size());
+		Put16(directory, 0); // comment
+		Put16(directory, 0); // disk
+		Put16(directory, 0);
+		Put32(directory, 0);
+		Put32(directory, zip64 ? UINT32_MAX : (uint32_t)pos);
+		directory.insert(directory.end(), m.name.begin(), m.name.end());
+		directory.insert(directory.end(), extra.begin(), extra.end());
+
+		fwrite(local.data(), 1, local.size(), f);
+		fwrite(m.compressed->data(), 1, m.compressed->size(), f);
+		pos += local.size() + m.compressed->size();
+	}
+
+	std::vector<uint8_t> end;
+	if (zip64) {
+		Put32(end, 0x06064b50);
+		Put64(end, 44);
+		Put16(end, 45);
+		Put16(end, 45);
+		Put32(end, 0);
+		Put32(end, 0);
+		Put64(end, members.size());
+		Put64(end, members.size());
+		Put64(end, directory.size());
+		Put64(end, pos);
+		Put32(end, 0x07064b50);
+		Put32(end, 0);
+		Put64(end, pos + directory.size());
+		Put32(end, 1);
+	}
+	Put32(end, 0x06054b50);
+	Put32(end, 0); // disks
+	Put16(end, zip64 ? 0xFFFF : (uint32_t)members.size());
+	Put16(end, zip64 ? 0xFFFF : (uint32_t)members.size());
+	Put32(end, zip64 ? UINT32_MAX : (uint32_t)directory.size());
+	Put32(end, zip64 ? UINT32_MAX : (uint32_t)pos);
+	const char comment[] = "ZipBench";
+	Put16(end, sizeof(comment) - 1);
+	end.insert(end.end(), comment, comment + sizeof(comment) - 1);
+
+	fwrite(directory.data(), 1, directory.size(), f);
+	fwrite(end.data(), 1, end.size(), f);
+	const bool ok = ferror(f) == 0;
+	fclose(f);
+
+	return ok;
+}
+
+//
+// measurements
+//
+
+struct ReadResult {
+	double seconds;
+	bool ok;
+};
+
+static ReadResult ReadAll(UserFile& file, const std::vector<uint8_t>& expected)
+{
+	std::vector<uint8_t> buffer(READ_BLOCK);
+	bool ok = true;
+	uint64_t pos = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	size_t n;
+	while ((n = file.Read(buffer.data(), buffer.size())) > 0) {
+		ok = ok && pos + n <= expected.size() && memcmp(buffer.data(), expected.data() + pos, n) == 0;
+		pos += n;
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	return { seconds, ok && pos == expected.size() };
+}
+
+struct SeekResult {
+	double seconds;
+	uint64_t inflated; // decompressed bytes, the bytes returned by the reads excluded
+	bool ok;
+};
+
+// random seeks, after each a read of the size BASS makes
+static SeekResult RandomSeeks(UserFile& file, const std::vector<uint8_t>& expected, int count)
+{
+	std::mt19937_64 rng(3);
+	std::vector<uint8_t> buffer(READ_BLOCK);
+	uint64_t returned = 0;
+	bool ok = true;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < count && ok; i++) {
+		const uint64_t pos = rng() % expected.size();
+		const size_t n = file.Seek(pos) ? file.Read(buffer.data(), buffer.size()) : 0;
+		ok = n == std::min<uint64_t>(buffer.size(), expected.size() - pos) && memcmp(buffer.data(), expected.data() + pos, n) == 0;
+		returned += n;
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	return { seconds, returned, ok };
+}
+
+static std::unique_ptr<UserFile> OpenMember(const fs::path& archivePath, const std::wstring& name, uint64_t& offset, uint64_t checkpointSpan = 0)
+{
+	auto archive = std::make_unique<MappedFile>();
+	std::vector<ZipEntry_t> entries;
+	if (!archive->Open(archivePath.wstring()) || !ReadZipDirectory(*archive, entries)) {
+		return nullptr;
+	}
+	const ZipEntry_t* entry = FindZipEntry(entries, name);
+	if (!entry || !GetZipDataOffset(*archive, *entry, offset)) {
+		return nullptr;
+	}
+	if (checkpointSpan && entry->method == ZIP_METHOD_DEFLATE) {
+		return std::make_unique<InflateFile>(std::move(archive), offset, entry->compressedSize, entry->size, checkpointSpan);
+	}
+	return OpenZipMember(std::move(archive), *entry, offset);
+}
+
+int main(int argc, char* argv[])
+{
+	bool quick = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0) {
+			quick = true;
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--quick]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	// 16-bit PCM, a tone with noise, like real audio it hardly compresses
+	std::vector<uint8_t> data(quick ? 8 * 1024 * 1024 + 77 : 64 * 1024 * 1024 + 77);
+	std::mt19937 rng(13);
+	for (size_t i = 0; i + 2 <= data.size(); i += 2) {
+		const int16_t v = (int16_t)(6000 * std::sin(i * 0.0021) + (int)(rng() % 64) - 32);
+		memcpy(&data[i], &v, 2);
+	}
+
+	const auto deflateStart = std::chrono::steady_clock::now();
+	const std::vector<uint8_t> deflated = Deflate(data);
+	const double deflateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - deflateStart).count();
+
+	const std::vector<Member> members = {
+		{ "Music/Stored.wav", ZIP_METHOD_STORED, &data, &data },
+		{ "Music/Deflated.wav", ZIP_METHOD_DEFLATE, &data, &deflated },
+	};
+	const fs::path zipPath = fs::temp_directory_path() / "ZipBench.zip";
+	const fs::path zip64Path = fs::temp_directory_path() / "ZipBench64.zip";
+	if (!WriteZip(zipPath, members, false) || !WriteZip(zip64Path, members, true)) {
+		fprintf(stderr, "ERROR: can not create the archives\n");
+		return 1;
+	}
+
+	int errors = 0;
+	printf("%.1f MiB member, deflated to %.1f MiB in %.0f ms\n", data.size() / (1024.0 * 1024),
+		deflated.size() / (1024.0 * 1024), deflateSeconds * 1000);
+
+	std::wstring archivePath, memberName;
+	if (!SplitArchivePath(zipPath.wstring() + L"\\music\\deflated.WAV", archivePath, memberName)
+			|| archivePath != zipPath.wstring() || memberName != L"music\\deflated.WAV") {
+		fprintf(stderr, "ERROR: the archive path is not split\n");
+		errors++;
+	}
+
+	printf("%-28s %10s %10s\n", "input", "ms", "MiB/s");
+	auto Report = [&](const char* name, const ReadResult& r) {
+		printf("%-28s %10.1f %10.0f\n", name, r.seconds * 1000, data.size() / r.seconds / (1024 * 1024));
+		if (!r.ok) {
+			fprintf(stderr, "ERROR: %s: the content differs\n", name);
+			errors++;
+		}
+	};
+
+	for (const auto& path : { zipPath, zip64Path }) {
+		const bool is64 = path == zip64Path;
+		uint64_t storedOffset = 0;
+		uint64_t deflatedOffset = 0;
+		auto stored = OpenMember(path, memberName.substr(0, 6) + L"STORED.wav", storedOffset);
+		auto inflate = OpenMember(path, memberName, deflatedOffset);
+		if (!stored || !inflate) {
+			fprintf(stderr, "ERROR: %s: the members are not found\n", path.filename().string().c_str());
+			errors++;
+			continue;
+		}
+		if (is64) {
+			// the same members, only the content is checked
+			errors += !ReadAll(*stored, data).ok || !ReadAll(*inflate, data).ok;
+			errors += !RandomSeeks(*stored, data, 50).ok || !RandomSeeks(*inflate, data, 50).ok;
+			continue;
+		}
+
+		Report("stored, ZipRangeFile", ReadAll(*stored, data));
+		if (sizeof(void*) == 8) {
+			// zero-copy, BASS reads the member from the mapped archive as a memory stream
+			MappedFile archive;
+			if (archive.Open(path.wstring()) && archive.GetData()) {
+				const auto start = std::chrono::steady_clock::now();
+				const bool ok = memcmp(archive.GetData() + storedOffset, data.data(), data.size()) == 0;
+				const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				Report("stored, mapped archive", { seconds, ok });
+			}
+		}
+		Report("deflated, InflateFile", ReadAll(*inflate, data));
+
+		// the index was built by the sequential read, as during the playback
+		const int seekCount = quick ? 100 : 200;
+		InflateStats_t before, after;
+		static_cast<InflateFile&>(*inflate).GetStats(before);
+		const SeekResult indexed = RandomSeeks(*inflate, data, seekCount);
+		static_cast<InflateFile&>(*inflate).GetStats(after);
+		const uint64_t indexedBytes = after.inflatedBytes - before.inflatedBytes - indexed.inflated;
+
+		uint64_t offset;
+		auto plain = OpenMember(path, memberName, offset, UINT64_MAX);
+		InflateStats_t plainStats;
+		const SeekResult unindexed = RandomSeeks(*plain, data, seekCount);
+		static_cast<InflateFile&>(*plain).GetStats(plainStats);
+		const uint64_t unindexedBytes = plainStats.inflatedBytes - unindexed.inflated;
+
+		printf("%-28s %10s %10s %10s\n", "random seeks", "ms/seek", "KiB/seek", "restores");
+		printf("%-28s %10.2f %10.0f %10llu\n", "checkpoint index", indexed.seconds * 1000 / seekCount,
+			indexedBytes / 1024.0 / seekCount, (unsigned long long)(after.restores - before.restores));
+		printf("%-28s %10.2f %10.0f %10llu\n", "from the start", unindexed.seconds * 1000 / seekCount,
+			unindexedBytes / 1024.0 / seekCount, (unsigned long long)plainStats.restores);
+		printf("index: %llu checkpoints, %llu KiB\n", (unsigned long long)after.checkpoints,
+			(unsigned long long)after.checkpoints * INFLATE_WINDOW_SIZE / 1024);
+
+		if (!indexed.ok || !unindexed.ok) {
+			fprintf(stderr, "ERROR: a read after a seek differs\n");
+			errors++;
+		}
+		// a seek decompresses at most the distance to the previous checkpoint
+		if (indexedBytes / seekCount > INFLATE_CHECKPOINT_SPAN + 2 * DEFLATE_BLOCK) {
+			fprintf(stderr, "ERROR: the seeks decompress %llu KiB on average\n", (unsigned long long)(indexedBytes / seekCount / 1024));
+			errors++;
+		}
+		if (after.checkpoints < data.size() / (INFLATE_CHECKPOINT_SPAN + 2 * DEFLATE_BLOCK)) {
+			fprintf(stderr, "ERROR: %llu checkpoints\n", (unsigned long long)after.checkpoints);
+			errors++;
+		}
+	}
+
+	std::error_code ec;
+	fs::remove(zipPath, ec);
+	fs::remove(zip64Path, ec);
+
+	return errors ? 1 : 0;
+}
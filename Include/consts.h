@@ -9,6 +9,9 @@
 
 static const unsigned int BASS_CTYPE_MUSIC_ZXTUNE        = 0xCF1D0000;
 static const unsigned int BASS_CONFIG_ZXTUNE_MAXFILESIZE = 0xCF1D0100;
+// BASS_ChannelGetLength modes, the subtrack number is added to BASS_POS_ZXTUNE_SUB_LENGTH.
+// BASS_ChannelSetPosition accepts BASS_POS_BYTE only, the subtracks follow one another
+// on the byte timeline and a subtrack is selected by seeking to the sum of the preceding lengths.
 static const unsigned int BASS_POS_ZXTUNE_SUB_COUNT      = 0x00F10000;
 static const unsigned int BASS_POS_ZXTUNE_SUB_LENGTH     = 0x00F20000;
 static const unsigned int BASS_TAG_ZXTUNE_SUB_OGG        = 0x00F10000;
@@ -0,0 +1,251 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+
+#ifdef BASS_ALLOC_TRACKING
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "AllocTracker.h"
+#include "Utils/Util.h"
+
+#define ALLOC_MAX_SITES 64
+
+namespace AllocTracker
+{
+	struct alignas(64) ScopeCounters {
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> bytes;
+	};
+
+	struct Site {
+		std::atomic<const char*> name; // string literal, compared by pointer
+		std::atomic<uint8_t>     scope;
+		std::atomic<uint64_t>    count;
+		std::atomic<uint64_t>    bytes;
+	};
+
+	static ScopeCounters s_scopes[SCOPE_Count];
+	static Site s_sites[ALLOC_MAX_SITES];
+	static std::atomic<uint64_t> s_steadyStateAllocs = 0;
+
+	// trivial thread_local variables, safe to use from operator new at any time
+	static thread_local State t_state = { SCOPE_Other, nullptr };
+	static thread_local uint64_t t_counts[SCOPE_Count] = {};
+
+	static void Record(size_t size)
+	{
+		const State state = t_state;
+		t_counts[state.scope]++;
+
+		s_scopes[state.scope].count.fetch_add(1, std::memory_order_relaxed);
+		s_scopes[state.scope].bytes.fetch_add(size, std::memory_order_relaxed);
+
+		if (!state.site) {
+			return;
+		}
+		for (auto& site : s_sites) {
+			const char* name = site.name.load(std::memory_order_acquire);
+			if (!name) {
+				const char* expected = nullptr;
+				if (site.name.compare_exchange_strong(expected, state.site)) {
+					site.scope.store(state.scope, std::memory_order_relaxed);
+					name = state.site;
+				}
+				else {
+					name = expected;
+				}
+			}
+			if (name == state.site) {
+				site.count.fetch_add(1, std::memory_order_relaxed);
+				site.bytes.fetch_add(size, std::memory_order_relaxed);
+				return;
+			}
+		}
+		// the site table is full, the allocation is counted only for the scope
+	}
+
+	State Enter(Scope scope, const char* site)
+	{
+		const State prev = t_state;
+		t_state = { scope, site };
+		return prev;
+	}
+
+	void Leave(const State& prev)
+	{
+		t_state = prev;
+	}
+
+	void SetSite(const char* site)
+	{
+		t_state.site = site;
+	}
+
+	uint64_t GetThreadCount(Scope scope)
+	{
+		return t_counts[scope];
+	}
+
+	void AddSteadyStateAllocs(uint64_t count)
+	{
+		s_steadyStateAllocs.fetch_add(count, std::memory_order_relaxed);
+		DLogError(L"AllocTracker: {} heap allocations in the steady state", count);
+#ifdef BASS_ALLOC_STRICT
+		ASSERT(0);
+#endif
+	}
+
+	uint64_t GetSteadyStateAllocs()
+	{
+		return s_steadyStateAllocs.load(std::memory_order_relaxed);
+	}
+
+	Stats GetStats(Scope scope)
+	{
+		return {
+			s_scopes[scope].count.load(std::memory_order_relaxed),
+			s_scopes[scope].bytes.load(std::memory_order_relaxed)
+		};
+	}
+
+	std::vector<SiteStats> GetTopSites(Scope scope, size_t maxCount)
+	{
+		std::vector<SiteStats> sites;
+		for (const auto& site : s_sites) {
+			const char* name = site.name.load(std::memory_order_acquire);
+			if (name && site.scope.load(std::memory_order_relaxed) == scope) {
+				sites.push_back({ name, scope, site.count.load(std::memory_order_relaxed), site.bytes.load(std::memory_order_relaxed) });
+			}
+		}
+		std::sort(sites.begin(), sites.end(), [](const SiteStats& a, const SiteStats& b) {
+			return a.count > b.count || (a.count == b.count && a.bytes > b.bytes);
+		});
+		if (sites.size() > maxCount) {
+			sites.resize(maxCount);
+		}
+
+		return sites;
+	}
+
+	void Reset()
+	{
+		for (auto& scope : s_scopes) {
+			scope.count = 0;
+			scope.bytes = 0;
+		}
+		// the site names are kept, they are compared by pointer
+		for (auto& site : s_sites) {
+			site.count = 0;
+			site.bytes = 0;
+		}
+		s_steadyStateAllocs = 0;
+	}
+
+	const char* GetScopeName(Scope scope)
+	{
+		static const char* const names[SCOPE_Count] = {
+			"Other",
+			"Load",
+			"FillBuffer",
+			"Seek",
+			"MetaData",
+		};
+
+		return (scope < SCOPE_Count) ? names[scope] : "Unknown";
+	}
+
+	std::wstring GetReport()
+	{
+		std::wstring report;
+		wchar_t buf[256];
+
+		auto AppendAscii = [&report](const char* str) {
+			while (*str) {
+				report += (wchar_t)*str++;
+			}
+		};
+
+		report.append(L"Heap allocations:");
+		for (int i = 0; i < SCOPE_Count; i++) {
+			const Stats stats = GetStats((Scope)i);
+			report.append(L"\n  ");
+			AppendAscii(GetScopeName((Scope)i));
+			swprintf(buf, std::size(buf), L": %llu, %llu KiB", (unsigned long long)stats.count, (unsigned long long)(stats.bytes / 1024));
+			report.append(buf);
+		}
+		swprintf(buf, std::size(buf), L"\n  in steady state: %llu", (unsigned long long)GetSteadyStateAllocs());
+		report.append(buf);
+
+		const auto sites = GetTopSites(SCOPE_Load, 8);
+		if (sites.size()) {
+			report.append(L"\nTop sites in Load:");
+			for (const auto& site : sites) {
+				report.append(L"\n  ");
+				AppendAscii(site.name);
+				swprintf(buf, std::size(buf), L": %llu, %llu bytes", (unsigned long long)site.count, (unsigned long long)site.bytes);
+				report.append(buf);
+			}
+		}
+
+		return report;
+	}
+}
+
+//
+// replacements of the global allocation functions,
+// the array and nothrow versions of the standard library call these
+//
+
+void* operator new(size_t size)
+{
+	AllocTracker::Record(size);
+	void* p = malloc(size ? size : 1);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
+
+void* operator new(size_t size, std::align_val_t align)
+{
+	AllocTracker::Record(size);
+#ifdef _WIN32
+	void* p = _aligned_malloc(size ? size : 1, (size_t)align);
+#else
+	void* p = aligned_alloc((size_t)align, ALIGN(size ? size : 1, (size_t)align));
+#endif
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+void operator delete(void* p, size_t, std::align_val_t align) noexcept
+{
+	operator delete(p, align);
+}
+
+#endif // BASS_ALLOC_TRACKING
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+//
+// Heap allocation tracking, enabled by defining BASS_ALLOC_TRACKING.
+// Replaces the global operator new/delete of the module and attributes every
+// allocation to the scope and site of the calling thread.
+// Without BASS_ALLOC_TRACKING all macros expand to __noop.
+// For the filter, define it for BassAudioCore and BassAudioSource, the report is added to IBassSource::GetInfo.
+// Define BASS_ALLOC_STRICT as well to fail an assertion on a steady-state allocation.
+//
+
+namespace AllocTracker
+{
+	enum Scope : uint8_t {
+		SCOPE_Other = 0,
+		SCOPE_Load,
+		SCOPE_FillBuffer,
+		SCOPE_Seek,
+		SCOPE_MetaData,
+		SCOPE_Count
+	};
+
+	struct Stats {
+		uint64_t count;
+		uint64_t bytes;
+	};
+
+	struct SiteStats {
+		const char* name;
+		Scope    scope;
+		uint64_t count;
+		uint64_t bytes;
+	};
+
+	struct State {
+		Scope scope;
+		const char* site;
+	};
+
+#ifdef BASS_ALLOC_TRACKING
+	// Enter() and Leave() are for functions with __try, where ScopeGuard is not allowed
+	State Enter(Scope scope, const char* site);
+	void Leave(const State& prev);
+
+	// changes the site of the current scope
+	void SetSite(const char* site);
+
+	class ScopeGuard
+	{
+		const State m_prev;
+
+	public:
+		ScopeGuard(Scope scope, const char* site) : m_prev(Enter(scope, site)) {}
+		~ScopeGuard() { Leave(m_prev); }
+	};
+
+	// number of allocations made by the calling thread in the scope
+	uint64_t GetThreadCount(Scope scope);
+
+	// reports allocations in a loop that should not allocate,
+	// with BASS_ALLOC_STRICT also fails an assertion
+	void AddSteadyStateAllocs(uint64_t count);
+	uint64_t GetSteadyStateAllocs();
+
+	// Checks that a loop does not allocate after a few warm-up iterations.
+	// Only the allocations of the calling thread in the given scope are counted,
+	// nested scopes (e.g. metadata callbacks) are excluded.
+	class SteadyStateCheck
+	{
+		const Scope m_scope;
+		const uint32_t m_warmup;
+		uint32_t m_iterations = 0;
+		uint64_t m_start = 0;
+
+	public:
+		SteadyStateCheck(Scope scope, uint32_t warmup) : m_scope(scope), m_warmup(warmup) {}
+
+		void Restart() { m_iterations = 0; }
+		void Begin() { m_start = GetThreadCount(m_scope); }
+		void End()
+		{
+			const uint64_t count = GetThreadCount(m_scope) - m_start;
+			if (++m_iterations > m_warmup && count) {
+				AddSteadyStateAllocs(count);
+			}
+		}
+	};
+
+	Stats GetStats(Scope scope);
+	std::vector<SiteStats> GetTopSites(Scope scope, size_t maxCount);
+	void Reset();
+
+	const char* GetScopeName(Scope scope);
+	std::wstring GetReport();
+#endif
+}
+
+#ifdef BASS_ALLOC_TRACKING
+#define ALLOC_SCOPE(scope, site) AllocTracker::ScopeGuard allocScope(AllocTracker::scope, site)
+#define ALLOC_ENTER(scope, site) const AllocTracker::State allocPrev = AllocTracker::Enter(AllocTracker::scope, site)
+#define ALLOC_LEAVE()            AllocTracker::Leave(allocPrev)
+#define ALLOC_SITE(site)         AllocTracker::SetSite(site)
+#else
+#define ALLOC_SCOPE(scope, site) __noop
+#define ALLOC_ENTER(scope, site) __noop
+#define ALLOC_LEAVE()            __noop
+#define ALLOC_SITE(site)         __noop
+#endif
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include <cmath>
+#include "AudioMixer.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MIXER_SSE2 1
+#endif
+
+namespace AudioMixer
+{
+	void MixAdd(float* dst, const float* src, size_t count)
+	{
+		size_t i = 0;
+#ifdef MIXER_SSE2
+		for (; i + 8 <= count; i += 8) {
+			const __m128 a0 = _mm_loadu_ps(dst + i);
+			const __m128 a1 = _mm_loadu_ps(dst + i + 4);
+			const __m128 b0 = _mm_loadu_ps(src + i);
+			const __m128 b1 = _mm_loadu_ps(src + i + 4);
+			_mm_storeu_ps(dst + i, _mm_add_ps(a0, b0));
+			_mm_storeu_ps(dst + i + 4, _mm_add_ps(a1, b1));
+		}
+#endif
+		for (; i < count; i++) {
+			dst[i] += src[i];
+		}
+	}
+
+	void ConvertToInt16(int16_t* dst, const float* src, size_t count)
+	{
+		size_t i = 0;
+#ifdef MIXER_SSE2
+		// _mm_packs_epi32 saturates, the clipping is free
+		const __m128 scale = _mm_set1_ps(32768.0f);
+		for (; i + 8 <= count; i += 8) {
+			const __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i), scale));
+			const __m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale));
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+		}
+#endif
+		for (; i < count; i++) {
+			const float value = std::nearbyint(src[i] * 32768.0f);
+			dst[i] = (int16_t)std::clamp(value, -32768.0f, 32767.0f);
+		}
+	}
+}
@@ -0,0 +1,19 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+//
+// Sample mixing and conversion of the split MIDI rendering.
+// SSE2 is used on x86/x64, other targets use the scalar code.
+//
+
+namespace AudioMixer
+{
+	// dst[i] += src[i]
+	void MixAdd(float* dst, const float* src, size_t count);
+
+	// float [-1.0, 1.0] to 16-bit PCM, rounded and clipped
+	void ConvertToInt16(int16_t* dst, const float* src, size_t count);
+}
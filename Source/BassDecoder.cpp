@@ -27,10 +27,22 @@
 #include <../Include/bassflac.h>
 #include <../Include/basswma.h>
 #include <../Include/basswebm.h>
+#include <../Include/basszxtune.h>
 #include "Helper.h"
+#include "HttpClient.h"
+#include "AllocTracker.h"
+#include "AudioMixer.h"
+#include "InfoCache.h"
+#include "SoundFontCache.h"
+#include "SoundFontCatalog.h"
+#include "Trace.h"
 #include "Utils/Util.h"
 #include "Utils/StringUtil.h"
 
+#define MOD_LOAD_FLAGS           (BASS_MUSIC_DECODE | BASS_MUSIC_RAMP | BASS_MUSIC_POSRESET | BASS_UNICODE)
+#define MOD_DURATION_CACHE_MAX   256
+#define SUBTRACK_INDEX_CACHE_MAX 64
+
 /*** Callbacks ****************************************************************/
 
 void CALLBACK OnMetaData(HSYNC handle, DWORD channel, DWORD data, void* user)
@@ -65,32 +77,104 @@ void CALLBACK OnMetaData(HSYNC handle, DWORD channel, DWORD data, void* user)
 	}
 }
 
+void CALLBACK OnStall(HSYNC handle, DWORD channel, DWORD data, void* user)
+{
+	BassDecoder* decoder = (BassDecoder*)user;
+
+	if (data == 0) { // stalled, 1 - resumed
+		DLog(L"OnStall() - the download buffer is empty");
+		decoder->m_perf.network.netStalls.Inc();
+		Trace::Instant(Trace::EV_NetStall);
+	}
+}
+
 void CALLBACK OnDownloadData(const void* buffer, DWORD length, void* user)
 {
 	BassDecoder* decoder = (BassDecoder*)user;
-	if (buffer && decoder->m_shoutcastEvents) {
-		decoder->m_shoutcastEvents->OnShoutcastBufferCallback(buffer, length);
+	if (buffer) {
+		decoder->m_perf.network.netBytes.Add(length);
+		Trace::Instant(Trace::EV_NetData, length);
+		if (decoder->m_shoutcastEvents) {
+			decoder->m_shoutcastEvents->OnShoutcastBufferCallback(buffer, length);
+		}
 	}
 }
 
+// BASS file callbacks of a stream opened with BASS_StreamCreateFileUser,
+// the UserFile is owned by BassDecoder and is deleted after the stream is freed
+
+static void CALLBACK UserFileClose(void* user)
+{
+}
+
+static QWORD CALLBACK UserFileLength(void* user)
+{
+	return ((UserFile*)user)->GetLength();
+}
+
+static DWORD CALLBACK UserFileRead(void* buffer, DWORD length, void* user)
+{
+	const size_t read = ((UserFile*)user)->Read(buffer, length);
+	return read ? (DWORD)read : (DWORD)-1; // end of file or error
+}
+
+static BOOL CALLBACK UserFileSeek(QWORD offset, void* user)
+{
+	return ((UserFile*)user)->Seek(offset);
+}
+
+static const BASS_FILEPROCS UserFileProcs = { UserFileClose, UserFileLength, UserFileRead, UserFileSeek };
+
 //
 // BassDecoder
 //
 
-BassDecoder::BassDecoder(ShoutcastEvents* shoutcastEvents, PathType_t pathType, Settings_t& sets)
+BassDecoder::BassDecoder(ShoutcastEvents* shoutcastEvents, PathType_t pathType, const Settings_t& sets)
 	: m_shoutcastEvents(shoutcastEvents)
 	, m_pathType(pathType)
 	, m_midiSoundFontDefault(sets.sMidiSoundFontDefault)
+	, m_infoCacheEnable(sets.bInfoCache)
+	, m_midiPrerender(sets.bMidiPrerender)
+	, m_midiRenderThreads(sets.nMidiRenderThreads)
+	, m_midiAdaptiveVoices(sets.bMidiAdaptiveVoices)
+	, m_memoryMap(sets.bMemoryMap)
+	, m_networkReadAhead(sets.bNetworkReadAhead)
+	, m_archiveFiles(sets.bArchiveFiles)
+	, m_httpClientEnable(sets.bHttpClient)
+	, m_httpCacheSize(sets.nHttpCacheSize)
+	, m_httpConnections(sets.nHttpConnections)
 {
 	if (IsLikelyFilePath(sets.sMidiSoundFontDefault)) {
 		m_midiSoundFontDefault = sets.sMidiSoundFontDefault;
 	}
 	else {
+		// the property page lists the SoundFonts of the subdirectories by filename,
+		// the catalog is only needed for the ones that are not in the filter directory
 		m_midiSoundFontDefault = GetFilterDirectory() + sets.sMidiSoundFontDefault;
+		if (m_pathType.ext == PATH_TYPE_MIDI && sets.sMidiSoundFontDefault.size()
+				&& GetFileAttributesW(m_midiSoundFontDefault.c_str()) == INVALID_FILE_ATTRIBUTES) {
+			SoundFontCatalog::Start();
+			std::wstring path = SoundFontCatalog::Find(sets.sMidiSoundFontDefault);
+			if (path.size()) {
+				m_midiSoundFontDefault = std::move(path);
+			}
+		}
 	}
 
+	ALLOC_SCOPE(SCOPE_Load, "BassDecoder::LoadBASS");
+
+	uint64_t time = GetPerfTimeNs();
+	Trace::Begin(Trace::EV_LoadInit);
 	LoadBASS();
+	Trace::End(Trace::EV_LoadInit);
+	m_perf.load.initNs.Set(GetPerfTimeNs() - time);
+
+	ALLOC_SITE("BassDecoder::LoadPlugins");
+	time = GetPerfTimeNs();
+	Trace::Begin(Trace::EV_LoadPlugins);
 	LoadPlugins();
+	Trace::End(Trace::EV_LoadPlugins);
+	m_perf.load.pluginsNs.Set(GetPerfTimeNs() - time);
 }
 
 BassDecoder::~BassDecoder()
@@ -134,7 +218,7 @@ void BassDecoder::UnloadBASS()
 	}
 }
 
-#ifdef _DEBUG
+#if DLOG_LEVEL >= DLOG_LEVEL_DEBUG
 void LogPluginInfo(HPLUGIN hPlugin, LPCWSTR pligin)
 {
 	std::wstring dbgstr = std::format(L"{}:\n", pligin);
@@ -154,6 +238,231 @@ void LogPluginInfo(HPLUGIN hPlugin, LPCWSTR pligin)
 #define LogPluginInfo(hPlugin, pligin) __noop
 #endif
 
+HSTREAM BassDecoder::OpenHttpFile(const std::wstring& url)
+{
+	auto client = HttpClient::Create(url);
+	HttpResourceInfo_t info;
+	if (!client || !client->Probe(info)) {
+		return 0;
+	}
+
+	// without a validator a changed resource could not be detected,
+	// neither in the cache nor between the parallel requests
+	const std::wstring& validator = info.etag.size() ? info.etag : info.lastModified;
+	if (validator.empty() && (m_httpCacheSize || m_httpConnections > 1)) {
+		return 0;
+	}
+
+	std::shared_ptr<RangeCacheEntry> entry;
+	if (m_httpCacheSize) {
+		RangeCache* cache = GetHttpRangeCache((uint64_t)m_httpCacheSize << 20);
+		entry = cache ? cache->Open(url, validator, info.length) : nullptr;
+		if (!entry) {
+			return 0;
+		}
+	}
+
+	// the downloaded bytes are counted as those of BASS_StreamCreateURL in OnDownloadData
+	auto file = std::make_unique<HttpFile>([&] { return client->CreateStream(validator); },
+		info.length, std::move(entry), m_httpConnections, [this](size_t length) {
+			m_perf.network.netBytes.Add(length);
+			Trace::Instant(Trace::EV_NetData, (uint32_t)length);
+		});
+	HttpFile* httpFile = file.get();
+	m_userFile = std::move(file);
+
+	// BASS reads ahead on its own thread, the cached ranges are read from the disk,
+	// with BASS_STREAM_BLOCK the downloaded data is not kept in memory
+	const HSTREAM stream = BASS_StreamCreateFileUser(STREAMFILE_BUFFER, BASS_STREAM_BLOCK | BASS_STREAM_DECODE, &UserFileProcs, m_userFile.get());
+	if (!stream) {
+		DLog(L"BassDecoder::OpenHttpFile() - failed with error = {}", BassErrorToStr(BASS_ErrorGetCode()));
+		m_userFile.reset();
+		return 0;
+	}
+	m_httpFile = httpFile;
+	m_httpClient = std::move(client);
+
+	return stream;
+}
+
+// DRIVE_REMOTE for UNC paths and mapped network drives
+static UINT GetPathDriveType(const std::wstring& path)
+{
+	wchar_t volume[MAX_PATH];
+	if (!GetVolumePathNameW(path.c_str(), volume, std::size(volume))) {
+		return DRIVE_UNKNOWN;
+	}
+	return GetDriveTypeW(volume);
+}
+
+HSTREAM BassDecoder::OpenMappedFile(const std::wstring& path)
+{
+	// a read error of a mapped page is an exception, files on network and removable drives are read by BASS
+	if (GetPathDriveType(path) != DRIVE_FIXED) {
+		return 0;
+	}
+
+	auto file = std::make_unique<MappedFile>();
+	if (!file->Open(path)) {
+		return 0;
+	}
+	MappedFile* mappedFile = file.get();
+	m_userFile = std::move(file);
+
+	HSTREAM stream;
+	if (mappedFile->GetData()) {
+		// BASS reads the mapped file as a memory stream, GetData() prefetches the pages ahead of it
+		stream = BASS_StreamCreateFile(TRUE, mappedFile->GetData(), 0, mappedFile->GetLength(), BASS_STREAM_DECODE);
+	}
+	else {
+		// the views are already memory, the BASS buffering would only add a copy
+		stream = BASS_StreamCreateFileUser(STREAMFILE_NOBUFFER, BASS_STREAM_DECODE, &UserFileProcs, m_userFile.get());
+	}
+	if (!stream) {
+		DLog(L"BassDecoder::OpenMappedFile() - failed with error = {}", BassErrorToStr(BASS_ErrorGetCode()));
+		m_userFile.reset();
+		return 0;
+	}
+	m_mappedFile = mappedFile;
+
+	return stream;
+}
+
+HSTREAM BassDecoder::OpenNetworkFile(const std::wstring& path)
+{
+	if (GetPathDriveType(path) != DRIVE_REMOTE) {
+		return 0;
+	}
+
+	auto reader = OpenAsyncFile(path);
+	if (!reader) {
+		return 0;
+	}
+	auto file = std::make_unique<ReadAheadFile>(std::move(reader));
+	ReadAheadFile* readAheadFile = file.get();
+	m_userFile = std::move(file);
+
+	// the ring is the buffer, BASS reads it on the decoding thread
+	const HSTREAM stream = BASS_StreamCreateFileUser(STREAMFILE_NOBUFFER, BASS_STREAM_DECODE, &UserFileProcs, m_userFile.get());
+	if (!stream) {
+		DLog(L"BassDecoder::OpenNetworkFile() - failed with error = {}", BassErrorToStr(BASS_ErrorGetCode()));
+		m_userFile.reset();
+		return 0;
+	}
+	m_readAheadFile = readAheadFile;
+
+	return stream;
+}
+
+HSTREAM BassDecoder::OpenArchiveMember(const std::wstring& path)
+{
+	std::wstring archivePath;
+	std::wstring memberName;
+	if (!SplitArchivePath(path, archivePath, memberName)) {
+		return 0;
+	}
+
+	// the archive is mapped on fixed drives, elsewhere it is read ahead with overlapped reads
+	std::unique_ptr<UserFile> archive;
+	MappedFile* mappedFile = nullptr;
+	ReadAheadFile* readAheadFile = nullptr;
+	const UINT driveType = GetPathDriveType(archivePath);
+	if (driveType == DRIVE_FIXED) {
+		auto file = std::make_unique<MappedFile>();
+		if (file->Open(archivePath)) {
+			mappedFile = file.get();
+			archive = std::move(file);
+		}
+	}
+	else if (auto reader = OpenAsyncFile(archivePath)) {
+		auto file = std::make_unique<ReadAheadFile>(std::move(reader));
+		readAheadFile = file.get();
+		archive = std::move(file);
+	}
+	if (!archive) {
+		return 0;
+	}
+
+	std::vector<ZipEntry_t> entries;
+	if (!ReadZipDirectory(*archive, entries)) {
+		DLog(L"BassDecoder::OpenArchiveMember() - \"{}\" is not a ZIP archive", archivePath);
+		return 0;
+	}
+	const ZipEntry_t* entry = FindZipEntry(entries, memberName);
+	uint64_t offset = 0;
+	if (!entry || !GetZipDataOffset(*archive, *entry, offset)) {
+		DLog(L"BassDecoder::OpenArchiveMember() - \"{}\" is not found", memberName);
+		return 0;
+	}
+
+	HSTREAM stream = 0;
+	if (entry->method == ZIP_METHOD_STORED && !(entry->flags & ZIP_FLAG_ENCRYPTED) && mappedFile && mappedFile->GetData()) {
+		// BASS reads the stored member from the mapped archive as a memory stream
+		m_userFile = std::move(archive);
+		stream = BASS_StreamCreateFile(TRUE, mappedFile->GetData() + offset, 0, entry->compressedSize, BASS_STREAM_DECODE);
+		if (stream) {
+			m_mappedFile = mappedFile;
+			m_mappedOffset = offset;
+		}
+	}
+	else {
+		m_userFile = OpenZipMember(std::move(archive), *entry, offset);
+		if (!m_userFile) {
+			return 0;
+		}
+		// the member is read or decompressed on the decoding thread, the archive file is the buffer
+		stream = BASS_StreamCreateFileUser(STREAMFILE_NOBUFFER, BASS_STREAM_DECODE, &UserFileProcs, m_userFile.get());
+		if (stream && driveType == DRIVE_REMOTE) {
+			m_readAheadFile = readAheadFile;
+		}
+	}
+	if (!stream) {
+		DLog(L"BassDecoder::OpenArchiveMember() - failed with error = {}", BassErrorToStr(BASS_ErrorGetCode()));
+		m_userFile.reset();
+		return 0;
+	}
+	DLog(L"BassDecoder::OpenArchiveMember() - \"{}\", method {}, {} bytes", entry->name, entry->method, entry->size);
+
+	return stream;
+}
+
+bool BassDecoder::GetHttpFileStats(HttpFileStats_t& stats)
+{
+	if (!m_httpFile) {
+		return false;
+	}
+
+	m_httpFile->GetStats(stats);
+	return true;
+}
+
+void BassDecoder::GetPerfInfo(PerfInfo_t& info)
+{
+	m_perf.GetInfo(info, GetBytesPerSecond());
+
+	ReadAheadStats_t share = {};
+	if (m_readAheadFile) {
+		m_readAheadFile->GetStats(share);
+	}
+	info.shareStalls         = share.stalls;
+	info.shareStallTimeNs    = share.stallTimeNs;
+	info.shareStallMaxNs     = share.stallMaxNs;
+	info.shareLatencyNs      = share.latencyNs;
+	info.shareReadAhead      = (uint64_t)share.depth * share.blockSize;
+	info.shareReadAheadDepth = share.depth;
+
+	HttpClientStats_t http = {};
+	if (m_httpClient) {
+		m_httpClient->GetStats(http);
+	}
+	info.httpRequests      = http.requests;
+	info.httpConnections   = http.connections;
+	info.httpTlsResumed    = http.tlsResumed;
+	info.httpConnectTimeNs = http.connectTimeNs;
+	info.httpTtfbTimeNs    = http.ttfbTimeNs;
+	info.httpTtfbMaxNs     = http.ttfbMaxNs;
+}
+
 void BassDecoder::LoadPlugins()
 {
 	static LPCWSTR BassPlugins[] = {
@@ -172,8 +481,10 @@ void BassDecoder::LoadPlugins()
 	};
 
 	const std::wstring filterDir = GetFilterDirectory();
+	uint32_t pluginIndex = 0;
 
 	auto LoadBassPlugin = [&](LPCWSTR pligin) {
+		Trace::Scope trace(Trace::EV_PluginLoad, pluginIndex++);
 		const std::wstring pluginPath = filterDir + pligin;
 		HPLUGIN hPlugin = BASS_PluginLoad(LPCSTR(pluginPath.c_str()), BASS_UNICODE);
 		if (hPlugin) {
@@ -218,6 +529,15 @@ bool BassDecoder::Load(std::wstring path) // use copy of path here
 	Close();
 	DLog(L"BassDecoder::Load - \"{}\"", path);
 
+	Trace::Scope trace(Trace::EV_Load);
+	ALLOC_SCOPE(SCOPE_Load, "Load: info cache read");
+	const uint64_t loadStart = GetPerfTimeNs();
+	uint64_t time = loadStart;
+	m_perf.load.cacheNs.Set(0);
+	m_perf.load.openNs.Set(0);
+	m_perf.load.tagsNs.Set(0);
+	m_perf.load.totalNs.Set(0);
+
 	if (path.compare(0, 4, L"icyx") == 0) {
 		// replace ICYX
 		path[0] = 'h';
@@ -226,48 +546,128 @@ bool BassDecoder::Load(std::wstring path) // use copy of path here
 		path[3] = 'p';
 	}
 
+	Trace::Begin(Trace::EV_LoadCache);
+	FileKey_t fileKey;
+	CachedInfo_t cachedInfo;
+	const bool useInfoCache = m_infoCacheEnable && !m_pathType.url && GetFileKey(path, fileKey);
+	const bool infoCacheHit = useInfoCache && InfoCache::Read(fileKey, cachedInfo);
+	Trace::End(Trace::EV_LoadCache, infoCacheHit);
+	m_perf.load.cacheNs.Set(GetPerfTimeNs() - time);
+
+	ALLOC_SITE("Load: cached metadata");
+	if (infoCacheHit && m_shoutcastEvents) {
+		// serve the metadata immediately, the stream parameters are checked after opening
+		if (!cachedInfo.tags.Empty()) {
+			m_shoutcastEvents->OnMetaDataCallback(&cachedInfo.tags);
+		}
+		if (cachedInfo.resources.size()) {
+			auto pResources = std::make_unique<std::list<DSMResource>>(cachedInfo.resources);
+			m_shoutcastEvents->OnResourceDataCallback(pResources);
+		}
+	}
+
+	ALLOC_SITE("Load: stream open");
+	time = GetPerfTimeNs();
+	Trace::Begin(Trace::EV_LoadOpen);
+
 	if (m_pathType.ext == PATH_TYPE_MIDI) {
-		m_soundFont = BASS_MIDI_FontInit((const void*)m_midiSoundFontDefault.c_str(), BASS_MIDI_FONT_MMAP | BASS_UNICODE);
+		m_soundFont = SoundFontCache::Acquire(m_midiSoundFontDefault);
 		if (m_soundFont) {
 			BASS_MIDI_FONT sf = { m_soundFont, -1, 0 };
 			BOOL ret = BASS_MIDI_StreamSetFonts(0, &sf, 1); // set default soundfont
 		} else {
 			DLog(L"ERROR: default SoundFont not found!");
+			Trace::End(Trace::EV_LoadOpen);
 			return false;
 		}
 		
 	}
 
 	if (m_pathType.ext == PATH_TYPE_MOD) {
-		m_stream = BASS_MusicLoad(BASS_FILE_NAME, (const void*)path.c_str(), 0, 0, BASS_MUSIC_DECODE | BASS_MUSIC_RAMP | BASS_MUSIC_POSRESET | BASS_MUSIC_PRESCAN | BASS_UNICODE, 0);
+		// without BASS_MUSIC_PRESCAN, the whole module is not played through before the playback starts
+		m_stream = BASS_MusicLoad(BASS_FILE_NAME, (const void*)path.c_str(), 0, 0, MOD_LOAD_FLAGS, 0);
 	}
 	else if (m_pathType.url) {
 		// disable Media Foundation because navigation for M4A DASH (YouTube) does not work
 		EXECUTE_ASSERT(BASS_SetConfig(BASS_CONFIG_MF_DISABLE, TRUE));
 
-		m_stream = BASS_StreamCreateURL((const char*)path.c_str(), 0,
-			BASS_STREAM_BLOCK | BASS_STREAM_DECODE | BASS_UNICODE | BASS_STREAM_STATUS,
-			OnDownloadData, this
-		);
+		if (m_httpClientEnable || m_httpCacheSize || m_httpConnections > 1) {
+			m_stream = OpenHttpFile(path);
+		}
+		if (!m_stream) {
+			m_stream = BASS_StreamCreateURL((const char*)path.c_str(), 0,
+				BASS_STREAM_BLOCK | BASS_STREAM_DECODE | BASS_UNICODE | BASS_STREAM_STATUS,
+				OnDownloadData, this
+			);
+		}
 	}
 	else {
-		m_stream = BASS_StreamCreateFile(BASS_FILE_NAME, (const void*)path.c_str(), 0, 0, BASS_STREAM_DECODE | BASS_UNICODE);
+		if (m_archiveFiles) {
+			m_stream = OpenArchiveMember(path);
+		}
+		if (!m_stream && m_memoryMap) {
+			m_stream = OpenMappedFile(path);
+		}
+		if (!m_stream && m_networkReadAhead) {
+			m_stream = OpenNetworkFile(path);
+		}
+		if (!m_stream) {
+			m_stream = BASS_StreamCreateFile(BASS_FILE_NAME, (const void*)path.c_str(), 0, 0, BASS_STREAM_DECODE | BASS_UNICODE);
+		}
 	}
 
 	if (!m_stream) {
 		const int error_code = BASS_ErrorGetCode();
 		DLog(L"BassDecoder::Load - Opening the path failed with error = {}", BassErrorToStr(error_code));
+		Trace::End(Trace::EV_LoadOpen);
 		return false;
 	}
 
 	if (!GetStreamInfos()) {
 		Close();
+		Trace::End(Trace::EV_LoadOpen);
 		return false;
 	}
 
+	Trace::End(Trace::EV_LoadOpen);
+	m_perf.load.openNs.Set(GetPerfTimeNs() - time);
+
+	if (m_pathType.ext == PATH_TYPE_MOD) {
+		StartModPrescan(path);
+	}
+	else if (m_pathType.ext == PATH_TYPE_ZXTUNE) {
+		StartSubtrackIndex(path);
+	}
+	else if (m_pathType.ext == PATH_TYPE_MIDI) {
+		if (m_midiPrerender) {
+			const RenderFormat_t format = { m_sampleRate, m_channels, m_bytesPerSample, m_float };
+			RenderSettings_t settings;
+			float value = 0;
+			if (BASS_ChannelGetAttribute(m_stream, BASS_ATTRIB_MIDI_VOICES, &value)) {
+				settings.voices = (int)value;
+			}
+			if (BASS_ChannelGetAttribute(m_stream, BASS_ATTRIB_SRC, &value)) {
+				settings.srcQuality = (int)value;
+			}
+			BASS_CHANNELINFO info;
+			if (BASS_ChannelGetInfo(m_stream, &info)) {
+				settings.midiFlags = info.flags & RENDERCACHE_MIDI_FLAGS;
+			}
+			m_renderCache = MidiRenderCache::Open(path, m_midiSoundFontDefault, m_soundFont, format, settings);
+			m_useRenderCache = !!m_renderCache;
+		}
+		if (m_renderCache) {
+			m_midiPath = path;
+		}
+		else {
+			StartMidiLive(path);
+		}
+	}
+
 	if (m_pathType.url) {
 		m_syncMeta = BASS_ChannelSetSync(m_stream, BASS_SYNC_META, 0, OnMetaData, this);
 		m_syncOggChange = BASS_ChannelSetSync(m_stream, BASS_SYNC_OGG_CHANGE, 0, OnMetaData, this);
+		m_syncStall = BASS_ChannelSetSync(m_stream, BASS_SYNC_STALL, 0, OnStall, this);
 
 		m_isLiveStream = (GetDuration() == 0);
 	}
@@ -275,9 +675,72 @@ bool BassDecoder::Load(std::wstring path) // use copy of path here
 	DLog(L"BassDecoder::Load - '{}', {} Hz, {} ch, {}{}",
 		GetBassTypeStr(m_ctype), m_sampleRate, m_channels, m_float ? L"Float" : L"Int", m_bytesPerSample*8);
 
+	if (infoCacheHit) {
+		if (cachedInfo.ctype == m_ctype
+				&& cachedInfo.sampleRate == m_sampleRate
+				&& cachedInfo.channels == m_channels
+				&& cachedInfo.bytesPerSample == m_bytesPerSample
+				&& cachedInfo.isFloat == m_float) {
+			m_cachedDuration = cachedInfo.duration;
+			m_infoCacheStatus = INFOCACHE_HIT;
+			m_perf.load.totalNs.Set(GetPerfTimeNs() - loadStart);
+
+			return true;
+		}
+
+		DLog(L"BassDecoder::Load - cached info is outdated");
+	}
+
+	ALLOC_SITE("Load: ReadTags");
 	ContentTags tags;
 	auto pResources = std::make_unique<std::list<DSMResource>>();
 
+	time = GetPerfTimeNs();
+	Trace::Begin(Trace::EV_LoadTags);
+	ReadTags(tags, pResources);
+	Trace::End(Trace::EV_LoadTags);
+	m_perf.load.tagsNs.Set(GetPerfTimeNs() - time);
+
+	if (useInfoCache) {
+		time = GetPerfTimeNs();
+		Trace::Scope traceCache(Trace::EV_LoadCache);
+		ALLOC_SITE("Load: info cache write");
+
+		cachedInfo.ctype          = m_ctype;
+		cachedInfo.sampleRate     = m_sampleRate;
+		cachedInfo.channels       = m_channels;
+		cachedInfo.bytesPerSample = m_bytesPerSample;
+		cachedInfo.isFloat        = m_float;
+		cachedInfo.tags           = tags;
+		cachedInfo.resources      = *pResources;
+
+		// the module prescan may finish at any moment, the length is read under the lock that its write takes
+		std::lock_guard<std::mutex> lock(m_modInfoCacheMutex);
+		cachedInfo.duration = GetDuration();
+		if (InfoCache::Write(fileKey, cachedInfo)) {
+			m_infoCacheStatus = INFOCACHE_UPDATED;
+		}
+		m_perf.load.cacheNs.Add(GetPerfTimeNs() - time);
+	}
+
+	ALLOC_SITE("Load: metadata");
+	if (m_shoutcastEvents) {
+		// replace outdated cached metadata even if the file no longer has tags
+		if (!tags.Empty() || infoCacheHit) {
+			m_shoutcastEvents->OnMetaDataCallback(&tags);
+		}
+		if (pResources->size() || infoCacheHit) {
+			m_shoutcastEvents->OnResourceDataCallback(pResources);
+		}
+	}
+
+	m_perf.load.totalNs.Set(GetPerfTimeNs() - loadStart);
+
+	return true;
+}
+
+void BassDecoder::ReadTags(ContentTags& tags, std::unique_ptr<std::list<DSMResource>>& pResources)
+{
 	if (m_pathType.ext == PATH_TYPE_MOD) {
 		LPCSTR p = BASS_ChannelGetTags(m_stream, BASS_TAG_MUSIC_NAME);
 		if (p) {
@@ -411,21 +874,56 @@ bool BassDecoder::Load(std::wstring path) // use copy of path here
 			index++;
 		}
 	}
+}
 
-	if (m_shoutcastEvents) {
-		if (!tags.Empty()) {
-			m_shoutcastEvents->OnMetaDataCallback(&tags);
-		}
-		if (pResources->size()) {
-			m_shoutcastEvents->OnResourceDataCallback(pResources);
+void BassDecoder::Close()
+{
+	// stops the rendering, the default SoundFont must stay loaded until then
+	m_renderCache.reset();
+	m_useRenderCache = false;
+	m_midiPath.clear();
+
+	m_voiceController.reset();
+	m_midiSplitPool.reset();
+	for (const HSTREAM stream : m_midiSplitStreams) {
+		BASS_StreamFree(stream);
+	}
+	m_midiSplitStreams.clear();
+	m_midiSplitBuffers.clear();
+	m_midiSplitResults.clear();
+	m_midiSplitBytes = 0;
+
+	// the preload can not be cancelled, it must finish before the stream is freed
+	if (m_midiPreload.valid()) {
+		m_midiPreload.wait();
+		m_midiPreload = {};
+	}
+	m_midiPreloadWait = false;
+
+	// the prescan can not be cancelled either
+	if (m_modPrescan.valid()) {
+		const HMUSIC music = m_modPrescan.get();
+		if (music) {
+			BASS_MusicFree(music);
 		}
 	}
+	m_modDuration = 0;
+	m_modPrescanPending = false;
 
-	return true;
-}
+	if (m_subtrackIndex.valid()) {
+		m_subtrackIndexStop = true;
+		m_subtrackIndex.wait();
+		m_subtrackIndex = {};
+	}
+	m_subtrackIndexStop = false;
+	{
+		std::lock_guard<std::mutex> lock(m_subtrackMutex);
+		m_subtracks.clear();
+	}
+	m_subtrack = 0;
+	m_subtrackStart = 0;
+	m_subtrackLength = 0;
 
-void BassDecoder::Close()
-{
 	if (m_stream) {
 		if (m_syncMeta) {
 			BASS_ChannelRemoveSync(m_stream, m_syncMeta);
@@ -433,6 +931,9 @@ void BassDecoder::Close()
 		if (m_syncOggChange) {
 			BASS_ChannelRemoveSync(m_stream, m_syncOggChange);
 		}
+		if (m_syncStall) {
+			BASS_ChannelRemoveSync(m_stream, m_syncStall);
+		}
 
 		if (m_pathType.ext == PATH_TYPE_MOD) {
 			BASS_MusicFree(m_stream);
@@ -444,13 +945,22 @@ void BassDecoder::Close()
 		m_stream = 0;
 	}
 
+	// BASS does not read the file after the stream is freed
+	m_httpFile = nullptr;
+	m_mappedFile = nullptr;
+	m_mappedOffset = 0;
+	m_readAheadFile = nullptr;
+	m_userFile.reset();
+	m_httpClient.reset();
+
 	if (m_soundFont) {
-		BASS_MIDI_FontFree(m_soundFont);
+		SoundFontCache::Release(m_soundFont);
 		m_soundFont = 0;
 	}
 
 	m_syncMeta = 0;
 	m_syncOggChange = 0;
+	m_syncStall = 0;
 
 	m_channels = 0;
 	m_sampleRate = 0;
@@ -461,6 +971,11 @@ void BassDecoder::Close()
 
 	m_isLiveStream = false;
 
+	m_infoCacheStatus = INFOCACHE_UNUSED;
+	m_cachedDuration = 0;
+
+	m_perf.ResetStreaming();
+
 	m_tagTitle.clear();
 	m_tagArtist.clear();
 	m_tagComment.clear();
@@ -468,7 +983,482 @@ void BassDecoder::Close()
 
 int BassDecoder::GetData(void* buffer, int size)
 {
-	return BASS_ChannelGetData(m_stream, buffer, size);
+	if (m_midiPreloadWait) {
+		// the first buffer waits for the preload, then the first note-ons do not load samples
+		m_midiPreloadWait = false;
+		m_midiPreload.wait_for(std::chrono::milliseconds(MIDI_PRELOAD_WAIT_MS));
+	}
+
+	const uint64_t time = GetPerfTimeNs();
+	Trace::Begin(Trace::EV_GetData);
+	int ret = -1;
+	bool rendered = true;
+	if (m_useRenderCache) {
+		ret = m_renderCache->Read(buffer, size);
+		if (ret < 0) {
+			// the rendering failed, continue with the live stream
+			m_useRenderCache = false;
+			StartMidiLive(m_midiPath);
+			SetLivePosition(m_renderCache->GetPosition());
+		}
+		rendered = (ret < 0);
+	}
+	if (ret < 0 && m_subtrackLength) {
+		// stop at the end of the selected subtrack, the next one follows it on the timeline
+		const QWORD pos = BASS_ChannelGetPosition(m_stream, BASS_POS_BYTE) - m_subtrackStart;
+		if (pos < m_subtrackLength) {
+			ret = (int)BASS_ChannelGetData(m_stream, buffer, (DWORD)std::min<QWORD>(size, m_subtrackLength - pos));
+		}
+	}
+	else if (ret < 0) {
+		ret = m_midiSplitStreams.size() ? GetMidiSplitData(buffer, size) : BASS_ChannelGetData(m_stream, buffer, size);
+	}
+	Trace::End(Trace::EV_GetData, (ret > 0) ? ret : 0);
+	const uint64_t decodeNs = GetPerfTimeNs() - time;
+	m_perf.AddDecode(decodeNs, ret);
+
+	if (m_mappedFile && m_mappedFile->GetData()) {
+		m_mappedFile->Prefetch(m_mappedOffset + BASS_StreamGetFilePosition(m_stream, BASS_FILEPOS_CURRENT));
+	}
+
+	if (m_voiceController && rendered && ret > 0) {
+		UpdateVoiceControl(decodeNs, ret);
+	}
+
+	return ret;
+}
+
+void BassDecoder::StartVoiceControl()
+{
+	float voices = 0;
+	float quality = 0;
+	BASS_ChannelGetAttribute(m_stream, BASS_ATTRIB_MIDI_VOICES, &voices);
+	BASS_ChannelGetAttribute(m_stream, BASS_ATTRIB_MIDI_SRC, &quality);
+
+	m_voiceController = std::make_unique<VoiceController>((int)voices, (int)quality);
+	ApplyVoiceControl();
+}
+
+void BassDecoder::UpdateVoiceControl(uint64_t renderNs, int bytes)
+{
+	const uint64_t audioNs = (uint64_t)bytes * 1000000000 / m_bytesPerSecond;
+
+	float active = 0;
+	if (m_midiSplitStreams.size()) {
+		for (const HSTREAM stream : m_midiSplitStreams) {
+			float value = 0;
+			BASS_ChannelGetAttribute(stream, BASS_ATTRIB_MIDI_VOICES_ACTIVE, &value);
+			active += value;
+		}
+	}
+	else {
+		BASS_ChannelGetAttribute(m_stream, BASS_ATTRIB_MIDI_VOICES_ACTIVE, &active);
+	}
+
+	if (m_voiceController->Update(renderNs, audioNs, (int)active)) {
+		ApplyVoiceControl();
+	}
+	m_perf.stream.midiLoadPermille.Set((uint64_t)(m_voiceController->GetLoad() * 1000));
+}
+
+void BassDecoder::ApplyVoiceControl()
+{
+	const auto& state = m_voiceController->GetState();
+
+	if (m_midiSplitStreams.size()) {
+		// the limit is shared by the streams of the split rendering
+		const int count = (int)m_midiSplitStreams.size();
+		const float voices = (float)((state.voices + count - 1) / count);
+		for (const HSTREAM stream : m_midiSplitStreams) {
+			BASS_ChannelSetAttribute(stream, BASS_ATTRIB_MIDI_VOICES, voices);
+			BASS_ChannelSetAttribute(stream, BASS_ATTRIB_MIDI_SRC, (float)state.quality);
+		}
+	}
+	else {
+		BASS_ChannelSetAttribute(m_stream, BASS_ATTRIB_MIDI_VOICES, (float)state.voices);
+		BASS_ChannelSetAttribute(m_stream, BASS_ATTRIB_MIDI_SRC, (float)state.quality);
+	}
+
+	DLog(L"BassDecoder - MIDI voice limit {}, interpolation {}, load {:.2f}", state.voices, state.quality, m_voiceController->GetLoad());
+
+	m_perf.stream.midiVoices.Set(state.voices);
+	m_perf.stream.midiQuality.Set(state.quality);
+	m_perf.stream.midiDecreases.Set(m_voiceController->GetDecreases());
+	m_perf.stream.midiIncreases.Set(m_voiceController->GetIncreases());
+}
+
+// drops the notes of the MIDI channels that belong to other streams of the split rendering,
+// the controllers and program changes of all channels are processed by every stream
+static BOOL CALLBACK MidiSplitFilter(HSTREAM handle, int track, BASS_MIDI_EVENT* event, BOOL seeking, void* user)
+{
+	// user - stream index in the low 16 bits, stream count in the high 16 bits
+	const DWORD index = (DWORD)(uintptr_t)user & 0xFFFF;
+	const DWORD count = (DWORD)(uintptr_t)user >> 16;
+
+	return (event->event != MIDI_EVENT_NOTE || event->chan % count == index);
+}
+
+void BassDecoder::StartMidiSplit(const std::wstring& path)
+{
+	// the streams are mixed in float, 8-bit output is not supported
+	if (!m_float && m_bytesPerSample != 2) {
+		return;
+	}
+
+	const DWORD count = std::min({ m_midiRenderThreads, std::max(std::thread::hardware_concurrency(), 1u), (unsigned)MIDI_SPLIT_MAX_STREAMS });
+	if (count < 2) {
+		return;
+	}
+
+	DWORD flags = BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT | BASS_UNICODE;
+	if (m_channels == 1) {
+		flags |= BASS_SAMPLE_MONO;
+	}
+
+	for (DWORD i = 0; i < count; i++) {
+		const HSTREAM stream = BASS_MIDI_StreamCreateFile(FALSE, path.c_str(), 0, 0, flags, m_sampleRate);
+		if (!stream) {
+			DLog(L"BassDecoder::StartMidiSplit - failed with error = {}", BassErrorToStr(BASS_ErrorGetCode()));
+			break;
+		}
+		m_midiSplitStreams.push_back(stream);
+		BASS_MIDI_StreamSetFilter(stream, TRUE, MidiSplitFilter, (void*)(uintptr_t)((count << 16) | i));
+	}
+
+	if (m_midiSplitStreams.size() != count) {
+		for (const HSTREAM stream : m_midiSplitStreams) {
+			BASS_StreamFree(stream);
+		}
+		m_midiSplitStreams.clear();
+		return;
+	}
+
+	m_midiSplitBuffers.resize(count);
+	m_midiSplitResults.resize(count);
+	m_midiSplitPool = std::make_unique<WorkerPool>(count - 1);
+
+	DLog(L"BassDecoder::StartMidiSplit - {} streams", count);
+}
+
+void BassDecoder::RenderMidiSplitStream(void* context, size_t index)
+{
+	BassDecoder* decoder = (BassDecoder*)context;
+	decoder->m_midiSplitResults[index] = (int)BASS_ChannelGetData(decoder->m_midiSplitStreams[index], decoder->m_midiSplitBuffers[index].data(), decoder->m_midiSplitBytes);
+}
+
+int BassDecoder::GetMidiSplitData(void* buffer, int size)
+{
+	const size_t samples = size / m_bytesPerSample;
+	for (auto& splitBuffer : m_midiSplitBuffers) {
+		if (splitBuffer.size() < samples) {
+			splitBuffer.resize(samples);
+		}
+	}
+	m_midiSplitBytes = (DWORD)(samples * sizeof(float));
+
+	// all streams render the same range of the same events, so the timing stays sample-accurate
+	m_midiSplitPool->Run(RenderMidiSplitStream, this, m_midiSplitStreams.size());
+
+	size_t mixed = 0;
+	for (size_t i = 0; i < m_midiSplitStreams.size(); i++) {
+		if (m_midiSplitResults[i] <= 0) {
+			continue;
+		}
+		const size_t n = m_midiSplitResults[i] / sizeof(float);
+		if (i > 0) {
+			// a shorter or failed first stream is padded with silence
+			if (n > mixed) {
+				std::fill(m_midiSplitBuffers[0].begin() + mixed, m_midiSplitBuffers[0].begin() + n, 0.0f);
+			}
+			AudioMixer::MixAdd(m_midiSplitBuffers[0].data(), m_midiSplitBuffers[i].data(), n);
+		}
+		mixed = std::max(mixed, n);
+	}
+	if (!mixed) {
+		return m_midiSplitResults[0];
+	}
+
+	if (m_float) {
+		memcpy(buffer, m_midiSplitBuffers[0].data(), mixed * sizeof(float));
+	}
+	else {
+		AudioMixer::ConvertToInt16((int16_t*)buffer, m_midiSplitBuffers[0].data(), mixed);
+	}
+
+	return (int)(mixed * m_bytesPerSample);
+}
+
+void BassDecoder::StartMidiLive(const std::wstring& path)
+{
+	StartMidiPreload();
+	if (m_midiRenderThreads > 1) {
+		StartMidiSplit(path);
+	}
+	if (m_midiAdaptiveVoices) {
+		StartVoiceControl();
+	}
+}
+
+void BassDecoder::StartMidiPreload()
+{
+	// BASS_MIDI_StreamLoadSamples scans the program and bank changes of the file
+	// and loads only the samples of the presets that are used.
+	// It runs in the background while the graph is starting.
+	const HSTREAM stream = m_stream;
+	const HSOUNDFONT soundFont = m_soundFont;
+
+	m_midiPreload = std::async(std::launch::async, [stream, soundFont]() {
+		BASS_MIDI_FONTINFO info = {};
+		BASS_MIDI_FontGetInfo(soundFont, &info);
+		const DWORD samload = info.samload;
+
+		Trace::Begin(Trace::EV_MidiPreload);
+		const BOOL ret = BASS_MIDI_StreamLoadSamples(stream);
+		BASS_MIDI_FontGetInfo(soundFont, &info);
+		Trace::End(Trace::EV_MidiPreload, info.samload - samload);
+
+		DLogIf(!ret, L"BassDecoder - MIDI sample preload failed with error = {}", BassErrorToStr(BASS_ErrorGetCode()));
+		DLog(L"BassDecoder - MIDI sample preload done, {} KiB", (info.samload - samload) / 1024);
+	});
+	m_midiPreloadWait = true;
+}
+
+//
+// the lengths of the prescanned modules, keyed by path, size and modification time
+//
+
+static std::mutex s_modDurationMutex;
+static std::list<std::pair<FileKey_t, REFERENCE_TIME>> s_modDurations; // the most recent first
+
+static REFERENCE_TIME FindModDuration(const FileKey_t& key)
+{
+	std::lock_guard<std::mutex> lock(s_modDurationMutex);
+
+	for (const auto& [k, duration] : s_modDurations) {
+		if (k.path == key.path && k.size == key.size && k.mtime == key.mtime) {
+			return duration;
+		}
+	}
+
+	return 0;
+}
+
+static void AddModDuration(const FileKey_t& key, REFERENCE_TIME duration)
+{
+	std::lock_guard<std::mutex> lock(s_modDurationMutex);
+
+	std::erase_if(s_modDurations, [&key](const auto& item) { return item.first.path == key.path; });
+	s_modDurations.emplace_front(key, duration);
+	if (s_modDurations.size() > MOD_DURATION_CACHE_MAX) {
+		s_modDurations.pop_back();
+	}
+}
+
+void BassDecoder::StartModPrescan(const std::wstring& path)
+{
+	FileKey_t fileKey;
+	const bool hasFileKey = GetFileKey(path, fileKey);
+
+	m_modDuration = hasFileKey ? FindModDuration(fileKey) : 0;
+	m_modPrescanPending = (m_modDuration == 0);
+
+	// the prescanned handle is also needed for seeking, so the prescan runs even if the length is cached
+	const bool updateInfoCache = m_infoCacheEnable && hasFileKey;
+	const int bytesPerSecond = m_bytesPerSecond;
+
+	m_modPrescan = std::async(std::launch::async, [this, path, fileKey, hasFileKey, updateInfoCache, bytesPerSecond]() {
+		Trace::Begin(Trace::EV_ModPrescan);
+		const HMUSIC music = BASS_MusicLoad(BASS_FILE_NAME, (const void*)path.c_str(), 0, 0, MOD_LOAD_FLAGS | BASS_MUSIC_PRESCAN, 0);
+
+		REFERENCE_TIME duration = 0;
+		if (music) {
+			const QWORD len = BASS_ChannelGetLength(music, BASS_POS_BYTE);
+			if (len != QWORD(-1)) {
+				duration = Int64x32Div32(len, UNITS, bytesPerSecond, 0);
+			}
+		}
+		Trace::End(Trace::EV_ModPrescan, (uint32_t)(duration / (UNITS / MILLISECONDS)));
+
+		DLogIf(!music, L"BassDecoder - module prescan failed with error = {}", BassErrorToStr(BASS_ErrorGetCode()));
+		DLog(L"BassDecoder - module prescan done, {} ms", duration / (UNITS / MILLISECONDS));
+
+		if (duration) {
+			if (hasFileKey) {
+				AddModDuration(fileKey, duration);
+			}
+			// Load writes the info cache entry under the same lock. If it writes first, the entry is updated here,
+			// otherwise it reads the length set here. Either way the entry ends with the length.
+			std::lock_guard<std::mutex> lock(m_modInfoCacheMutex);
+			m_modDuration = duration;
+			CachedInfo_t cachedInfo;
+			if (updateInfoCache && InfoCache::Read(fileKey, cachedInfo) && cachedInfo.duration != duration) {
+				cachedInfo.duration = duration;
+				InfoCache::Write(fileKey, cachedInfo);
+			}
+		}
+		m_modPrescanPending = false;
+
+		return music;
+	});
+}
+
+void BassDecoder::SwitchToModPrescan()
+{
+	// BASS_POS_BYTE seeking in a module requires BASS_MUSIC_PRESCAN, the prescanned handle replaces
+	// the one that is playing. A seek before the end of the prescan waits for it.
+	const HMUSIC music = m_modPrescan.get();
+	if (music) {
+		BASS_MusicFree(m_stream);
+		m_stream = music;
+	}
+}
+
+//
+// the subtrack indexes of the containers opened by this process, keyed by path, size and modification time
+//
+
+static std::mutex s_subtrackIndexMutex;
+static std::list<std::pair<FileKey_t, std::vector<Subtrack_t>>> s_subtrackIndexes; // the most recent first
+
+static bool FindSubtrackIndex(const FileKey_t& key, std::vector<Subtrack_t>& subtracks)
+{
+	std::lock_guard<std::mutex> lock(s_subtrackIndexMutex);
+
+	for (const auto& [k, index] : s_subtrackIndexes) {
+		if (k.path == key.path && k.size == key.size && k.mtime == key.mtime) {
+			subtracks = index;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void AddSubtrackIndex(const FileKey_t& key, const std::vector<Subtrack_t>& subtracks)
+{
+	std::lock_guard<std::mutex> lock(s_subtrackIndexMutex);
+
+	std::erase_if(s_subtrackIndexes, [&key](const auto& item) { return item.first.path == key.path; });
+	s_subtrackIndexes.emplace_front(key, subtracks);
+	if (s_subtrackIndexes.size() > SUBTRACK_INDEX_CACHE_MAX) {
+		s_subtrackIndexes.pop_back();
+	}
+}
+
+void BassDecoder::StartSubtrackIndex(const std::wstring& path)
+{
+	FileKey_t fileKey;
+	const bool hasFileKey = GetFileKey(path, fileKey);
+	const bool useInfoCache = m_infoCacheEnable && hasFileKey;
+
+	std::vector<Subtrack_t> subtracks;
+	if (hasFileKey && (FindSubtrackIndex(fileKey, subtracks) || (useInfoCache && InfoCache::ReadSubtracks(fileKey, subtracks)))) {
+		AddSubtrackIndex(fileKey, subtracks);
+		std::lock_guard<std::mutex> lock(m_subtrackMutex);
+		m_subtracks = std::move(subtracks);
+		return;
+	}
+
+	// The subtrack lengths may take a long time to compute, so the index is built on a second
+	// handle and does not block the decoding of the first one. It is built once per file.
+	const int bytesPerSecond = m_bytesPerSecond;
+
+	m_subtrackIndex = std::async(std::launch::async, [this, path, fileKey, hasFileKey, useInfoCache, bytesPerSecond]() {
+		const HSTREAM stream = BASS_StreamCreateFile(BASS_FILE_NAME, (const void*)path.c_str(), 0, 0, BASS_STREAM_DECODE | BASS_UNICODE);
+		if (!stream) {
+			return;
+		}
+
+		std::vector<Subtrack_t> subtracks;
+		const QWORD count = BASS_ChannelGetLength(stream, BASS_POS_ZXTUNE_SUB_COUNT);
+		if (count != QWORD(-1) && count > 1) {
+			subtracks.resize((size_t)count);
+			for (DWORD i = 0; i < count && !m_subtrackIndexStop; i++) {
+				// the length and the OGG-style tags of a subtrack are queried with the subtrack number added
+				const QWORD len = BASS_ChannelGetLength(stream, BASS_POS_ZXTUNE_SUB_LENGTH + i);
+				if (len != QWORD(-1)) {
+					subtracks[i].duration = Int64x32Div32(len, UNITS, bytesPerSecond, 0);
+				}
+				if (LPCSTR p = BASS_ChannelGetTags(stream, BASS_TAG_ZXTUNE_SUB_OGG + i)) {
+					ContentTags tags;
+					ReadTagsCommon(p, tags);
+					subtracks[i].title = std::move(tags.Title);
+				}
+			}
+		}
+		BASS_StreamFree(stream);
+
+		if (m_subtrackIndexStop) {
+			return; // incomplete
+		}
+		DLog(L"BassDecoder - {} subtracks indexed", subtracks.size());
+
+		if (hasFileKey) {
+			AddSubtrackIndex(fileKey, subtracks);
+			if (useInfoCache) {
+				InfoCache::WriteSubtracks(fileKey, subtracks);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(m_subtrackMutex);
+		m_subtracks = std::move(subtracks);
+	});
+}
+
+int BassDecoder::GetSubtrackCount()
+{
+	std::lock_guard<std::mutex> lock(m_subtrackMutex);
+	return (int)m_subtracks.size();
+}
+
+bool BassDecoder::GetSubtrack(int index, Subtrack_t& subtrack)
+{
+	std::lock_guard<std::mutex> lock(m_subtrackMutex);
+
+	if (index < 0 || index >= (int)m_subtracks.size()) {
+		return false;
+	}
+	subtrack = m_subtracks[index];
+
+	return true;
+}
+
+bool BassDecoder::SetSubtrack(int index)
+{
+	if (!m_stream || index < 0 || index >= GetSubtrackCount()) {
+		return false;
+	}
+
+	// There is no position mode that selects a subtrack. The plugin plays all subtracks
+	// on one byte timeline, a byte position selects the subtrack that contains it.
+	QWORD start = 0;
+	QWORD length = 0;
+	for (int i = 0; i <= index; i++) {
+		length = BASS_ChannelGetLength(m_stream, BASS_POS_ZXTUNE_SUB_LENGTH + i);
+		if (length == QWORD(-1)) {
+			DLog(L"BassDecoder::SetSubtrack - failed with error = {}", BassErrorToStr(BASS_ErrorGetCode()));
+			return false;
+		}
+		if (i < index) {
+			start += length;
+		}
+	}
+	if (!BASS_ChannelSetPosition(m_stream, start, BASS_POS_BYTE)) {
+		DLog(L"BassDecoder::SetSubtrack - failed with error = {}", BassErrorToStr(BASS_ErrorGetCode()));
+		return false;
+	}
+
+	m_subtrack = index;
+	m_subtrackStart = start;
+	m_subtrackLength = length;
+	m_cachedDuration = 0; // the cached duration is of the whole container
+
+	return true;
+}
+
+bool BassDecoder::IsDurationPending()
+{
+	return !m_cachedDuration && m_modPrescanPending.load();
 }
 
 bool BassDecoder::GetStreamInfos()
@@ -513,6 +1503,18 @@ REFERENCE_TIME BassDecoder::GetDuration()
 		return 0;
 	}
 
+	if (m_subtrackLength) {
+		return Int64x32Div32(m_subtrackLength, UNITS, m_bytesPerSecond, 0);
+	}
+
+	if (m_cachedDuration) {
+		return m_cachedDuration;
+	}
+
+	if (m_pathType.ext == PATH_TYPE_MOD) {
+		return m_modDuration.load();
+	}
+
 	QWORD len = BASS_ChannelGetLength(m_stream, BASS_POS_BYTE);
 	if (len == QWORD(-1)) {
 		return 0;
@@ -530,7 +1532,19 @@ REFERENCE_TIME BassDecoder::GetPosition()
 		return 0;
 	}
 
-	QWORD len = BASS_ChannelGetPosition(m_stream, BASS_POS_BYTE);
+	QWORD len;
+	if (m_useRenderCache) {
+		len = m_renderCache->GetPosition();
+	}
+	else if (m_midiSplitStreams.size()) {
+		len = BASS_ChannelGetPosition(m_midiSplitStreams[0], BASS_POS_BYTE) / sizeof(float) * m_bytesPerSample;
+	}
+	else {
+		len = BASS_ChannelGetPosition(m_stream, BASS_POS_BYTE);
+		if (len != QWORD(-1)) {
+			len = (len > m_subtrackStart) ? len - m_subtrackStart : 0;
+		}
+	}
 	ASSERT(len != QWORD(-1));
 
 	//REFERENCE_TIME time = (REFERENCE_TIME)(BASS_ChannelBytes2Seconds(m_stream, len) * UNITS);
@@ -545,8 +1559,91 @@ void BassDecoder::SetPosition(REFERENCE_TIME refTime)
 		return;
 	}
 
+	if (m_modPrescan.valid()) {
+		SwitchToModPrescan();
+	}
+
 	//QWORD len = BASS_ChannelSeconds2Bytes(m_stream, (double)refTime / UNITS);
 	QWORD len = Int64x32Div32(refTime, m_bytesPerSecond, UNITS, 0);
 
+	if (m_subtrackLength) {
+		len = m_subtrackStart + std::min(len, m_subtrackLength);
+	}
+
+	SetLivePosition(len);
+
+	if (m_renderCache) {
+		// the rendering continues for the next playback if the position is not rendered yet
+		m_useRenderCache = m_renderCache->Seek(len);
+	}
+}
+
+void BassDecoder::SetLivePosition(QWORD len)
+{
 	BASS_ChannelSetPosition(m_stream, len, BASS_POS_BYTE);
+
+	// the split streams render float samples
+	const QWORD splitPos = m_float ? len : len / m_bytesPerSample * sizeof(float);
+	for (const HSTREAM stream : m_midiSplitStreams) {
+		BASS_ChannelSetPosition(stream, splitPos, BASS_POS_BYTE);
+	}
+}
+
+uint64_t BassDecoder::GetStreamBufferSize()
+{
+	if (m_stream && m_pathType.url) {
+		const QWORD size = BASS_StreamGetFilePosition(m_stream, BASS_FILEPOS_BUFFER);
+		if (size != (QWORD)-1) {
+			return size;
+		}
+	}
+
+	return 0;
+}
+
+uint64_t BassDecoder::GetSoundFontSize()
+{
+	BASS_MIDI_FONTINFO info;
+	if (m_soundFont && BASS_MIDI_FontGetInfo(m_soundFont, &info)) {
+		return info.samload;
+	}
+
+	return 0;
+}
+
+uint64_t BassDecoder::CompactSoundFont()
+{
+	if (!m_soundFont) {
+		return 0;
+	}
+
+	const uint64_t size = GetSoundFontSize();
+	BASS_MIDI_FontCompact(m_soundFont);
+	const uint64_t newSize = GetSoundFontSize();
+
+	return (size > newSize) ? size - newSize : 0;
+}
+
+LPCWSTR BassDecoder::GetInfoCacheStatusStr()
+{
+	switch (m_infoCacheStatus) {
+	case INFOCACHE_HIT:     return L"hit";
+	case INFOCACHE_UPDATED: return L"updated";
+	default:                return L"not used";
+	}
+}
+
+LPCWSTR BassDecoder::GetRenderCacheStatusStr()
+{
+	if (!m_renderCache) {
+		return nullptr;
+	}
+	if (m_renderCache->IsFailed()) {
+		return L"failed";
+	}
+	if (!m_useRenderCache) {
+		return L"not used at the current position";
+	}
+
+	return m_renderCache->IsComplete() ? L"complete" : L"rendering";
 }
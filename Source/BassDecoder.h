@@ -22,10 +22,24 @@
 
 #pragma once
 
+#include <atomic>
+#include <future>
+#include <mutex>
 #include <../Include/bass.h>
 #include <../Include/bassmidi.h>
 #include "BassHelper.h"
 #include "IBassSource.h"
+#include "HttpFile.h"
+#include "MappedFile.h"
+#include "ReadAheadFile.h"
+#include "ZipArchive.h"
+#include "InfoCache.h"
+#include "MidiRenderCache.h"
+#include "VoiceController.h"
+#include "WorkerPool.h"
+#include "PerfCounters.h"
+
+class HttpClient;
 
 #define PATH_TYPE_UNKNOWN  0
 #define PATH_TYPE_REGULAR  1
@@ -35,6 +49,12 @@
 #define PATH_TYPE_ZXTUNE   5
 #define PATH_TYPE_WEBM     6
 
+#define INFOCACHE_UNUSED   0
+#define INFOCACHE_HIT      1
+#define INFOCACHE_UPDATED  2
+
+#define MIDI_PRELOAD_WAIT_MS 1000 // the longest delay of the first buffer
+
 struct PathType_t
 {
 	UINT ext : 8 = PATH_TYPE_UNKNOWN;
@@ -60,12 +80,63 @@ protected:
 
 	const PathType_t m_pathType;
 	std::wstring m_midiSoundFontDefault;
+	const bool m_infoCacheEnable;
+	const bool m_midiPrerender;
+	const unsigned m_midiRenderThreads;
+	const bool m_midiAdaptiveVoices;
+	const bool m_memoryMap;
+	const bool m_networkReadAhead;
+	const bool m_archiveFiles;
+	const bool m_httpClientEnable;
+	const unsigned m_httpCacheSize;
+	const unsigned m_httpConnections;
+	int m_infoCacheStatus = INFOCACHE_UNUSED;
+	REFERENCE_TIME m_cachedDuration = 0;
 
 	HMODULE m_optimFROGDLL = nullptr;
 	HSTREAM m_stream = 0;
+	std::unique_ptr<UserFile> m_userFile; // input of a stream opened with BASS_StreamCreateFileUser
+	HttpFile* m_httpFile = nullptr;
+	std::shared_ptr<HttpClient> m_httpClient;
+	MappedFile* m_mappedFile = nullptr;
+	uint64_t m_mappedOffset = 0; // position of the stream in the mapped file, a stored archive member
+	ReadAheadFile* m_readAheadFile = nullptr;
 	HSOUNDFONT m_soundFont = 0;
+	std::future<void> m_midiPreload;
+	bool m_midiPreloadWait = false;
+	std::unique_ptr<MidiRenderCache> m_renderCache;
+	bool m_useRenderCache = false; // false after seeking beyond the rendered data
+	std::wstring m_midiPath;       // the live playback is started with it if the rendering fails
+
+	// a tracker module is opened without BASS_MUSIC_PRESCAN,
+	// a second handle with the prescan computes the length in the background
+	std::future<HMUSIC> m_modPrescan;
+	std::atomic<REFERENCE_TIME> m_modDuration = 0;
+	std::atomic<bool> m_modPrescanPending = false;
+	std::mutex m_modInfoCacheMutex; // orders the info cache writes of Load and the prescan
+
+	// subtracks of a ZXTune container, the index is built on a second handle in the background
+	std::future<void> m_subtrackIndex;
+	std::atomic<bool> m_subtrackIndexStop = false;
+	std::mutex m_subtrackMutex;
+	std::vector<Subtrack_t> m_subtracks;
+	int m_subtrack = 0;
+	// the plugin plays the subtracks one after another on a single byte timeline,
+	// a selected subtrack is the range [start, start + length) of it
+	QWORD m_subtrackStart = 0;
+	QWORD m_subtrackLength = 0;
+
+	// split MIDI rendering, each stream plays the notes of a subset of the MIDI channels
+	std::vector<HSTREAM> m_midiSplitStreams;
+	std::vector<std::vector<float>> m_midiSplitBuffers;
+	std::vector<int> m_midiSplitResults;
+	std::unique_ptr<WorkerPool> m_midiSplitPool;
+	DWORD m_midiSplitBytes = 0; // float bytes requested from each stream
+
+	std::unique_ptr<VoiceController> m_voiceController;
 	HSYNC m_syncMeta = 0;
 	HSYNC m_syncOggChange = 0;
+	HSYNC m_syncStall = 0;
 	bool m_isLiveStream = false;
 
 	int m_channels = 0;
@@ -80,18 +151,40 @@ protected:
 	std::wstring m_tagArtist;
 	std::wstring m_tagComment;
 
+	PerfCounters m_perf;
+
 	void LoadBASS();
 	void UnloadBASS();
 	void LoadPlugins();
+	HSTREAM OpenHttpFile(const std::wstring& url);
+	HSTREAM OpenMappedFile(const std::wstring& path);
+	HSTREAM OpenNetworkFile(const std::wstring& path);
+	HSTREAM OpenArchiveMember(const std::wstring& path);
+	// the preload, the split streams and the voice control of the live playback
+	void StartMidiLive(const std::wstring& path);
+	void StartMidiPreload();
+	void StartModPrescan(const std::wstring& path);
+	void SwitchToModPrescan();
+	void StartSubtrackIndex(const std::wstring& path);
+	void StartMidiSplit(const std::wstring& path);
+	int GetMidiSplitData(void* buffer, int size);
+	static void RenderMidiSplitStream(void* context, size_t index);
+	void StartVoiceControl();
+	void UpdateVoiceControl(uint64_t renderNs, int bytes);
+	void ApplyVoiceControl();
+	void SetLivePosition(QWORD len);
 
 	bool GetStreamInfos();
+	void ReadTags(ContentTags& tags, std::unique_ptr<std::list<DSMResource>>& pResources);
 public:
 	REFERENCE_TIME GetDuration();
+	// the duration is not known yet, it will be returned by GetDuration() later
+	bool IsDurationPending();
 	REFERENCE_TIME GetPosition();
 	void SetPosition(REFERENCE_TIME refTime);
 
 public:
-	BassDecoder(ShoutcastEvents* shoutcastEvents, PathType_t pathType, Settings_t& sets);
+	BassDecoder(ShoutcastEvents* shoutcastEvents, PathType_t pathType, const Settings_t& sets);
 	~BassDecoder();
 
 	bool Load(std::wstring path);
@@ -106,8 +199,35 @@ public:
 	inline int GetBytesPerSecond() { return m_bytesPerSecond; }
 	inline bool GetFloat()         { return m_float; }
 	inline bool GetIsLiveStream()  { return m_isLiveStream; }
+	inline bool GetIsUrl()         { return m_pathType.url; }
+	inline bool GetIsHttpFile()    { return m_httpFile != nullptr; }
+
+	LPCWSTR GetInfoCacheStatusStr();
+	// nullptr if the MIDI render cache is not used
+	LPCWSTR GetRenderCacheStatusStr();
+
+	// download buffer of a network stream
+	uint64_t GetStreamBufferSize();
+	// loaded sample data of the SoundFont, the font may be shared with other instances
+	uint64_t GetSoundFontSize();
+	// unloads the SoundFont samples that are not in use, returns the number of released bytes
+	uint64_t CompactSoundFont();
+
+	// 0 until the subtrack index is ready
+	int GetSubtrackCount();
+	bool GetSubtrack(int index, Subtrack_t& subtrack);
+	inline int GetCurrentSubtrack() { return m_subtrack; }
+	// switches the subtrack of the open container and rewinds it
+	bool SetSubtrack(int index);
+
+	inline PerfCounters& GetPerfCounters() { return m_perf; }
+	// the counters and the statistics of the HTTP client
+	void GetPerfInfo(PerfInfo_t& info);
+	// false if the stream is not read through HttpFile
+	bool GetHttpFileStats(HttpFileStats_t& stats);
 
 	friend void CALLBACK OnMetaData(HSYNC handle, DWORD channel, DWORD data, void* user);
+	friend void CALLBACK OnStall(HSYNC handle, DWORD channel, DWORD data, void* user);
 	friend void CALLBACK OnDownloadData(const void* buffer, DWORD length, void* user);
 };
 
@@ -45,7 +45,9 @@
 #include <../Include/basszxtune.h>
 #include <../Include/bassmidi.h>
 
+#ifdef _WIN32
 #include <wincrypt.h>
+#endif
 
 struct METADATA_BLOCK_PICTURE {
 	uint32_t apic;      // ID3v2 "APIC" picture type
@@ -63,7 +65,7 @@ struct METADATA_BLOCK_PICTURE {
 
 const wchar_t* BassErrorToStr(const int er)
 {
-#define UNPACK_VALUE(VALUE) case VALUE: return L#VALUE;
+#define UNPACK_VALUE(VALUE) case VALUE: return L"" #VALUE;
 	switch (er) {
 		UNPACK_VALUE(BASS_OK);
 		UNPACK_VALUE(BASS_ERROR_MEM);
@@ -171,6 +173,25 @@ LPCWSTR GetBassTypeStr(const DWORD ctype)
 	return L"Unknown";
 }
 
+LPCWSTR GetBassTypeExt(const DWORD ctype)
+{
+	switch (ctype) {
+	case BASS_CTYPE_STREAM_VORBIS:   return L"ogg";
+	case BASS_CTYPE_STREAM_MP1:      return L"mp1";
+	case BASS_CTYPE_STREAM_MP2:      return L"mp2";
+	case BASS_CTYPE_STREAM_MP3:      return L"mp3";
+	case BASS_CTYPE_STREAM_WMA:      return L"wma";
+	case BASS_CTYPE_STREAM_AAC:      return L"aac";
+	case BASS_CTYPE_STREAM_MP4:      return L"m4a";
+	case BASS_CTYPE_STREAM_FLAC:     return L"flac";
+	case BASS_CTYPE_STREAM_FLAC_OGG: return L"oga";
+	case BASS_CTYPE_STREAM_OPUS:     return L"opus";
+	case BASS_CTYPE_STREAM_SPX:      return L"spx";
+	}
+
+	return L"bin";
+}
+
 void ReadTagsCommon(const char* p, ContentTags& tags)
 {
 	while (p && *p) {
@@ -27,6 +27,8 @@
 const wchar_t* BassErrorToStr(const int er);
 
 LPCWSTR GetBassTypeStr(const DWORD ctype);
+// file extension of a compressed stream, "bin" for an unknown type
+LPCWSTR GetBassTypeExt(const DWORD ctype);
 
 struct ContentTags
 {
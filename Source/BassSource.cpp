@@ -25,14 +25,14 @@
 #include "BassSource.h"
 #include "PropPage.h"
 #include <MMReg.h>
+#include "AllocTracker.h"
 #include "Helper.h"
+#include "SettingsCache.h"
+#include "SoundFontCache.h"
+#include "Trace.h"
 #include "Utils/Util.h"
 #include "Utils/StringUtil.h"
 
-#define OPT_REGKEY_BassAudioSource L"Software\\MPC-BE Filters\\BassAudioSource"
-#define OPT_MidiEnable             L"MIDI_Enable"
-#define OPT_MidiSoundFontDefault   L"MIDI_SoundFontDefault"
-#define OPT_WebmEnable             L"WebM_Enable"
 
 volatile LONG InstanceCount = 0;
 
@@ -62,6 +62,10 @@ BassSource::~BassSource()
 	}
 
 	delete m_metaLock;
+
+	if (InstanceCount == 0) {
+		Log::Shutdown(); // print the remaining messages before the DLL can be unloaded
+	}
 }
 
 void BassSource::Init()
@@ -70,12 +74,11 @@ void BassSource::Init()
 	DbgSetModuleLevel(LOG_TRACE, DWORD_MAX);
 	DbgSetModuleLevel(LOG_ERROR, DWORD_MAX);
 #endif
+	Log::Resume();
 	DLog(L"BassSource::Init()");
 
 	m_metaLock = new CCritSec();
 
-	LoadSettings();
-
 	InterlockedIncrement(&InstanceCount);
 }
 
@@ -85,6 +88,8 @@ void STDMETHODCALLTYPE BassSource::OnMetaDataCallback(const ContentTags* pTags)
 	if (!pTags) {
 		return;
 	}
+	Trace::Instant(Trace::EV_MetaData);
+	ALLOC_ENTER(SCOPE_MetaData, "OnMetaDataCallback");
 
 	m_metaLock->Lock();
 	__try {
@@ -93,6 +98,10 @@ void STDMETHODCALLTYPE BassSource::OnMetaDataCallback(const ContentTags* pTags)
 	__finally {
 		m_metaLock->Unlock();
 	}
+
+	ALLOC_LEAVE();
+
+	EnforceMemBudget();
 }
 
 void STDMETHODCALLTYPE BassSource::OnStreamTitleCallback(const wchar_t* title)
@@ -101,6 +110,8 @@ void STDMETHODCALLTYPE BassSource::OnStreamTitleCallback(const wchar_t* title)
 	if (!title) {
 		return;
 	}
+	Trace::Instant(Trace::EV_StreamTitle);
+	ALLOC_ENTER(SCOPE_MetaData, "OnStreamTitleCallback");
 
 	m_metaLock->Lock();
 	__try {
@@ -109,6 +120,10 @@ void STDMETHODCALLTYPE BassSource::OnStreamTitleCallback(const wchar_t* title)
 	__finally {
 		m_metaLock->Unlock();
 	}
+
+	ALLOC_LEAVE();
+
+	SplitRecording(title);
 }
 
 void STDMETHODCALLTYPE BassSource::OnResourceDataCallback(std::unique_ptr<std::list<DSMResource>>& pResources)
@@ -117,6 +132,8 @@ void STDMETHODCALLTYPE BassSource::OnResourceDataCallback(std::unique_ptr<std::l
 	if (!pResources) {
 		return;
 	}
+	Trace::Instant(Trace::EV_ResourceData, (uint32_t)pResources->size());
+	ALLOC_SCOPE(SCOPE_MetaData, "OnResourceDataCallback");
 
 	m_metaLock->Lock();
 
@@ -131,44 +148,26 @@ void STDMETHODCALLTYPE BassSource::OnResourceDataCallback(std::unique_ptr<std::l
 	}
 
 	m_metaLock->Unlock();
+
+	EnforceMemBudget();
 }
 
 void STDMETHODCALLTYPE BassSource::OnShoutcastBufferCallback(const void* buffer, DWORD size)
 {
+	std::lock_guard<std::mutex> lock(m_recordMutex);
+
+	if (m_recorder) {
+		// only a copy to the recorder buffer, the file is written on the recorder thread
+		m_recorder->Write(buffer, size);
+	}
 }
 
-void BassSource::LoadSettings()
+void BassSource::SplitRecording(const wchar_t* title)
 {
-	HKEY key;
-	DWORD dwType;
-	ULONG nBytes;
-
-	LSTATUS lRes = RegOpenKeyW(HKEY_CURRENT_USER, OPT_REGKEY_BassAudioSource, &key);
-	if (lRes == ERROR_SUCCESS) {
-		DWORD dwValue;
-		nBytes = sizeof(DWORD);
-		lRes = ::RegQueryValueExW(key, OPT_MidiEnable, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
-		if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
-			m_Sets.bMidiEnable = !!dwValue;
-		}
+	std::lock_guard<std::mutex> lock(m_recordMutex);
 
-		lRes = ::RegQueryValueExW(key, OPT_MidiSoundFontDefault, nullptr, &dwType, nullptr, &nBytes);
-		if (lRes == ERROR_SUCCESS && dwType == REG_SZ) {
-			std::wstring str(nBytes, 0);
-			lRes = ::RegQueryValueExW(key, OPT_MidiSoundFontDefault, nullptr, &dwType, reinterpret_cast<LPBYTE>(str.data()), &nBytes);
-			if (lRes == ERROR_SUCCESS && dwType == REG_SZ) {
-				str_truncate_after_null(str);
-				m_Sets.sMidiSoundFontDefault = str;
-			}
-		}
-
-		nBytes = sizeof(DWORD);
-		lRes = ::RegQueryValueExW(key, OPT_WebmEnable, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
-		if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
-			m_Sets.bWebmEnable = !!dwValue;
-		}
-
-		RegCloseKey(key);
+	if (m_recorder) {
+		m_recorder->Split(title);
 	}
 }
 
@@ -196,6 +195,14 @@ STDMETHODIMP BassSource::NonDelegatingQueryInterface(REFIID iid, void** ppv)
 			return E_NOINTERFACE;
 		}
 	}
+	else if (IsEqualIID(iid, IID_IAMStreamSelect)) {
+		if (SUCCEEDED(GetInterface((LPUNKNOWN)(IAMStreamSelect*)this, ppv))) {
+			return S_OK;
+		}
+		else {
+			return E_NOINTERFACE;
+		}
+	}
 	else if (IsEqualIID(iid, IID_ISpecifyPropertyPages)) {
 		if (SUCCEEDED(GetInterface((LPUNKNOWN)(ISpecifyPropertyPages*)this, ppv))) {
 			return S_OK;
@@ -276,6 +283,9 @@ STDMETHODIMP BassSource::Load(LPCOLESTR pszFileName, const AM_MEDIA_TYPE* pmt)
 		"mka", "webm", "weba",
 	};
 
+	// the current snapshot, the settings can change between the loads
+	const Settings_t& sets = SettingsCache::Get();
+
 	m_filePath = pszFileName;
 	PathType_t path_type;
 
@@ -313,7 +323,7 @@ STDMETHODIMP BassSource::Load(LPCOLESTR pszFileName, const AM_MEDIA_TYPE* pmt)
 				}
 			}
 		}
-		if (!path_type.ext && m_Sets.bMidiEnable) {
+		if (!path_type.ext && sets.bMidiEnable) {
 			for (const auto& bass_ext : bass_midi_exts) {
 				if (ext.compare(bass_ext) == 0) {
 					path_type.ext = PATH_TYPE_MIDI;
@@ -329,7 +339,7 @@ STDMETHODIMP BassSource::Load(LPCOLESTR pszFileName, const AM_MEDIA_TYPE* pmt)
 				}
 			}
 		}
-		if (!path_type.ext && m_Sets.bWebmEnable) {
+		if (!path_type.ext && sets.bWebmEnable) {
 			for (const auto& bass_ext : bass_webm_exts) {
 				if (ext.compare(bass_ext) == 0) {
 					path_type.ext = PATH_TYPE_WEBM;
@@ -349,7 +359,7 @@ STDMETHODIMP BassSource::Load(LPCOLESTR pszFileName, const AM_MEDIA_TYPE* pmt)
 	}
 
 	HRESULT hr;
-	m_pin = new BassSourceStream(L"Bass Source Stream", hr, this, L"Output", m_filePath.c_str(), this, path_type, m_Sets);
+	m_pin = new BassSourceStream(L"Bass Source Stream", hr, this, L"Output", m_filePath.c_str(), this, path_type, sets);
 	if (FAILED(hr)) {
 		return hr;
 	}
@@ -358,9 +368,124 @@ STDMETHODIMP BassSource::Load(LPCOLESTR pszFileName, const AM_MEDIA_TYPE* pmt)
 		m_Tags.Title = std::filesystem::path(m_filePath).filename();
 	}
 
+	EnforceMemBudget();
+
 	return S_OK;
 }
 
+void BassSource::GetMemUsage(MemInfo_t& info)
+{
+	info = {};
+
+	auto StrSize = [](const std::wstring& str) -> uint64_t {
+		return str.capacity() * sizeof(wchar_t);
+	};
+
+	{
+		CAutoLock cAutoLock(m_metaLock);
+
+		info.tags = StrSize(m_Tags.Title) + StrSize(m_Tags.AuthorName) + StrSize(m_Tags.Description) + StrSize(m_Tags.StationName);
+		if (m_pResources) {
+			for (const auto& r : *m_pResources) {
+				info.resources += r.data.capacity() + StrSize(r.name) + StrSize(r.desc) + StrSize(r.mime);
+			}
+		}
+	}
+
+	if (m_pin) {
+		info.pinBuffers = m_pin->GetAllocatedBytes();
+		if (m_pin->m_decoder) {
+			info.streamBuffer = m_pin->m_decoder->GetStreamBufferSize();
+			info.soundFont = m_pin->m_decoder->GetSoundFontSize();
+		}
+	}
+
+	info.total = info.resources + info.tags + info.streamBuffer + info.soundFont + info.pinBuffers;
+	// the SoundFonts are shared, the process total counts each cached font once
+	m_memAccount.Set(info.total - info.soundFont);
+	info.processTotal = MemAccount::GetProcessTotal() + SoundFontCache::GetLoadedBytes();
+	info.evicted = m_memEvicted;
+}
+
+void BassSource::EnforceMemBudget()
+{
+	// called from the network thread as well, the current snapshot is read here
+	const Settings_t& sets = SettingsCache::Get();
+	const uint64_t budget = (uint64_t)sets.nMemoryBudget << 20;
+	const uint64_t processBudget = (uint64_t)sets.nProcessMemoryBudget << 20;
+	if (!budget && !processBudget) {
+		return;
+	}
+
+	MemInfo_t info;
+	GetMemUsage(info);
+
+	auto OverBudget = [&]() {
+		return (budget && info.total > budget) || (processBudget && info.processTotal > processBudget);
+	};
+
+	if (!OverBudget()) {
+		return;
+	}
+
+	// the process budget is enforced by each instance on its own data,
+	// other instances release theirs at their next check
+
+	// first the cached SoundFonts without users and the SoundFont samples that are not in use,
+	// they are reloaded when needed
+	if (processBudget && info.processTotal > processBudget) {
+		const uint64_t released = SoundFontCache::EvictIdle();
+		if (released) {
+			m_memEvicted += released;
+			GetMemUsage(info);
+			if (!OverBudget()) {
+				return;
+			}
+		}
+	}
+	if (m_pin && m_pin->m_decoder) {
+		const uint64_t released = m_pin->m_decoder->CompactSoundFont();
+		if (released) {
+			m_memEvicted += released;
+			GetMemUsage(info);
+			if (!OverBudget()) {
+				return;
+			}
+		}
+	}
+
+	// then the embedded pictures, the largest first
+	uint64_t released = 0;
+	{
+		CAutoLock cAutoLock(m_metaLock);
+
+		while (m_pResources && OverBudget()) {
+			auto largest = m_pResources->end();
+			for (auto it = m_pResources->begin(); it != m_pResources->end(); ++it) {
+				if (it->mime.starts_with(L"image/") && (largest == m_pResources->end() || it->data.size() > largest->data.size())) {
+					largest = it;
+				}
+			}
+			if (largest == m_pResources->end()) {
+				break;
+			}
+
+			const uint64_t size = largest->data.capacity();
+			DLog(L"BassSource::EnforceMemBudget - evicting '{}', {} bytes", largest->name, size);
+			m_pResources->erase(largest);
+
+			released += size;
+			info.total -= size;
+			info.processTotal -= std::min(info.processTotal, size);
+		}
+	}
+
+	if (released) {
+		m_memEvicted += released;
+		GetMemUsage(info);
+	}
+}
+
 STDMETHODIMP BassSource::GetCurFile(LPOLESTR* ppszFileName, AM_MEDIA_TYPE* pmt)
 {
 	CheckPointer(ppszFileName, E_POINTER);
@@ -453,6 +578,8 @@ STDMETHODIMP BassSource::get_Description(THIS_ BSTR FAR* pbstrDescription)
 
 STDMETHODIMP_(DWORD) BassSource::ResGetCount()
 {
+	CAutoLock cAutoLock(m_metaLock);
+
 	return m_pResources ? (DWORD)m_pResources->size() : 0;
 }
 
@@ -462,6 +589,8 @@ STDMETHODIMP BassSource::ResGet(DWORD iIndex, BSTR* ppName, BSTR* ppDesc, BSTR*
 		CheckPointer(pDataLen, E_POINTER);
 	}
 
+	CAutoLock cAutoLock(m_metaLock); // resources can be evicted, see EnforceMemBudget
+
 	if (!m_pResources || iIndex >= m_pResources->size()) {
 		return E_INVALIDARG;
 	}
@@ -494,6 +623,80 @@ STDMETHODIMP BassSource::ResGet(DWORD iIndex, BSTR* ppName, BSTR* ppDesc, BSTR*
 	return S_OK;
 }
 
+// IAMStreamSelect
+
+STDMETHODIMP BassSource::Count(DWORD* pcStreams)
+{
+	CheckPointer(pcStreams, E_POINTER);
+
+	// the subtrack index is built in the background, until then there is nothing to select
+	*pcStreams = (m_pin && m_pin->m_decoder) ? m_pin->m_decoder->GetSubtrackCount() : 0;
+
+	return S_OK;
+}
+
+STDMETHODIMP BassSource::Info(long lIndex, AM_MEDIA_TYPE** ppmt, DWORD* pdwFlags, LCID* plcid, DWORD* pdwGroup, WCHAR** ppszName, IUnknown** ppObject, IUnknown** ppUnk)
+{
+	Subtrack_t subtrack;
+	if (!m_pin || !m_pin->m_decoder || !m_pin->m_decoder->GetSubtrack(lIndex, subtrack)) {
+		return E_INVALIDARG;
+	}
+
+	if (ppmt) {
+		CMediaType mt;
+		*ppmt = SUCCEEDED(m_pin->GetMediaType(&mt)) ? CreateMediaType(&mt) : nullptr;
+	}
+	if (pdwFlags) {
+		*pdwFlags = (lIndex == m_pin->m_decoder->GetCurrentSubtrack()) ? AMSTREAMSELECTINFO_EXCLUSIVE : 0;
+	}
+	if (plcid) {
+		*plcid = 0;
+	}
+	if (pdwGroup) {
+		*pdwGroup = 1;
+	}
+	if (ppszName) {
+		const long seconds = (long)(subtrack.duration / UNITS);
+		std::wstring name = std::format(L"Subtrack {}", lIndex + 1);
+		if (subtrack.title.size()) {
+			name += std::format(L": {}", subtrack.title);
+		}
+		if (seconds) {
+			name += std::format(L" [{}:{:02}]", seconds / 60, seconds % 60);
+		}
+
+		const size_t size = (name.size() + 1) * sizeof(WCHAR);
+		*ppszName = (WCHAR*)CoTaskMemAlloc(size);
+		if (!*ppszName) {
+			return E_OUTOFMEMORY;
+		}
+		memcpy(*ppszName, name.c_str(), size);
+	}
+	if (ppObject) {
+		*ppObject = nullptr;
+	}
+	if (ppUnk) {
+		*ppUnk = nullptr;
+	}
+
+	return S_OK;
+}
+
+STDMETHODIMP BassSource::Enable(long lIndex, DWORD dwFlags)
+{
+	if (!(dwFlags & AMSTREAMSELECTENABLE_ENABLE)) {
+		return E_NOTIMPL;
+	}
+	if (!m_pin || !m_pin->m_decoder || lIndex < 0 || lIndex >= m_pin->m_decoder->GetSubtrackCount()) {
+		return E_INVALIDARG;
+	}
+	if (lIndex == m_pin->m_decoder->GetCurrentSubtrack()) {
+		return S_OK;
+	}
+
+	return m_pin->SetSubtrack(lIndex);
+}
+
 // ISpecifyPropertyPages
 STDMETHODIMP BassSource::GetPages(CAUUID* pPages)
 {
@@ -519,32 +722,17 @@ STDMETHODIMP_(bool) BassSource::GetActive()
 
 STDMETHODIMP_(void) BassSource::GetSettings(Settings_t& setings)
 {
-	setings = m_Sets;
+	setings = SettingsCache::Get();
 }
 
 STDMETHODIMP_(void) BassSource::SetSettings(const Settings_t setings)
 {
-	m_Sets = setings;
+	SettingsCache::Set(setings);
 }
 
 STDMETHODIMP BassSource::SaveSettings()
 {
-	HKEY key;
-
-	LSTATUS lRes = RegCreateKeyW(HKEY_CURRENT_USER, OPT_REGKEY_BassAudioSource, &key);
-	if (lRes == ERROR_SUCCESS) {
-
-		DWORD dwValue = m_Sets.bMidiEnable;
-		lRes = ::RegSetValueExW(key, OPT_MidiEnable, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
-
-		std::wstring str(m_Sets.sMidiSoundFontDefault);
-		lRes = ::RegSetValueExW(key, OPT_MidiSoundFontDefault, 0, REG_SZ, reinterpret_cast<const BYTE*>(str.c_str()), (DWORD)(str.size() + 1) * sizeof(wchar_t));
-
-		dwValue = m_Sets.bWebmEnable;
-		lRes = ::RegSetValueExW(key, OPT_WebmEnable, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
-
-		RegCloseKey(key);
-	}
+	SettingsCache::Save();
 
 	return S_OK;
 }
@@ -571,6 +759,88 @@ STDMETHODIMP BassSource::GetInfo(std::wstring& str)
 			d->GetChannels(),
 			d->GetFloat() ? L"Float" : L"Int",
 			d->GetBytesPerSample() * 8);
+		if (SettingsCache::Get().bInfoCache) {
+			str += std::format(L"\nInfo cache: {}", d->GetInfoCacheStatusStr());
+		}
+		if (LPCWSTR status = d->GetRenderCacheStatusStr()) {
+			str += std::format(L"\nMIDI render cache: {}", status);
+		}
+
+		PerfInfo_t perf = {};
+		d->GetPerfInfo(perf);
+
+		str += std::format(L"\n\nLoad: {:.1f} ms (init {:.1f}, plugins {:.1f}, cache {:.1f}, open {:.1f}, tags {:.1f})",
+			perf.loadTotalNs / 1e6, perf.loadInitNs / 1e6, perf.loadPluginsNs / 1e6,
+			perf.loadCacheNs / 1e6, perf.loadOpenNs / 1e6, perf.loadTagsNs / 1e6);
+		if (perf.decodeCalls) {
+			str += std::format(L"\nDecode: {} calls, {:.1f} us avg, {:.0f}x realtime",
+				perf.decodeCalls, perf.decodeTimeNs / 1e3 / perf.decodeCalls, perf.realtimeFactor);
+			if (perf.shareStallTimeNs) {
+				str += std::format(L", {:.1f} us avg without the network share waits",
+					(perf.decodeTimeNs - std::min(perf.shareStallTimeNs, perf.decodeTimeNs)) / 1e3 / perf.decodeCalls);
+			}
+			str += L"\nDecode time, us:";
+			for (int i = 0; i < PERF_DECODE_HIST_SIZE; i++) {
+				if (perf.decodeHist[i]) {
+					str += std::format(L" <{}:{}", 1u << i, perf.decodeHist[i]);
+				}
+			}
+		}
+		if (perf.fillBufferCalls) {
+			str += std::format(L"\nFillBuffer: {} calls, {:.1f} us avg, {:.1f} us max",
+				perf.fillBufferCalls, perf.fillBufferTimeNs / 1e3 / perf.fillBufferCalls, perf.fillBufferMaxNs / 1e3);
+			str += std::format(L"\nDelivered: {} KiB, {} samples, {} underruns, {} KiB silence",
+				perf.deliveredBytes / 1024, perf.deliveredSamples, perf.underruns, perf.silenceBytes / 1024);
+		}
+		if (perf.seeks) {
+			str += std::format(L"\nSeeks: {}, {:.1f} ms avg, {:.1f} ms max",
+				perf.seeks, perf.seekTimeNs / 1e6 / perf.seeks, perf.seekMaxNs / 1e6);
+		}
+		if (d->GetIsLiveStream() || perf.netBytes) {
+			str += std::format(L"\nNetwork: {} KiB, {} stalls", perf.netBytes / 1024, perf.netStalls);
+		}
+		if (perf.shareReadAhead) {
+			str += std::format(L"\nNetwork share: {} stalls, {:.1f} ms waited, {:.1f} ms max, latency {:.1f} ms, read-ahead {} x {} KiB",
+				perf.shareStalls, perf.shareStallTimeNs / 1e6, perf.shareStallMaxNs / 1e6, perf.shareLatencyNs / 1e6,
+				perf.shareReadAheadDepth, perf.shareReadAhead / perf.shareReadAheadDepth / 1024);
+		}
+		HttpFileStats_t http;
+		if (d->GetHttpFileStats(http)) {
+			str += std::format(L"\nHTTP: {} KiB from the cache, {} KiB downloaded, {} requests over {} connections",
+				http.cacheBytes / 1024, http.netBytes / 1024, http.requests, http.connections);
+		}
+		if (perf.httpRequests) {
+			str += std::format(L"\nHTTP client: {} new connections, {} TLS resumed, connect {:.1f} ms avg, response {:.1f} ms avg, {:.1f} ms max",
+				perf.httpConnections, perf.httpTlsResumed,
+				perf.httpConnections ? perf.httpConnectTimeNs / 1e6 / perf.httpConnections : 0.0,
+				perf.httpTtfbTimeNs / 1e6 / perf.httpRequests, perf.httpTtfbMaxNs / 1e6);
+		}
+		RecordInfo_t rec;
+		if (GetRecordInfo(rec) == S_OK) {
+			str += std::format(L"\nRecording: {} files, {} KiB written, {} KiB dropped, queue {} KiB (max {}), {:.1f} MiB/s",
+				rec.files, rec.writtenBytes / 1024, rec.droppedBytes / 1024,
+				rec.queuedBytes / 1024, rec.maxQueuedBytes / 1024, rec.writeRate);
+			if (rec.writeErrors) {
+				str += std::format(L", {} write errors", rec.writeErrors);
+			}
+		}
+		if (perf.midiVoices) {
+			str += std::format(L"\nMIDI voices: limit {}, interpolation {}, load {:.0f}%, {} decreases, {} increases",
+				perf.midiVoices, perf.midiQuality, perf.midiLoad * 100, perf.midiDecreases, perf.midiIncreases);
+		}
+		MemInfo_t mem;
+		GetMemUsage(mem);
+		str += std::format(L"\nMemory: {} KiB (resources {}, tags {}, stream buffer {}, SoundFont {}, pin buffers {}), process {} KiB",
+			mem.total / 1024, mem.resources / 1024, mem.tags / 1024, mem.streamBuffer / 1024,
+			mem.soundFont / 1024, mem.pinBuffers / 1024, mem.processTotal / 1024);
+		if (mem.evicted) {
+			str += std::format(L", evicted {} KiB", mem.evicted / 1024);
+		}
+
+#ifdef BASS_ALLOC_TRACKING
+		str += L"\n\n" + AllocTracker::GetReport();
+#endif
+
 		return S_OK;
 	}
 	else {
@@ -578,3 +848,124 @@ STDMETHODIMP BassSource::GetInfo(std::wstring& str)
 		return S_FALSE;
 	}
 }
+
+STDMETHODIMP BassSource::GetPerfInfo(PerfInfo_t& info)
+{
+	if (GetActive() && m_pin && m_pin->m_decoder) {
+		auto& d = m_pin->m_decoder;
+		d->GetPerfInfo(info);
+		return S_OK;
+	}
+
+	info = {};
+	return S_FALSE;
+}
+
+STDMETHODIMP BassSource::GetMemInfo(MemInfo_t& info)
+{
+	GetMemUsage(info);
+
+	return S_OK;
+}
+
+STDMETHODIMP BassSource::StartRecording(LPCWSTR directory)
+{
+	CheckPointer(directory, E_POINTER);
+
+	if (!GetActive() || !m_pin || !m_pin->m_decoder) {
+		return VFW_E_WRONG_STATE;
+	}
+	auto& d = m_pin->m_decoder;
+	if (!d->GetIsUrl()) {
+		// only the received data of network streams is recorded
+		return E_INVALIDARG;
+	}
+	if (d->GetIsHttpFile()) {
+		// a file read with ranged requests is not received in order, the cached ranges are not received at all
+		DLog(L"BassSource::StartRecording() - the stream is read with ranged requests and can not be recorded");
+		return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+	}
+
+	std::wstring dir(directory);
+	const DWORD attrs = GetFileAttributesW(dir.c_str());
+	if (attrs == INVALID_FILE_ATTRIBUTES || !(attrs & FILE_ATTRIBUTE_DIRECTORY)) {
+		return HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND);
+	}
+	if (dir.back() != L'\\' && dir.back() != L'/') {
+		dir += L'\\';
+	}
+
+	std::wstring title;
+	{
+		CAutoLock cAutoLock(m_metaLock);
+		title = m_Tags.Title;
+	}
+
+	std::unique_ptr<StreamRecorder> recorder;
+	try {
+		recorder = std::make_unique<StreamRecorder>(dir, GetBassTypeExt(d->GetBassCType()), title);
+	}
+	catch (...) {
+		DLogError(L"BassSource::StartRecording() - failed to start the recorder");
+		return E_FAIL;
+	}
+
+	std::lock_guard<std::mutex> lock(m_recordMutex);
+	if (m_recorder) {
+		return S_FALSE; // already recording, the new recorder is discarded
+	}
+	m_recorder = std::move(recorder);
+	DLog(L"BassSource::StartRecording() - recording to '{}'", dir);
+
+	return S_OK;
+}
+
+STDMETHODIMP BassSource::StopRecording()
+{
+	std::unique_ptr<StreamRecorder> recorder;
+	{
+		std::lock_guard<std::mutex> lock(m_recordMutex);
+		recorder = std::move(m_recorder);
+	}
+
+	// the last buffers are written outside the lock, the download thread does not wait for them
+	return recorder ? S_OK : S_FALSE;
+}
+
+STDMETHODIMP BassSource::GetRecordInfo(RecordInfo_t& info)
+{
+	info = {};
+
+	RecordStats_t stats;
+	{
+		std::lock_guard<std::mutex> lock(m_recordMutex);
+		if (!m_recorder) {
+			return S_FALSE;
+		}
+		m_recorder->GetStats(stats);
+	}
+
+	info.active         = true;
+	info.files          = stats.files;
+	info.writtenBytes   = stats.writtenBytes;
+	info.droppedBytes   = stats.droppedBytes;
+	info.queuedBytes    = stats.queuedBytes;
+	info.maxQueuedBytes = stats.maxQueuedBytes;
+	info.writeErrors    = stats.writeErrors;
+	if (stats.writeTimeNs) {
+		info.writeRate = stats.writtenBytes * 1e9 / stats.writeTimeNs / (1024 * 1024);
+	}
+
+	return S_OK;
+}
+
+STDMETHODIMP BassSource::GetTraceJson(std::string& json)
+{
+	if (!SettingsCache::Get().bTrace) {
+		json.clear();
+		return S_FALSE;
+	}
+
+	json = Trace::ExportChromeJson();
+	return S_OK;
+}
@@ -22,9 +22,12 @@
 
 #pragma once
 
+#include <mutex>
 #include <qnetwork.h>
 #include "BassSourceStream.h"
 #include "IBassSource.h"
+#include "MemAccount.h"
+#include "StreamRecorder.h"
 
 #define LABEL_BassAudioSource L"Bass Audio Source"
 
@@ -38,6 +41,7 @@ class __declspec(uuid(STR_CLSID_BassAudioSource))
 	, public IAMMediaContent
 	, public IDSMResourceBag
 	, public ISpecifyPropertyPages
+	, public IAMStreamSelect
 	, public IBassSource
 {
 protected:
@@ -47,13 +51,23 @@ protected:
 
 	BassSourceStream* m_pin = nullptr;
 	std::wstring m_filePath;
-	Settings_t m_Sets;
+
+	MemAccount m_memAccount;
+	std::atomic<uint64_t> m_memEvicted = 0;
+
+	// called on the download thread of BASS
+	std::mutex m_recordMutex;
+	std::unique_ptr<StreamRecorder> m_recorder;
 
 	void STDMETHODCALLTYPE OnMetaDataCallback(const ContentTags* tags);
 	void STDMETHODCALLTYPE OnStreamTitleCallback(const wchar_t* title);
 	void STDMETHODCALLTYPE OnResourceDataCallback(std::unique_ptr<std::list<DSMResource>>& pResources);
 	void STDMETHODCALLTYPE OnShoutcastBufferCallback(const void* buffer, DWORD size);
-	void LoadSettings();
+
+	void SplitRecording(const wchar_t* title);
+
+	void GetMemUsage(MemInfo_t& info);
+	void EnforceMemBudget();
 
 	void Init();
 
@@ -101,6 +115,11 @@ public:
 	// ISpecifyPropertyPages
 	STDMETHODIMP GetPages(CAUUID* pPages) override;
 
+	// IAMStreamSelect, the subtracks of a container
+	STDMETHODIMP Count(DWORD* pcStreams) override;
+	STDMETHODIMP Info(long lIndex, AM_MEDIA_TYPE** ppmt, DWORD* pdwFlags, LCID* plcid, DWORD* pdwGroup, WCHAR** ppszName, IUnknown** ppObject, IUnknown** ppUnk) override;
+	STDMETHODIMP Enable(long lIndex, DWORD dwFlags) override;
+
 	// IBassSource
 	STDMETHODIMP_(bool) GetActive() override;
 
@@ -109,6 +128,12 @@ public:
 	STDMETHODIMP SaveSettings() override;
 
 	STDMETHODIMP GetInfo(std::wstring& str) override;
+	STDMETHODIMP GetPerfInfo(PerfInfo_t& info) override;
+	STDMETHODIMP GetTraceJson(std::string& json) override;
+	STDMETHODIMP GetMemInfo(MemInfo_t& info) override;
+	STDMETHODIMP StartRecording(LPCWSTR directory) override;
+	STDMETHODIMP StopRecording() override;
+	STDMETHODIMP GetRecordInfo(RecordInfo_t& info) override;
 };
 
 
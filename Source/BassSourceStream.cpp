@@ -23,6 +23,7 @@
 #include "stdafx.h"
 #include "BassSourceStream.h"
 #include <MMReg.h>
+#include "Trace.h"
 
 //
 // BassSourceStream
@@ -30,7 +31,7 @@
 
 BassSourceStream::BassSourceStream(
 	LPCWSTR objectName, HRESULT& hr, CSource* filter, LPCWSTR name,
-	LPCWSTR filename, ShoutcastEvents* shoutcastEvents, PathType_t pathType, Settings_t& sets
+	LPCWSTR filename, ShoutcastEvents* shoutcastEvents, PathType_t pathType, const Settings_t& sets
 )
 	: CSourceStream(objectName, &hr, filter, name)
 {
@@ -49,6 +50,12 @@ BassSourceStream::BassSourceStream(
 		AM_SEEKING_CanSeekAbsolute | AM_SEEKING_CanGetStopPos | AM_SEEKING_CanGetDuration;
 
 	m_stop = m_decoder->GetDuration();
+	if (m_stop == 0 && m_decoder->IsDurationPending()) {
+		m_durationPending = true;
+		m_stop = PENDING_STOP_TIME;
+		m_duration = 0;
+		return;
+	}
 	// If Duration = 0 then it's most likely a Shoutcast Stream
 	if (m_stop == 0) {
 		m_stop = 50 * (UNITS / MILLISECONDS);
@@ -56,6 +63,26 @@ BassSourceStream::BassSourceStream(
 	m_duration = m_stop;
 }
 
+// must be called with m_lock locked
+void BassSourceStream::UpdateDuration()
+{
+	if (m_decoder->IsDurationPending()) {
+		return;
+	}
+	m_durationPending = false;
+
+	const REFERENCE_TIME duration = m_decoder->GetDuration();
+	if (duration == 0) {
+		return; // the prescan failed
+	}
+
+	m_duration = duration;
+	if (m_stop == PENDING_STOP_TIME) {
+		m_stop = duration;
+	}
+	m_pFilter->NotifyEvent(EC_LENGTH_CHANGED, 0, 0);
+}
+
 BassSourceStream::~BassSourceStream()
 {
 	if (m_decoder) {
@@ -104,6 +131,7 @@ HRESULT BassSourceStream::DecideBufferSize(IMemAllocator* pAlloc, ALLOCATOR_PROP
 			}
 			else {
 				result = S_OK;
+				m_allocatedBytes = (uint64_t)actual.cBuffers * (actual.cbBuffer + actual.cbPrefix);
 			}
 		}
 	}
@@ -119,9 +147,20 @@ HRESULT BassSourceStream::FillBuffer(IMediaSample* pSamp)
 	int received = 0;
 	HRESULT result = S_OK;
 
+	const uint64_t fillStart = GetPerfTimeNs();
+	auto& perf = m_decoder->GetPerfCounters().stream;
+	Trace::Begin(Trace::EV_FillBuffer); // no Trace::Scope, __try does not allow objects with destructors
+#ifdef BASS_ALLOC_TRACKING
+	m_allocCheck.Begin();
+#endif
+	ALLOC_ENTER(SCOPE_FillBuffer, "FillBuffer");
+
 	m_lock->Lock();
 
 	__try {
+		if (m_durationPending) {
+			UpdateDuration();
+		}
 		if (m_mediaTime >= m_stop && !m_decoder->GetIsLiveStream()) {
 			result = S_FALSE;
 		}
@@ -131,9 +170,13 @@ HRESULT BassSourceStream::FillBuffer(IMediaSample* pSamp)
 			received = m_decoder->GetData(buffer, BASS_BLOCK_SIZE);
 
 			if (received <= 0) {
+				// a file has ended, a live stream has no data yet
 				if (m_decoder->GetIsLiveStream()) {
+					perf.underruns.Inc();
+					Trace::Instant(Trace::EV_Underrun);
 					received = BASS_BLOCK_SIZE;
 					memset(buffer, 0, BASS_BLOCK_SIZE);
+					perf.silenceBytes.Add(BASS_BLOCK_SIZE);
 				}
 				else {
 					result = S_FALSE;
@@ -161,6 +204,9 @@ HRESULT BassSourceStream::FillBuffer(IMediaSample* pSamp)
 				pSamp->SetDiscontinuity(true);
 				m_discontinuity = false;
 			}
+
+			perf.deliveredBytes.Add(received);
+			perf.deliveredSamples.Add(received / (m_decoder->GetChannels() * m_decoder->GetBytesPerSample()));
 		}
 
 	}
@@ -168,6 +214,16 @@ HRESULT BassSourceStream::FillBuffer(IMediaSample* pSamp)
 		m_lock->Unlock();
 	}
 
+	ALLOC_LEAVE();
+#ifdef BASS_ALLOC_TRACKING
+	m_allocCheck.End();
+#endif
+	Trace::End(Trace::EV_FillBuffer, (received > 0) ? received : 0);
+	const uint64_t fillTime = GetPerfTimeNs() - fillStart;
+	perf.fillBufferCalls.Inc();
+	perf.fillBufferTimeNs.Add(fillTime);
+	perf.fillBufferMaxNs.Max(fillTime);
+
 	return result;
 }
 
@@ -238,6 +294,9 @@ HRESULT BassSourceStream::GetMediaType(CMediaType* pMediaType)
 HRESULT BassSourceStream::OnThreadStartPlay()
 {
 	m_discontinuity = true;
+#ifdef BASS_ALLOC_TRACKING
+	m_allocCheck.Restart();
+#endif
 
 	return DeliverNewSegment(m_start, m_stop, m_rateSeeking);
 }
@@ -283,16 +342,61 @@ HRESULT BassSourceStream::ChangeRate()
 
 void BassSourceStream::UpdateFromSeek()
 {
+	const uint64_t seekStart = GetPerfTimeNs();
+	Trace::Scope trace(Trace::EV_Seek);
+	ALLOC_SCOPE(SCOPE_Seek, "UpdateFromSeek");
+
 	if (ThreadExists()) {
+		Trace::Begin(Trace::EV_Flush);
 		DeliverBeginFlush();
 		Stop();
 		m_decoder->SetPosition(m_start);
 		DeliverEndFlush();
+		Trace::End(Trace::EV_Flush);
 		Run();
 	}
 	else {
 		m_decoder->SetPosition(m_start);
 	}
+
+	m_decoder->GetPerfCounters().AddSeek(GetPerfTimeNs() - seekStart);
+}
+
+HRESULT BassSourceStream::SetSubtrack(int index)
+{
+	bool ok;
+
+	if (ThreadExists()) {
+		DeliverBeginFlush();
+		Stop();
+		ok = m_decoder->SetSubtrack(index);
+		DeliverEndFlush();
+	}
+	else {
+		ok = m_decoder->SetSubtrack(index);
+	}
+
+	if (ok) {
+		CAutoLock cAutoLock(m_lock);
+
+		m_duration = m_decoder->GetDuration();
+		m_start = 0;
+		m_stop = m_duration ? m_duration : PENDING_STOP_TIME;
+		m_sampleTime = 0;
+		m_mediaTime = 0;
+		m_durationPending = false;
+	}
+
+	if (ThreadExists()) {
+		Run();
+	}
+
+	if (!ok) {
+		return E_FAIL;
+	}
+	m_pFilter->NotifyEvent(EC_LENGTH_CHANGED, 0, 0);
+
+	return S_OK;
 }
 
 // IMediaSeeking
@@ -376,6 +480,9 @@ STDMETHODIMP BassSourceStream::GetDuration(LONGLONG* pDuration)
 	m_lock->Lock();
 
 	__try {
+		if (m_durationPending) {
+			UpdateDuration();
+		}
 		*pDuration = m_duration;
 	}
 	__finally {
@@ -23,8 +23,11 @@
 #pragma once
 
 #include "BassDecoder.h"
+#include "AllocTracker.h"
 
 #define BASS_BLOCK_SIZE               2048
+#define ALLOC_WARMUP_BUFFERS          16 // FillBuffer calls after start or seek that may allocate
+#define PENDING_STOP_TIME             (MAXLONGLONG / 4) // stop time while the duration is not known, the stream ends with its data
 
 
 class BassSourceStream : public CSourceStream, public IMediaSeeking
@@ -35,21 +38,27 @@ private:
 	double m_rateSeeking = 1.0;
 	DWORD m_seekingCaps = 0;
 	LONGLONG m_duration = 0;
+	bool m_durationPending = false;
 	REFERENCE_TIME m_start = 0;
 	REFERENCE_TIME m_stop = 0;
 	bool m_discontinuity = false;
 	REFERENCE_TIME m_sampleTime = 0;
 	REFERENCE_TIME m_mediaTime = 0;
 	CCritSec* m_lock = nullptr;
+	uint64_t m_allocatedBytes = 0; // sample buffers of the allocator
+#ifdef BASS_ALLOC_TRACKING
+	AllocTracker::SteadyStateCheck m_allocCheck = { AllocTracker::SCOPE_FillBuffer, ALLOC_WARMUP_BUFFERS };
+#endif
 
 	HRESULT ChangeStart();
 	HRESULT ChangeStop();
 	HRESULT ChangeRate();
 	void UpdateFromSeek();
+	void UpdateDuration();
 
 public:
 	BassSourceStream(LPCWSTR objectName, HRESULT& hr, CSource* filter, LPCWSTR name,
-		LPCWSTR filename, ShoutcastEvents* shoutcastEvents, PathType_t pathType, Settings_t& sets);
+		LPCWSTR filename, ShoutcastEvents* shoutcastEvents, PathType_t pathType, const Settings_t& sets);
 	~BassSourceStream();
 
 	HRESULT GetMediaType(CMediaType* pMediaType);
@@ -58,6 +67,11 @@ public:
 	STDMETHODIMP NonDelegatingQueryInterface(REFIID, void**);
 	HRESULT OnThreadStartPlay();
 
+	inline uint64_t GetAllocatedBytes() { return m_allocatedBytes; }
+
+	// switches the subtrack of a container and restarts the stream from its beginning
+	HRESULT SetSubtrack(int index);
+
 	DECLARE_IUNKNOWN
 	// IMediaSeeking methods
 	STDMETHODIMP GetCapabilities(DWORD* pCapabilities);
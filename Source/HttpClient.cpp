@@ -0,0 +1,340 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include <ShlObj.h>
+#include "HttpClient.h"
+#include "PerfCounters.h"
+#include "Utils/Util.h"
+
+#define HTTP_USER_AGENT       L"BassAudioSource"
+#define HTTP_CONNECT_TIMEOUT  10000 // ms
+#define HTTP_RECEIVE_TIMEOUT  15000 // ms
+#define HTTP_READ_SIZE_MAX    (1024 * 1024)
+
+static bool QueryHeader(HINTERNET request, DWORD info, std::wstring& value)
+{
+	DWORD size = 0;
+	WinHttpQueryHeaders(request, info, WINHTTP_HEADER_NAME_BY_INDEX, WINHTTP_NO_OUTPUT_BUFFER, &size, WINHTTP_NO_HEADER_INDEX);
+	if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || !size) {
+		value.clear();
+		return false;
+	}
+
+	value.resize(size / sizeof(wchar_t));
+	if (!WinHttpQueryHeaders(request, info, WINHTTP_HEADER_NAME_BY_INDEX, value.data(), &size, WINHTTP_NO_HEADER_INDEX)) {
+		value.clear();
+		return false;
+	}
+	value.resize(size / sizeof(wchar_t));
+
+	return true;
+}
+
+static DWORD QueryStatusCode(HINTERNET request)
+{
+	DWORD status = 0;
+	DWORD size = sizeof(status);
+	WinHttpQueryHeaders(request, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+		WINHTTP_HEADER_NAME_BY_INDEX, &status, &size, WINHTTP_NO_HEADER_INDEX);
+	return status;
+}
+
+//
+// connection pool
+//
+
+static std::mutex s_poolMutex;
+static HINTERNET s_session = nullptr;
+static std::map<std::wstring, HINTERNET> s_connects; // by "host:port"
+
+// The session and the connection handles live until the process exits,
+// WinHTTP must not be called while the DLL is unloaded.
+static HINTERNET GetPooledConnect(const std::wstring& host, INTERNET_PORT port)
+{
+	std::lock_guard<std::mutex> lock(s_poolMutex);
+
+	if (!s_session) {
+		// the automatic proxy is not supported before Windows 8.1
+		s_session = WinHttpOpen(HTTP_USER_AGENT, WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY, WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+		if (!s_session) {
+			s_session = WinHttpOpen(HTTP_USER_AGENT, WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+		}
+		if (!s_session) {
+			return nullptr;
+		}
+		WinHttpSetTimeouts(s_session, 0, HTTP_CONNECT_TIMEOUT, HTTP_CONNECT_TIMEOUT, HTTP_RECEIVE_TIMEOUT);
+	}
+
+	const std::wstring key = std::format(L"{}:{}", host, port);
+	auto it = s_connects.find(key);
+	if (it != s_connects.end()) {
+		return it->second;
+	}
+
+	HINTERNET connect = WinHttpConnect(s_session, host.c_str(), port, 0);
+	if (connect) {
+		s_connects.emplace(key, connect);
+	}
+
+	return connect;
+}
+
+//
+// WinHttpStream
+//
+
+class WinHttpStream : public HttpStream
+{
+	const std::shared_ptr<HttpClient> m_client;
+	std::wstring m_ifRange;
+
+	std::mutex m_mutex; // the request is closed by Cancel on another thread
+	HINTERNET m_request = nullptr;
+	bool m_cancelled = false;
+
+	void CloseRequest()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_request) {
+			WinHttpCloseHandle(m_request);
+			m_request = nullptr;
+		}
+	}
+
+public:
+	WinHttpStream(std::shared_ptr<HttpClient> client, const std::wstring& validator)
+		: m_client(std::move(client))
+	{
+		// a weak ETag can not be used with If-Range
+		if (validator.size() && validator.compare(0, 2, L"W/") != 0) {
+			m_ifRange = L"If-Range: " + validator + L"\r\n";
+		}
+	}
+
+	~WinHttpStream()
+	{
+		CloseRequest();
+	}
+
+	bool Open(uint64_t pos, uint64_t end) override
+	{
+		CloseRequest();
+
+		HINTERNET request;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_cancelled) {
+				return false;
+			}
+			request = m_request = m_client->OpenRequest();
+		}
+		if (!request) {
+			return false;
+		}
+
+		const std::wstring headers = std::format(L"Range: bytes={}-{}\r\n{}", pos, end - 1, m_ifRange);
+		if (!m_client->SendRequest(request, headers)) {
+			DLog(L"WinHttpStream::Open() - the request failed, error {}", GetLastError());
+			CloseRequest();
+			return false;
+		}
+
+		// 200 is the whole resource, it can be used only from the start
+		// (and is also the answer to If-Range when the resource has changed)
+		const DWORD status = QueryStatusCode(request);
+		if (status != 206 && !(status == 200 && pos == 0 && m_ifRange.empty())) {
+			DLog(L"WinHttpStream::Open() - unexpected status {}", status);
+			CloseRequest();
+			return false;
+		}
+
+		return true;
+	}
+
+	size_t Read(void* buffer, size_t size) override
+	{
+		HINTERNET request;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			request = m_request;
+		}
+		if (!request) {
+			return 0;
+		}
+
+		DWORD read = 0;
+		if (!WinHttpReadData(request, buffer, (DWORD)std::min<size_t>(size, HTTP_READ_SIZE_MAX), &read)) {
+			DLog(L"WinHttpStream::Read() - failed, error {}", GetLastError());
+			CloseRequest();
+			return 0;
+		}
+
+		return read;
+	}
+
+	void Cancel() override
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_cancelled = true;
+		}
+		// closing the handle makes a blocked WinHttpSendRequest, WinHttpReceiveResponse or WinHttpReadData return
+		CloseRequest();
+	}
+};
+
+//
+// HttpClient
+//
+
+bool HttpClient::Init(const std::wstring& url)
+{
+	URL_COMPONENTS uc = { sizeof(uc) };
+	uc.dwHostNameLength  = (DWORD)-1;
+	uc.dwUrlPathLength   = (DWORD)-1;
+	uc.dwExtraInfoLength = (DWORD)-1;
+	if (!WinHttpCrackUrl(url.c_str(), (DWORD)url.size(), 0, &uc)
+			|| (uc.nScheme != INTERNET_SCHEME_HTTP && uc.nScheme != INTERNET_SCHEME_HTTPS)) {
+		return false;
+	}
+
+	const std::wstring host(uc.lpszHostName, uc.dwHostNameLength);
+	m_path.assign(uc.lpszUrlPath, uc.dwUrlPathLength);
+	m_path.append(uc.lpszExtraInfo, uc.dwExtraInfoLength);
+	m_secure = (uc.nScheme == INTERNET_SCHEME_HTTPS);
+
+	m_connect = GetPooledConnect(host, uc.nPort);
+
+	return m_connect != nullptr;
+}
+
+HINTERNET HttpClient::OpenRequest()
+{
+	return WinHttpOpenRequest(m_connect, L"GET", m_path.c_str(), nullptr,
+		WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, m_secure ? WINHTTP_FLAG_SECURE : 0);
+}
+
+bool HttpClient::SendRequest(HINTERNET request, const std::wstring& headers)
+{
+	// a synchronous send also resolves the name and connects if no pooled connection is idle
+	const uint64_t start = GetPerfTimeNs();
+	if (!WinHttpSendRequest(request, headers.c_str(), (DWORD)headers.size(), WINHTTP_NO_REQUEST_DATA, 0, 0, 0)) {
+		return false;
+	}
+	const uint64_t sent = GetPerfTimeNs();
+	if (!WinHttpReceiveResponse(request, nullptr)) {
+		return false;
+	}
+	const uint64_t ttfb = GetPerfTimeNs() - sent;
+
+	m_requests++;
+	m_ttfbTimeNs += ttfb;
+	uint64_t ttfbMax = m_ttfbMaxNs;
+	while (ttfb > ttfbMax && !m_ttfbMaxNs.compare_exchange_weak(ttfbMax, ttfb)) {
+	}
+
+#ifdef WINHTTP_OPTION_REQUEST_STATS
+	// Windows 10 1903 and later
+	WINHTTP_REQUEST_STATS stats = {};
+	DWORD size = sizeof(stats);
+	if (WinHttpQueryOption(request, WINHTTP_OPTION_REQUEST_STATS, &stats, &size)
+			&& (stats.ullFlags & WINHTTP_REQUEST_STAT_FLAG_FIRST_REQUEST)) {
+		m_connections++;
+		m_connectTimeNs += sent - start;
+		if (stats.ullFlags & WINHTTP_REQUEST_STAT_FLAG_TLS_SESSION_RESUMPTION) {
+			m_tlsResumed++;
+		}
+	}
+#endif
+
+	return true;
+}
+
+std::shared_ptr<HttpClient> HttpClient::Create(const std::wstring& url)
+{
+	auto client = std::make_shared<HttpClient>();
+	if (!client->Init(url)) {
+		return nullptr;
+	}
+	return client;
+}
+
+bool HttpClient::Probe(HttpResourceInfo_t& info)
+{
+	HINTERNET request = OpenRequest();
+	if (!request) {
+		return false;
+	}
+
+	bool ret = false;
+
+	// a live stream (Icecast, SHOUTcast) does not answer with 206
+	if (SendRequest(request, L"Range: bytes=0-0") && QueryStatusCode(request) == 206) {
+		// Content-Range: bytes 0-0/length
+		std::wstring contentRange;
+		if (QueryHeader(request, WINHTTP_QUERY_CONTENT_RANGE, contentRange)) {
+			const size_t slash = contentRange.find(L'/');
+			if (slash != std::wstring::npos) {
+				info.length = wcstoull(contentRange.c_str() + slash + 1, nullptr, 10);
+			}
+		}
+		QueryHeader(request, WINHTTP_QUERY_ETAG, info.etag);
+		QueryHeader(request, WINHTTP_QUERY_LAST_MODIFIED, info.lastModified);
+
+		// read the body, so the connection can be reused
+		char byte;
+		DWORD read = 0;
+		WinHttpReadData(request, &byte, 1, &read);
+
+		ret = info.length > 0;
+	}
+
+	DLog(L"HttpClient::Probe() - {}, length {}, ETag '{}', Last-Modified '{}'",
+		ret ? L"ranges supported" : L"ranges not supported", info.length, info.etag, info.lastModified);
+
+	WinHttpCloseHandle(request);
+
+	return ret;
+}
+
+std::unique_ptr<HttpStream> HttpClient::CreateStream(const std::wstring& validator)
+{
+	return std::make_unique<WinHttpStream>(shared_from_this(), validator);
+}
+
+void HttpClient::GetStats(HttpClientStats_t& stats) const
+{
+	stats.requests      = m_requests;
+	stats.connections   = m_connections;
+	stats.tlsResumed    = m_tlsResumed;
+	stats.connectTimeNs = m_connectTimeNs;
+	stats.ttfbTimeNs    = m_ttfbTimeNs;
+	stats.ttfbMaxNs     = m_ttfbMaxNs;
+}
+
+//
+// range cache
+//
+
+RangeCache* GetHttpRangeCache(uint64_t maxSize)
+{
+	static std::mutex s_mutex;
+	static std::unique_ptr<RangeCache> s_cache;
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	if (!s_cache) {
+		PWSTR pszPath = nullptr;
+		if (SUCCEEDED(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, nullptr, &pszPath))) {
+			s_cache = std::make_unique<RangeCache>(std::wstring(pszPath) + L"\\BassAudioSource\\HttpCache\\", maxSize);
+		}
+		CoTaskMemFree(pszPath);
+	}
+	else {
+		s_cache->SetMaxSize(maxSize);
+	}
+
+	return s_cache.get();
+}
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <winhttp.h>
+#include "HttpFile.h"
+
+//
+// WinHTTP client for remote files that are read through HttpFile.
+// All the clients of the process use one WinHTTP session and one connection handle per server,
+// so the resolved names, the idle keep-alive connections and the TLS sessions are shared
+// by consecutive files and by the filter instances.
+//
+
+struct HttpResourceInfo_t
+{
+	uint64_t length = 0;
+	std::wstring etag;
+	std::wstring lastModified;
+};
+
+struct HttpClientStats_t
+{
+	uint64_t requests;
+	uint64_t connections;   // requests that opened a new connection, the others reused a pooled one
+	uint64_t tlsResumed;    // new connections that resumed a TLS session
+	uint64_t connectTimeNs; // new connections: name resolution, TCP and TLS handshakes and sending the request
+	uint64_t ttfbTimeNs;    // all requests: from the request sent until the response headers
+	uint64_t ttfbMaxNs;
+};
+
+class HttpClient : public std::enable_shared_from_this<HttpClient>
+{
+	HINTERNET m_connect = nullptr; // owned by the pool
+	std::wstring m_path; // path and query of the URL
+	bool m_secure = false;
+
+	std::atomic<uint64_t> m_requests = 0;
+	std::atomic<uint64_t> m_connections = 0;
+	std::atomic<uint64_t> m_tlsResumed = 0;
+	std::atomic<uint64_t> m_connectTimeNs = 0;
+	std::atomic<uint64_t> m_ttfbTimeNs = 0;
+	std::atomic<uint64_t> m_ttfbMaxNs = 0;
+
+	friend class WinHttpStream;
+
+	bool Init(const std::wstring& url);
+	HINTERNET OpenRequest();
+	// sends the request and receives the response headers, updates the statistics
+	bool SendRequest(HINTERNET request, const std::wstring& headers);
+
+public:
+
+	// nullptr if the URL is not a HTTP(S) URL
+	static std::shared_ptr<HttpClient> Create(const std::wstring& url);
+
+	// Requests the first byte of the resource.
+	// Succeeds only if the server supports range requests and reports the length.
+	bool Probe(HttpResourceInfo_t& info);
+
+	// validator - ETag or Last-Modified, a range of a changed resource is not accepted
+	std::unique_ptr<HttpStream> CreateStream(const std::wstring& validator);
+
+	void GetStats(HttpClientStats_t& stats) const;
+};
+
+// process-wide cache in "%LOCALAPPDATA%\BassAudioSource\HttpCache", nullptr if it can not be created
+RangeCache* GetHttpRangeCache(uint64_t maxSize);
@@ -0,0 +1,360 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include "HttpFile.h"
+#include "Utils/Util.h"
+
+#define HTTPFILE_RETRIES    2                 // new requests after a connection is lost
+#define HTTPFILE_CHUNK_SIZE (1024 * 1024)     // range of a parallel request
+#define HTTPFILE_READ_BLOCK (64 * 1024)       // the read position is checked after each block
+#define HTTPFILE_WINDOW     2                 // chunks ahead per connection
+
+HttpFile::HttpFile(const HttpStreamFactory& factory, uint64_t length, std::shared_ptr<RangeCacheEntry> entry, unsigned connections,
+		HttpDownloadCallback onDownload)
+	: m_entry(std::move(entry))
+	, m_length(length)
+	, m_onDownload(std::move(onDownload))
+{
+	connections = std::min(connections, (unsigned)HTTPFILE_MAX_CONNECTIONS);
+
+	if (connections <= 1) {
+		m_stream = factory();
+		return;
+	}
+
+	m_windowSize = connections * HTTPFILE_WINDOW;
+	for (unsigned i = 0; i < connections; i++) {
+		m_fetchStreams.emplace_back(factory());
+	}
+	for (const auto& stream : m_fetchStreams) {
+		m_fetchThreads.emplace_back(&HttpFile::FetchThread, this, stream.get());
+	}
+}
+
+HttpFile::~HttpFile()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_fetchCv.notify_all();
+
+	// a thread that waits for a stalled server would only notice m_stop after the receive timeout
+	for (const auto& stream : m_fetchStreams) {
+		stream->Cancel();
+	}
+	for (auto& thread : m_fetchThreads) {
+		thread.join();
+	}
+}
+
+bool HttpFile::OpenRequest(uint64_t end)
+{
+	m_requests++;
+	m_requestOpen = m_stream->Open(m_pos, end);
+	m_requestPos = m_pos;
+	m_requestEnd = end;
+
+	DLogIf(!m_requestOpen, L"HttpFile: the request for {}-{} failed", m_pos, end);
+
+	return m_requestOpen;
+}
+
+uint64_t HttpFile::GetChunkSize(uint64_t index) const
+{
+	return std::min<uint64_t>(HTTPFILE_CHUNK_SIZE, m_length - index * HTTPFILE_CHUNK_SIZE);
+}
+
+bool HttpFile::IsChunkCached(uint64_t index)
+{
+	return m_entry && m_entry->GetCachedSize(index * HTTPFILE_CHUNK_SIZE) >= GetChunkSize(index);
+}
+
+uint64_t HttpFile::FindChunkToFetch()
+{
+	// the nearest chunks first, the one at the read position is needed now
+	const uint64_t count = (m_length + HTTPFILE_CHUNK_SIZE - 1) / HTTPFILE_CHUNK_SIZE;
+	const uint64_t end = std::min(m_window + m_windowSize, count);
+
+	for (uint64_t index = m_window; index < end; index++) {
+		auto it = m_chunks.find(index);
+		if (it == m_chunks.end()) {
+			if (!IsChunkCached(index)) {
+				return index;
+			}
+		}
+		else {
+			const Chunk& chunk = it->second;
+			if (!chunk.fetching && !chunk.failed && chunk.filled < chunk.data.size()) {
+				return index;
+			}
+		}
+	}
+
+	return UINT64_MAX;
+}
+
+void HttpFile::MoveWindow(uint64_t index)
+{
+	if (index == m_window) {
+		return;
+	}
+	m_window = index;
+	RetryFailedChunks();
+
+	// keep the chunks nearest to the read position, the ones being fetched can not be removed
+	const size_t maxChunks = (size_t)m_windowSize * 2;
+	while (m_chunks.size() > maxChunks) {
+		auto farthest = m_chunks.end();
+		uint64_t farthestDistance = 0;
+		for (auto it = m_chunks.begin(); it != m_chunks.end(); ++it) {
+			const uint64_t distance = it->first >= index ? it->first - index : index - it->first;
+			if (!it->second.fetching && distance >= m_windowSize && distance > farthestDistance) {
+				farthest = it;
+				farthestDistance = distance;
+			}
+		}
+		if (farthest == m_chunks.end()) {
+			break;
+		}
+		m_chunks.erase(farthest);
+	}
+
+	m_fetchCv.notify_all();
+}
+
+void HttpFile::RetryFailedChunks()
+{
+	// the network may be back, a failed chunk is fetched again when the window comes to it
+	for (auto& [index, chunk] : m_chunks) {
+		if (!chunk.fetching) {
+			chunk.failed = false;
+			chunk.failures = 0;
+		}
+	}
+}
+
+void HttpFile::FetchThread(HttpStream* stream)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (!m_stop) {
+		const uint64_t index = FindChunkToFetch();
+		if (index == UINT64_MAX) {
+			m_fetchCv.wait(lock);
+			continue;
+		}
+
+		Chunk& chunk = m_chunks[index]; // the map does not move its elements, a fetched chunk is not removed
+		if (chunk.data.empty()) {
+			chunk.data.resize((size_t)GetChunkSize(index));
+		}
+		chunk.fetching = true;
+		const uint64_t start = index * HTTPFILE_CHUNK_SIZE;
+		const size_t size = chunk.data.size();
+		size_t filled = chunk.filled;
+		bool ok = true;
+		bool abandoned = false;
+
+		lock.unlock();
+
+		m_requests++;
+		if (!stream->Open(start + filled, start + size)) {
+			DLog(L"HttpFile: the request for {}-{} failed", start + filled, start + size);
+			ok = false;
+		}
+		while (ok && filled < size) {
+			const size_t n = stream->Read(chunk.data.data() + filled, std::min<size_t>(size - filled, HTTPFILE_READ_BLOCK));
+			if (!n) {
+				ok = false;
+				break;
+			}
+			filled += n;
+			m_netBytes += n;
+
+			lock.lock();
+			chunk.filled = filled;
+			// after a seek, a chunk that is behind the new window is left for a chunk that is needed now,
+			// the received part is kept and the fetch resumes from it if the chunk is needed again
+			abandoned = m_stop || (filled < size && (index < m_window || index >= m_window + m_windowSize)
+				&& FindChunkToFetch() != UINT64_MAX);
+			lock.unlock();
+			m_dataCv.notify_all();
+
+			if (abandoned) {
+				break;
+			}
+		}
+
+		if (ok && filled == size && m_entry) {
+			m_entry->Write(start, chunk.data.data(), size);
+		}
+
+		lock.lock();
+		chunk.fetching = false;
+		if (!ok && !m_stop && ++chunk.failures > HTTPFILE_RETRIES) {
+			chunk.failed = true;
+		}
+		m_dataCv.notify_all();
+	}
+}
+
+void HttpFile::ReportDownload()
+{
+	// the fetch threads only add to m_netBytes, the callback is called on one thread
+	const uint64_t netBytes = m_netBytes;
+	if (m_onDownload && netBytes > m_reportedNetBytes) {
+		m_onDownload((size_t)(netBytes - m_reportedNetBytes));
+	}
+	m_reportedNetBytes = netBytes;
+}
+
+size_t HttpFile::ReadParallel(void* buffer, size_t size)
+{
+	uint8_t* p = (uint8_t*)buffer;
+	size_t done = 0;
+	bool cacheFailed = false;
+
+	while (done < size) {
+		if (m_entry) {
+			const size_t n = m_entry->Read(m_pos, p + done, size - done);
+			if (n) {
+				done += n;
+				m_pos += n;
+				m_cacheBytes += n;
+				cacheFailed = false;
+				continue;
+			}
+			if (cacheFailed) {
+				break;
+			}
+		}
+
+		const uint64_t index = m_pos / HTTPFILE_CHUNK_SIZE;
+		const size_t offset = (size_t)(m_pos - index * HTTPFILE_CHUNK_SIZE);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		MoveWindow(index);
+
+		size_t n = 0;
+		for (;;) {
+			auto it = m_chunks.find(index);
+			if (it != m_chunks.end()) {
+				const Chunk& chunk = it->second;
+				if (chunk.filled > offset) {
+					n = std::min(chunk.filled - offset, size - done);
+					memcpy(p + done, chunk.data.data() + offset, n);
+					break;
+				}
+				if (chunk.failed) {
+					break;
+				}
+			}
+			else if (IsChunkCached(index)) {
+				break; // the chunk was added to the range cache and removed from memory
+			}
+			m_dataCv.wait(lock);
+		}
+		lock.unlock();
+
+		if (!n) {
+			if (IsChunkCached(index)) {
+				cacheFailed = true; // the read from the cache is tried again once
+				continue;
+			}
+			DLog(L"HttpFile: the chunk {} could not be downloaded", index);
+			break;
+		}
+		done += n;
+		m_pos += n;
+	}
+
+	return done;
+}
+
+size_t HttpFile::Read(void* buffer, size_t size)
+{
+	if (m_pos >= m_length) {
+		return 0;
+	}
+	size = (size_t)std::min<uint64_t>(size, m_length - m_pos);
+
+	if (m_fetchThreads.size()) {
+		const size_t done = ReadParallel(buffer, size);
+		ReportDownload();
+		return done;
+	}
+
+	uint8_t* p = (uint8_t*)buffer;
+	size_t done = 0;
+	int retries = HTTPFILE_RETRIES;
+
+	while (done < size) {
+		if (m_entry) {
+			const size_t n = m_entry->Read(m_pos, p + done, size - done);
+			if (n) {
+				done += n;
+				m_pos += n;
+				m_cacheBytes += n;
+				continue;
+			}
+		}
+
+		// a gap, download it up to the next cached range
+		if (!m_requestOpen || m_requestPos != m_pos || m_requestPos >= m_requestEnd) {
+			const uint64_t end = m_entry ? m_entry->GetNextCached(m_pos) : m_length;
+			if (!OpenRequest(end)) {
+				break;
+			}
+		}
+
+		const size_t n = m_stream->Read(p + done, (size_t)std::min<uint64_t>(size - done, m_requestEnd - m_pos));
+		if (!n) {
+			m_requestOpen = false;
+			if (retries-- > 0) {
+				continue;
+			}
+			break;
+		}
+
+		if (m_entry) {
+			m_entry->Write(m_pos, p + done, n);
+		}
+		done += n;
+		m_pos += n;
+		m_requestPos += n;
+		m_netBytes += n;
+	}
+	ReportDownload();
+
+	return done;
+}
+
+bool HttpFile::Seek(uint64_t pos)
+{
+	if (pos > m_length) {
+		return false;
+	}
+	// the open request is kept, it is used again if the reads return to its position
+	m_pos = pos;
+
+	if (m_fetchThreads.size() && pos < m_length) {
+		// the chunks at the new position are requested before the next read
+		std::lock_guard<std::mutex> lock(m_mutex);
+		RetryFailedChunks();
+		MoveWindow(pos / HTTPFILE_CHUNK_SIZE);
+		m_fetchCv.notify_all();
+	}
+
+	return true;
+}
+
+void HttpFile::GetStats(HttpFileStats_t& stats) const
+{
+	stats.cacheBytes  = m_cacheBytes;
+	stats.netBytes    = m_netBytes;
+	stats.requests    = m_requests;
+	stats.connections = m_fetchThreads.size() ? (unsigned)m_fetchThreads.size() : 1;
+}
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include "RangeCache.h"
+#include "UserFile.h"
+
+// A ranged GET request of a remote resource.
+// Implemented with WinHTTP by the filter (HttpClient) and by a simulated server in the benchmarks.
+class HttpStream
+{
+public:
+	virtual ~HttpStream() = default;
+
+	// starts a request for the bytes [pos, end) of the resource
+	virtual bool Open(uint64_t pos, uint64_t end) = 0;
+	// reads the response body, returns the number of bytes read, 0 at the end of the range or on error
+	virtual size_t Read(void* buffer, size_t size) = 0;
+	// called on another thread, a blocked Open or Read fails and so do the following calls
+	virtual void Cancel() = 0;
+};
+
+// creates a stream with its own connection
+using HttpStreamFactory = std::function<std::unique_ptr<HttpStream>()>;
+
+// called on the reading thread with the number of bytes downloaded since the previous call
+using HttpDownloadCallback = std::function<void(size_t length)>;
+
+#define HTTPFILE_MAX_CONNECTIONS 8
+
+struct HttpFileStats_t {
+	uint64_t cacheBytes; // served from the range cache
+	uint64_t netBytes;   // downloaded
+	uint64_t requests;
+	unsigned connections;
+};
+
+//
+// Remote file that is read through the range cache, only the gaps are downloaded.
+// A request continues while the reads are sequential, a seek into a gap starts a new one
+// that ends at the next cached range.
+//
+// With several connections the file is split into chunks that are fetched in parallel
+// in a read-ahead window that starts at the read position. The chunks are kept in memory
+// (the ones nearest to the read position, so short seeks back do not download again)
+// and are also added to the range cache.
+//
+
+class HttpFile : public UserFile
+{
+	struct Chunk {
+		std::vector<uint8_t> data;
+		size_t filled = 0;     // bytes received, a fetch resumes from here
+		bool fetching = false;
+		bool failed = false;
+		int failures = 0;
+	};
+
+	std::unique_ptr<HttpStream> m_stream;
+	std::shared_ptr<RangeCacheEntry> m_entry; // empty - nothing is cached
+	const uint64_t m_length;
+
+	// parallel fetching
+	std::vector<std::unique_ptr<HttpStream>> m_fetchStreams; // one per thread, cancelled by the destructor
+	std::vector<std::thread> m_fetchThreads;
+	std::mutex m_mutex;
+	std::condition_variable m_fetchCv; // a chunk to fetch, or stop
+	std::condition_variable m_dataCv;  // chunk data received
+	std::map<uint64_t, Chunk> m_chunks; // by chunk index
+	uint64_t m_window = 0;              // chunk of the read position
+	uint64_t m_windowSize = 0;          // chunks fetched ahead
+	bool m_stop = false;
+
+	uint64_t m_pos = 0;
+	bool m_requestOpen = false;
+	uint64_t m_requestPos = 0; // the next byte of the open request
+	uint64_t m_requestEnd = 0;
+
+	std::atomic<uint64_t> m_cacheBytes = 0;
+	std::atomic<uint64_t> m_netBytes = 0;
+	std::atomic<uint64_t> m_requests = 0;
+
+	const HttpDownloadCallback m_onDownload;
+	uint64_t m_reportedNetBytes = 0;
+
+	bool OpenRequest(uint64_t end);
+
+	uint64_t GetChunkSize(uint64_t index) const;
+	bool IsChunkCached(uint64_t index);
+	// the following must be called with m_mutex locked
+	uint64_t FindChunkToFetch();
+	void MoveWindow(uint64_t index);
+	void RetryFailedChunks();
+
+	size_t ReadParallel(void* buffer, size_t size);
+	void FetchThread(HttpStream* stream);
+	void ReportDownload();
+
+public:
+	// connections - 0 or 1 - one request at a time
+	HttpFile(const HttpStreamFactory& factory, uint64_t length, std::shared_ptr<RangeCacheEntry> entry, unsigned connections = 1,
+		HttpDownloadCallback onDownload = nullptr);
+	~HttpFile();
+
+	uint64_t GetLength() override { return m_length; }
+	size_t Read(void* buffer, size_t size) override;
+	bool Seek(uint64_t pos) override;
+
+	void GetStats(HttpFileStats_t& stats) const;
+};
@@ -4,9 +4,24 @@
 
 #pragma once
 
+#define MIDI_SPLIT_MAX_STREAMS 16
+
 struct Settings_t {
 	bool bMidiEnable;
+	bool bMidiPrerender;
+	unsigned nMidiRenderThreads;   // split MIDI rendering, 0 or 1 - one stream
+	bool bMidiAdaptiveVoices;
 	bool bWebmEnable;
+	bool bInfoCache;
+	bool bTrace;
+	unsigned nMemoryBudget;        // MiB per filter instance, 0 - no limit
+	unsigned nProcessMemoryBudget; // MiB for all instances in the process, 0 - no limit
+	bool bMemoryMap;               // local files on fixed drives are read through a memory mapping
+	bool bNetworkReadAhead;        // files on network shares are read ahead of the decoder
+	bool bArchiveFiles;            // members of ZIP archives are played from "archive.zip\member" paths
+	bool bHttpClient;              // remote files that support range requests are read with the own HTTP client
+	unsigned nHttpCacheSize;       // MiB of the byte-range cache of remote files, 0 - disabled
+	unsigned nHttpConnections;     // parallel range requests of a remote file, 0 or 1 - one request
 	std::wstring sMidiSoundFontDefault;
 
 	Settings_t() {
@@ -15,11 +30,109 @@ struct Settings_t {
 
 	void SetDefault() {
 		bMidiEnable = false;
+		bMidiPrerender = false;
+		nMidiRenderThreads = 0;
+		bMidiAdaptiveVoices = false;
 		bWebmEnable = false;
+		bInfoCache = false;
+		bTrace = false;
+		nMemoryBudget = 0;
+		nProcessMemoryBudget = 0;
+		bMemoryMap = false;
+		bNetworkReadAhead = false;
+		bArchiveFiles = false;
+		bHttpClient = false;
+		nHttpCacheSize = 0;
+		nHttpConnections = 0;
 		sMidiSoundFontDefault.clear();
 	}
+
+	bool operator==(const Settings_t&) const = default;
+};
+
+#define PERF_DECODE_HIST_SIZE 16
+
+struct PerfInfo_t {
+	// decoding, BASS_ChannelGetData calls
+	uint64_t decodeCalls;
+	uint64_t decodeTimeNs;
+	uint64_t decodeHist[PERF_DECODE_HIST_SIZE]; // bucket 0: < 1 us, bucket n: [2^(n-1), 2^n) us
+	uint64_t decodedBytes;
+	double   realtimeFactor; // seconds of audio decoded per second of decoding time
+
+	// delivery, FillBuffer calls
+	uint64_t fillBufferCalls;
+	uint64_t fillBufferTimeNs;
+	uint64_t fillBufferMaxNs;
+	uint64_t deliveredBytes;
+	uint64_t deliveredSamples;
+	uint64_t underruns;    // buffers of live streams with no decoded data
+	uint64_t silenceBytes; // silence inserted for live streams
+
+	// seeking
+	uint64_t seeks;
+	uint64_t seekTimeNs;
+	uint64_t seekMaxNs;
+
+	// network streams
+	uint64_t netBytes;
+	uint64_t netStalls;
+
+	// read-ahead of files on network shares, the waits are included in decodeTimeNs
+	uint64_t shareStalls;
+	uint64_t shareStallTimeNs;
+	uint64_t shareStallMaxNs;
+	uint64_t shareLatencyNs;     // smoothed time of a read
+	uint64_t shareReadAhead;     // bytes in the ring, 0 - not used
+	uint64_t shareReadAheadDepth;
+
+	// own HTTP client
+	uint64_t httpRequests;
+	uint64_t httpConnections;   // new connections, the other requests reused pooled ones
+	uint64_t httpTlsResumed;
+	uint64_t httpConnectTimeNs; // new connections: name resolution, TCP and TLS handshakes
+	uint64_t httpTtfbTimeNs;    // time to the response headers
+	uint64_t httpTtfbMaxNs;
+
+	// adaptive MIDI voice limit
+	uint64_t midiVoices;        // current voice limit, 0 - not used
+	uint64_t midiQuality;       // current BASS_ATTRIB_MIDI_SRC
+	double   midiLoad;          // smoothed render time / audio duration
+	uint64_t midiDecreases;
+	uint64_t midiIncreases;
+
+	// load phases
+	uint64_t loadInitNs;    // BASS_Init
+	uint64_t loadPluginsNs; // BASS_PluginLoad
+	uint64_t loadCacheNs;   // info cache read and write
+	uint64_t loadOpenNs;    // stream creation
+	uint64_t loadTagsNs;    // tag reading
+	uint64_t loadTotalNs;   // BassDecoder::Load
+};
+
+struct MemInfo_t {
+	uint64_t resources;    // embedded pictures and other resources
+	uint64_t tags;         // tag strings
+	uint64_t streamBuffer; // BASS download buffer
+	uint64_t soundFont;    // loaded SoundFont samples
+	uint64_t pinBuffers;   // output pin sample buffers
+	uint64_t total;
+	uint64_t processTotal; // all filter instances in the process
+	uint64_t evicted;      // bytes released to stay within the budgets
+};
+
+struct RecordInfo_t {
+	bool     active;
+	uint64_t files;
+	uint64_t writtenBytes;
+	uint64_t droppedBytes;   // the writes did not keep up or failed
+	uint64_t queuedBytes;    // received but not written yet
+	uint64_t maxQueuedBytes;
+	uint64_t writeErrors;
+	double   writeRate;      // MiB/s of the file writes
 };
 
+#ifdef _WIN32
 interface __declspec(uuid("153B5D50-39C6-4251-A135-C6070EC7A3B0"))
 IBassSource : public IUnknown {
 	STDMETHOD_(bool, GetActive()) PURE;
@@ -29,4 +142,19 @@ IBassSource : public IUnknown {
 	STDMETHOD(SaveSettings()) PURE;
 
 	STDMETHOD(GetInfo) (std::wstring& str) PURE;
+
+	STDMETHOD(GetPerfInfo) (PerfInfo_t& info) PURE;
+
+	// events of all filter instances in the Chrome trace event format, see "Trace" option
+	STDMETHOD(GetTraceJson) (std::string& json) PURE;
+
+	STDMETHOD(GetMemInfo) (MemInfo_t& info) PURE;
+
+	// records the received data of a network stream to the directory,
+	// a new file is started on each stream title change.
+	// Streams read with ranged requests (the HTTP client options) return ERROR_NOT_SUPPORTED.
+	STDMETHOD(StartRecording) (LPCWSTR directory) PURE;
+	STDMETHOD(StopRecording) () PURE;
+	STDMETHOD(GetRecordInfo) (RecordInfo_t& info) PURE;
 };
+#endif
@@ -129,7 +129,7 @@ bool ParseID3v2Tag(const BYTE* buf, ID3v2TagInfo& tagInfo, std::list<ID3v2Frame>
 				break;
 			}
 			uint32_t frame_size = (tagInfo.ver == 4) ? readframesize(p) : read4bytes(p);
-			int frame_flags = read2bytes(p);
+			uint32_t frame_flags = read2bytes(p);
 
 			ID3v2Frame frame = { frame_id, frame_flags, p, frame_size };
 			id3v2Frames.emplace_back(frame);
@@ -180,15 +180,36 @@ const uint8_t* DecodeString(const int encoding, const uint8_t* str, const uint8_
 		while ((p+1) < end && *(uint16_t*)p) {
 			p += 2;
 		}
-		wstr.assign((p - str) / 2, '\0');
-		if (bom == 0xfffe) {
-			memcpy(wstr.data(), str, wstr.size() * 2);
+		if constexpr (sizeof(wchar_t) == 2) {
+			wstr.assign((p - str) / 2, '\0');
+			if (bom == 0xfffe) {
+				memcpy(wstr.data(), str, wstr.size() * 2);
+			}
+			else { //if (bom == 0xfeff)
+				auto src = (const uint16_t*)str;
+				auto dst = wstr.data();
+				for (size_t i = 0; i < wstr.size(); i++) {
+					*dst++ = _byteswap_ushort(*src++);
+				}
+			}
 		}
-		else { //if (bom == 0xfeff)
-			auto src = (const wchar_t*)str;
-			auto dst = wstr.data();
-			for (size_t i = 0; i < wstr.size(); i++) {
-				*dst++ = _byteswap_ushort(*src++);
+		else {
+			// 32-bit wchar_t (non-Windows), combine surrogate pairs
+			auto src = (const uint16_t*)str;
+			auto srcEnd = (const uint16_t*)p;
+			auto get = [bom](uint16_t v) { return (bom == 0xfffe) ? v : _byteswap_ushort(v); };
+			wstr.clear();
+			wstr.reserve(srcEnd - src);
+			while (src < srcEnd) {
+				uint32_t cp = get(*src++);
+				if (cp >= 0xD800 && cp <= 0xDBFF && src < srcEnd) {
+					const uint32_t lo = get(*src);
+					if (lo >= 0xDC00 && lo <= 0xDFFF) {
+						cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+						src++;
+					}
+				}
+				wstr.push_back((wchar_t)cp);
 			}
 		}
 		if ((p + 1) < end && *(uint16_t*)p == 0) {
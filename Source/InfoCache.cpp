@@ -0,0 +1,419 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include <ShlObj.h>
+#include "InfoCache.h"
+#include "Utils/Util.h"
+#include "Utils/StringUtil.h"
+#include "Utils/ByteReader.h"
+
+#define INFOCACHE_MAGIC    'CSAB' // "BASC"
+#define INFOCACHE_VERSION  1
+#define INFOCACHE_MAXSIZE  (32 * 1024 * 1024)
+
+// entry layout (little-endian):
+// uint32 magic, uint32 version, uint32 payload size, uint32 payload checksum,
+// uint64 file size, uint64 file mtime,
+// payload: path, ctype, sample rate, channels, bytes per sample, float, duration,
+//          title, author, description, station name, resource count, resources (name, desc, mime, data)
+#define INFOCACHE_HEADER_SIZE (4 * 4 + 8 * 2)
+
+#define SUBTRACKS_MAGIC    'BSAB' // "BASB"
+#define SUBTRACKS_VERSION  1
+#define SUBTRACKS_MAXCOUNT 65536
+
+// subtrack entry layout (little-endian):
+// uint32 magic, uint32 version, uint32 payload size, uint32 payload checksum,
+// uint64 file size, uint64 file mtime,
+// payload: path, subtrack count, subtracks (duration, title)
+
+static uint32_t GetChecksum(const uint8_t* data, const size_t size)
+{
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ data[i]) * 16777619u;
+	}
+	return hash;
+}
+
+static void Write32(std::vector<uint8_t>& buffer, const uint32_t value)
+{
+	buffer.insert(buffer.end(), (const uint8_t*)&value, (const uint8_t*)&value + sizeof(value));
+}
+
+static void Write64(std::vector<uint8_t>& buffer, const uint64_t value)
+{
+	buffer.insert(buffer.end(), (const uint8_t*)&value, (const uint8_t*)&value + sizeof(value));
+}
+
+static void WriteString(std::vector<uint8_t>& buffer, const std::wstring& str)
+{
+	Write32(buffer, (uint32_t)str.size());
+	buffer.insert(buffer.end(), (const uint8_t*)str.data(), (const uint8_t*)(str.data() + str.size()));
+}
+
+static void ReadString(ByteReader& br, std::wstring& str)
+{
+	const uint32_t len = br.Read32Le();
+	if (len > br.GetRemainder() / sizeof(wchar_t)) {
+		br.Skip(br.GetRemainder() + 1); // set error
+		return;
+	}
+	str.assign((const wchar_t*)br.GetPtr(), len);
+	br.Skip(len * sizeof(wchar_t));
+}
+
+bool GetFileKey(const std::wstring_view path, FileKey_t& key)
+{
+	WIN32_FILE_ATTRIBUTE_DATA fad;
+	if (!GetFileAttributesExW(std::wstring(path).c_str(), GetFileExInfoStandard, &fad)
+			|| (fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+		return false;
+	}
+
+	key.path  = path;
+	key.size  = ((uint64_t)fad.nFileSizeHigh << 32) | fad.nFileSizeLow;
+	key.mtime = ((uint64_t)fad.ftLastWriteTime.dwHighDateTime << 32) | fad.ftLastWriteTime.dwLowDateTime;
+
+	return true;
+}
+
+uint64_t GetPathHash(const std::wstring_view path)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (wchar_t ch : path) {
+		if (ch >= 'a' && ch <= 'z') {
+			ch -= 'a' - 'A';
+		}
+		else if (ch == '/') {
+			ch = '\\';
+		}
+		hash = (hash ^ (uint8_t)ch) * 1099511628211ull;
+		hash = (hash ^ (uint8_t)(ch >> 8)) * 1099511628211ull;
+	}
+	return hash;
+}
+
+namespace InfoCache
+{
+	static std::wstring GetEntryPath(const FileKey_t& key, const wchar_t* ext = L"bin")
+	{
+		const std::wstring dir = GetCacheDirectory();
+		if (dir.empty()) {
+			return dir;
+		}
+		return std::format(L"{}{:016x}.{}", dir, GetPathHash(key.path), ext);
+	}
+
+	// writes a unique temporary file, then replaces the entry in one step
+	static bool WriteEntryFile(const std::wstring& entryPath, const std::vector<uint8_t>& buffer)
+	{
+		const std::wstring tmpPath = std::format(L"{}.{}.{}.tmp", entryPath, GetCurrentProcessId(), GetCurrentThreadId());
+
+		HANDLE hFile = CreateFileW(tmpPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		DWORD written = 0;
+		BOOL ok = WriteFile(hFile, buffer.data(), (DWORD)buffer.size(), &written, nullptr);
+		CloseHandle(hFile);
+
+		if (ok && written == buffer.size()) {
+			ok = MoveFileExW(tmpPath.c_str(), entryPath.c_str(), MOVEFILE_REPLACE_EXISTING);
+		}
+		else {
+			ok = FALSE;
+		}
+
+		if (!ok) {
+			DeleteFileW(tmpPath.c_str());
+		}
+
+		return !!ok;
+	}
+
+	static void SetHeaderSizes(std::vector<uint8_t>& buffer)
+	{
+		const uint32_t payloadSize = (uint32_t)(buffer.size() - INFOCACHE_HEADER_SIZE);
+		const uint32_t checksum = GetChecksum(buffer.data() + INFOCACHE_HEADER_SIZE, payloadSize);
+		memcpy(&buffer[8], &payloadSize, sizeof(payloadSize));
+		memcpy(&buffer[12], &checksum, sizeof(checksum));
+	}
+
+	std::wstring GetCacheDirectory()
+	{
+		static const std::wstring cacheDir = []() {
+			std::wstring dir;
+			PWSTR pszPath = nullptr;
+			if (SUCCEEDED(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, nullptr, &pszPath))) {
+				dir.assign(pszPath);
+				dir.append(L"\\BassAudioSource\\InfoCache\\");
+				std::error_code ec;
+				std::filesystem::create_directories(dir, ec);
+				if (ec) {
+					DLog(L"InfoCache: failed to create the cache directory");
+					dir.clear();
+				}
+			}
+			CoTaskMemFree(pszPath);
+			return dir;
+		}();
+
+		return cacheDir;
+	}
+
+	bool Read(const FileKey_t& key, CachedInfo_t& info)
+	{
+		const std::wstring entryPath = GetEntryPath(key);
+		if (entryPath.empty()) {
+			return false;
+		}
+
+		// FILE_SHARE_DELETE allows other processes to replace the entry while we read it
+		HANDLE hFile = CreateFileW(entryPath.c_str(), GENERIC_READ,
+			FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		bool ret = false;
+
+		LARGE_INTEGER fileSize = {};
+		if (GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart > INFOCACHE_HEADER_SIZE && fileSize.QuadPart <= INFOCACHE_MAXSIZE) {
+			HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (hMapping) {
+				const uint8_t* view = (const uint8_t*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+				if (view) {
+					ByteReader br(view);
+					br.SetSize((size_t)fileSize.QuadPart);
+
+					ByteSpan header = br.GetSpan(INFOCACHE_HEADER_SIZE);
+					const uint32_t magic       = header.Read32Le();
+					const uint32_t version     = header.Read32Le();
+					const uint32_t payloadSize = header.Read32Le();
+					const uint32_t checksum    = header.Read32Le();
+					const uint64_t size        = header.Read64Le();
+					const uint64_t mtime       = header.Read64Le();
+
+					if (magic == INFOCACHE_MAGIC && version == INFOCACHE_VERSION
+							&& payloadSize == br.GetRemainder()
+							&& size == key.size && mtime == key.mtime
+							&& checksum == GetChecksum(br.GetPtr(), payloadSize)) {
+
+						std::wstring path;
+						ReadString(br, path);
+
+						if (_wcsicmp(path.c_str(), key.path.c_str()) == 0) {
+							info.ctype          = br.Read32Le();
+							info.sampleRate     = (int)br.Read32Le();
+							info.channels       = (int)br.Read32Le();
+							info.bytesPerSample = (int)br.Read32Le();
+							info.isFloat        = !!br.ReadByte();
+							info.duration       = (REFERENCE_TIME)br.Read64Le();
+
+							ReadString(br, info.tags.Title);
+							ReadString(br, info.tags.AuthorName);
+							ReadString(br, info.tags.Description);
+							ReadString(br, info.tags.StationName);
+
+							info.resources.clear();
+							uint32_t count = br.Read32Le();
+							while (count-- && !br.GetError()) {
+								DSMResource resource;
+								ReadString(br, resource.name);
+								ReadString(br, resource.desc);
+								ReadString(br, resource.mime);
+								const uint32_t len = br.Read32Le();
+								if (len > br.GetRemainder()) {
+									break;
+								}
+								resource.data.resize(len);
+								br.ReadBytes(resource.data.data(), len);
+								info.resources.emplace_back(std::move(resource));
+							}
+
+							ret = !br.GetError() && br.GetRemainder() == 0;
+						}
+					}
+
+					UnmapViewOfFile(view);
+				}
+				CloseHandle(hMapping);
+			}
+		}
+
+		CloseHandle(hFile);
+
+		DLog(L"InfoCache::Read - {} \"{}\"", ret ? L"hit" : L"miss", key.path);
+
+		return ret;
+	}
+
+	bool Write(const FileKey_t& key, const CachedInfo_t& info)
+	{
+		const std::wstring entryPath = GetEntryPath(key);
+		if (entryPath.empty()) {
+			return false;
+		}
+
+		std::vector<uint8_t> buffer;
+		buffer.reserve(4096);
+
+		Write32(buffer, INFOCACHE_MAGIC);
+		Write32(buffer, INFOCACHE_VERSION);
+		Write32(buffer, 0); // payload size
+		Write32(buffer, 0); // checksum
+		Write64(buffer, key.size);
+		Write64(buffer, key.mtime);
+
+		WriteString(buffer, key.path);
+		Write32(buffer, info.ctype);
+		Write32(buffer, (uint32_t)info.sampleRate);
+		Write32(buffer, (uint32_t)info.channels);
+		Write32(buffer, (uint32_t)info.bytesPerSample);
+		buffer.push_back(info.isFloat ? 1 : 0);
+		Write64(buffer, (uint64_t)info.duration);
+
+		WriteString(buffer, info.tags.Title);
+		WriteString(buffer, info.tags.AuthorName);
+		WriteString(buffer, info.tags.Description);
+		WriteString(buffer, info.tags.StationName);
+
+		Write32(buffer, (uint32_t)info.resources.size());
+		for (const auto& resource : info.resources) {
+			WriteString(buffer, resource.name);
+			WriteString(buffer, resource.desc);
+			WriteString(buffer, resource.mime);
+			Write32(buffer, (uint32_t)resource.data.size());
+			buffer.insert(buffer.end(), resource.data.begin(), resource.data.end());
+		}
+
+		if (buffer.size() > INFOCACHE_MAXSIZE) {
+			DLog(L"InfoCache::Write - entry is too large");
+			return false;
+		}
+
+		SetHeaderSizes(buffer);
+		const bool ok = WriteEntryFile(entryPath, buffer);
+
+		DLog(L"InfoCache::Write - {} \"{}\"", ok ? L"done" : L"failed", key.path);
+
+		return ok;
+	}
+
+	void Remove(const FileKey_t& key)
+	{
+		const std::wstring entryPath = GetEntryPath(key);
+		if (entryPath.size()) {
+			DeleteFileW(entryPath.c_str());
+		}
+		const std::wstring subtracksPath = GetEntryPath(key, L"sub");
+		if (subtracksPath.size()) {
+			DeleteFileW(subtracksPath.c_str());
+		}
+	}
+
+	bool ReadSubtracks(const FileKey_t& key, std::vector<Subtrack_t>& subtracks)
+	{
+		const std::wstring entryPath = GetEntryPath(key, L"sub");
+		if (entryPath.empty()) {
+			return false;
+		}
+
+		HANDLE hFile = CreateFileW(entryPath.c_str(), GENERIC_READ,
+			FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		// the index is small, it is read at once
+		std::vector<uint8_t> buffer;
+		LARGE_INTEGER fileSize = {};
+		if (GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart > INFOCACHE_HEADER_SIZE && fileSize.QuadPart <= INFOCACHE_MAXSIZE) {
+			buffer.resize((size_t)fileSize.QuadPart);
+			DWORD read = 0;
+			if (!ReadFile(hFile, buffer.data(), (DWORD)buffer.size(), &read, nullptr) || read != buffer.size()) {
+				buffer.clear();
+			}
+		}
+		CloseHandle(hFile);
+
+		bool ret = false;
+
+		if (buffer.size()) {
+			ByteReader br(buffer.data());
+			br.SetSize(buffer.size());
+
+			ByteSpan header = br.GetSpan(INFOCACHE_HEADER_SIZE);
+			const uint32_t magic       = header.Read32Le();
+			const uint32_t version     = header.Read32Le();
+			const uint32_t payloadSize = header.Read32Le();
+			const uint32_t checksum    = header.Read32Le();
+			const uint64_t size        = header.Read64Le();
+			const uint64_t mtime       = header.Read64Le();
+
+			if (magic == SUBTRACKS_MAGIC && version == SUBTRACKS_VERSION
+					&& payloadSize == br.GetRemainder()
+					&& size == key.size && mtime == key.mtime
+					&& checksum == GetChecksum(br.GetPtr(), payloadSize)) {
+
+				std::wstring path;
+				ReadString(br, path);
+
+				const uint32_t count = br.Read32Le();
+				if (_wcsicmp(path.c_str(), key.path.c_str()) == 0 && count <= SUBTRACKS_MAXCOUNT) {
+					subtracks.resize(count);
+					for (auto& subtrack : subtracks) {
+						subtrack.duration = (REFERENCE_TIME)br.Read64Le();
+						ReadString(br, subtrack.title);
+					}
+
+					ret = !br.GetError() && br.GetRemainder() == 0;
+				}
+			}
+		}
+
+		DLog(L"InfoCache::ReadSubtracks - {} \"{}\"", ret ? L"hit" : L"miss", key.path);
+
+		return ret;
+	}
+
+	bool WriteSubtracks(const FileKey_t& key, const std::vector<Subtrack_t>& subtracks)
+	{
+		const std::wstring entryPath = GetEntryPath(key, L"sub");
+		if (entryPath.empty() || subtracks.size() > SUBTRACKS_MAXCOUNT) {
+			return false;
+		}
+
+		std::vector<uint8_t> buffer;
+		buffer.reserve(1024);
+
+		Write32(buffer, SUBTRACKS_MAGIC);
+		Write32(buffer, SUBTRACKS_VERSION);
+		Write32(buffer, 0); // payload size
+		Write32(buffer, 0); // checksum
+		Write64(buffer, key.size);
+		Write64(buffer, key.mtime);
+
+		WriteString(buffer, key.path);
+		Write32(buffer, (uint32_t)subtracks.size());
+		for (const auto& subtrack : subtracks) {
+			Write64(buffer, (uint64_t)subtrack.duration);
+			WriteString(buffer, subtrack.title);
+		}
+
+		if (buffer.size() > INFOCACHE_MAXSIZE) {
+			return false;
+		}
+
+		SetHeaderSizes(buffer);
+		const bool ok = WriteEntryFile(entryPath, buffer);
+
+		DLog(L"InfoCache::WriteSubtracks - {} \"{}\", {} subtracks", ok ? L"done" : L"failed", key.path, subtracks.size());
+
+		return ok;
+	}
+}
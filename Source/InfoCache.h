@@ -0,0 +1,60 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include "BassHelper.h"
+
+// Identifies a local file version. A cached entry is valid only while
+// the path, the size and the last write time of the file are unchanged.
+struct FileKey_t
+{
+	std::wstring path;
+	uint64_t size  = 0;
+	uint64_t mtime = 0;
+};
+
+bool GetFileKey(const std::wstring_view path, FileKey_t& key);
+
+// 64-bit FNV-1a hash of the case-insensitive path, used for cache file names.
+uint64_t GetPathHash(const std::wstring_view path);
+
+struct CachedInfo_t
+{
+	DWORD ctype        = 0;
+	int sampleRate     = 0;
+	int channels       = 0;
+	int bytesPerSample = 0;
+	bool isFloat       = false;
+	REFERENCE_TIME duration = 0;
+
+	ContentTags tags;
+	std::list<DSMResource> resources;
+};
+
+struct Subtrack_t
+{
+	REFERENCE_TIME duration = 0;
+	std::wstring title;
+};
+
+//
+// Persistent stream info cache.
+// One entry per file is stored in "%LOCALAPPDATA%\BassAudioSource\InfoCache".
+// Entries are read through a memory mapped view and written to a temporary file
+// that atomically replaces the old entry, so several processes can use the cache at the same time.
+//
+
+namespace InfoCache
+{
+	std::wstring GetCacheDirectory();
+
+	bool Read(const FileKey_t& key, CachedInfo_t& info);
+	bool Write(const FileKey_t& key, const CachedInfo_t& info);
+	void Remove(const FileKey_t& key);
+
+	// subtrack index of a container file, a separate entry with the same key
+	bool ReadSubtracks(const FileKey_t& key, std::vector<Subtrack_t>& subtracks);
+	bool WriteSubtracks(const FileKey_t& key, const std::vector<Subtrack_t>& subtracks);
+}
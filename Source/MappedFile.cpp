@@ -0,0 +1,215 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include "MappedFile.h"
+#include "Utils/StringUtil.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+// Windows 8 and later
+struct MemoryRangeEntry_t {
+	PVOID VirtualAddress;
+	SIZE_T NumberOfBytes;
+};
+typedef BOOL(WINAPI* PFN_PrefetchVirtualMemory)(HANDLE hProcess, ULONG_PTR NumberOfEntries, MemoryRangeEntry_t* VirtualAddresses, ULONG Flags);
+
+static const PFN_PrefetchVirtualMemory s_prefetchVirtualMemory =
+	(PFN_PrefetchVirtualMemory)GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "PrefetchVirtualMemory");
+#endif
+
+static size_t GetPageSize()
+{
+#ifdef _WIN32
+	return 4096;
+#else
+	static const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	return pageSize;
+#endif
+}
+
+MappedFile::MappedFile(size_t viewSize)
+	: m_maxViewSize(viewSize ? viewSize : (sizeof(void*) == 8 ? 0 : MAPPEDFILE_VIEW_SIZE))
+	, m_wholeFile(m_maxViewSize == 0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	UnmapView();
+
+#ifdef _WIN32
+	if (m_mapping) {
+		CloseHandle(m_mapping);
+	}
+	if (m_file != INVALID_HANDLE_VALUE) {
+		CloseHandle(m_file);
+	}
+#else
+	if (m_fd >= 0) {
+		close(m_fd);
+	}
+#endif
+}
+
+bool MappedFile::Open(const std::wstring& path)
+{
+#ifdef _WIN32
+	m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size) || size.QuadPart <= 0) {
+		return false;
+	}
+	m_length = size.QuadPart;
+
+	m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_mapping) {
+		return false;
+	}
+#else
+	m_fd = open(ConvertWideToUtf8(path).c_str(), O_RDONLY);
+	if (m_fd < 0) {
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(m_fd, &st) != 0 || st.st_size <= 0) {
+		return false;
+	}
+	m_length = st.st_size;
+	posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+	if (m_wholeFile) {
+		if (m_length > SIZE_MAX || !MapView(0)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool MappedFile::MapView(uint64_t pos)
+{
+	UnmapView();
+
+	// the views start at multiples of the view size, which is a multiple of the allocation granularity
+	const uint64_t start = m_wholeFile ? 0 : pos - pos % m_maxViewSize;
+	const size_t size = (size_t)(m_wholeFile ? m_length : std::min<uint64_t>(m_maxViewSize, m_length - start));
+
+#ifdef _WIN32
+	m_view = (const uint8_t*)MapViewOfFile(m_mapping, FILE_MAP_READ, (DWORD)(start >> 32), (DWORD)start, size);
+#else
+	void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, m_fd, (off_t)start);
+	m_view = (view != MAP_FAILED) ? (const uint8_t*)view : nullptr;
+	if (m_view) {
+		madvise(view, size, MADV_SEQUENTIAL);
+	}
+#endif
+	if (!m_view) {
+		return false;
+	}
+
+	m_viewStart = start;
+	m_viewSize = size;
+	m_prefetchStart = 0;
+	m_prefetchEnd = 0;
+
+	return true;
+}
+
+void MappedFile::UnmapView()
+{
+	if (m_view) {
+#ifdef _WIN32
+		UnmapViewOfFile(m_view);
+#else
+		munmap((void*)m_view, m_viewSize);
+#endif
+		m_view = nullptr;
+	}
+}
+
+void MappedFile::Prefetch(uint64_t pos)
+{
+	const uint64_t viewEnd = m_viewStart + m_viewSize;
+	if (!m_view || pos < m_viewStart || pos >= viewEnd) {
+		return;
+	}
+
+	// sequential reads continue the prefetched block when half of it is left,
+	// after a seek the prefetch starts again at the new position
+	uint64_t start = pos;
+	if (pos >= m_prefetchStart && pos < m_prefetchEnd) {
+		if (m_prefetchEnd - pos > MAPPEDFILE_PREFETCH_SIZE / 2) {
+			return;
+		}
+		start = m_prefetchEnd;
+	}
+	else {
+		m_prefetchStart = pos;
+	}
+	const uint64_t end = std::min(start + MAPPEDFILE_PREFETCH_SIZE, viewEnd);
+	if (start >= end) {
+		return;
+	}
+	m_prefetchEnd = end;
+
+	const size_t pageSize = GetPageSize();
+	const size_t offset = (size_t)(start - m_viewStart) / pageSize * pageSize;
+	uint8_t* address = (uint8_t*)m_view + offset;
+	const size_t size = (size_t)(end - m_viewStart) - offset;
+
+#ifdef _WIN32
+	if (s_prefetchVirtualMemory) {
+		MemoryRangeEntry_t range = { address, size };
+		s_prefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	}
+#else
+	madvise(address, size, MADV_WILLNEED);
+#endif
+}
+
+size_t MappedFile::Read(void* buffer, size_t size)
+{
+	uint8_t* p = (uint8_t*)buffer;
+	size_t done = 0;
+
+	while (done < size && m_pos < m_length) {
+		if (!m_view || m_pos < m_viewStart || m_pos >= m_viewStart + m_viewSize) {
+			if (!MapView(m_pos)) {
+				break;
+			}
+		}
+		Prefetch(m_pos);
+
+		const size_t n = (size_t)std::min<uint64_t>(size - done, m_viewStart + m_viewSize - m_pos);
+		memcpy(p + done, m_view + (m_pos - m_viewStart), n);
+		done += n;
+		m_pos += n;
+	}
+
+	return done;
+}
+
+bool MappedFile::Seek(uint64_t pos)
+{
+	if (pos > m_length) {
+		return false;
+	}
+	m_pos = pos;
+
+	return true;
+}
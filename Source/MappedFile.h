@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include "UserFile.h"
+
+//
+// Local file that is read through a memory mapping.
+// In a 64-bit process the whole file is mapped once and GetData() returns it,
+// so the stream can be created from memory and BASS reads the page cache directly.
+// Otherwise views of MAPPEDFILE_VIEW_SIZE slide along the file and Read() copies from them.
+// The pages ahead of the read position are prefetched in blocks of MAPPEDFILE_PREFETCH_SIZE.
+//
+// A read error of a mapped page is an exception (EXCEPTION_IN_PAGE_ERROR, SIGBUS),
+// so only files on local fixed drives should be mapped.
+//
+
+#define MAPPEDFILE_VIEW_SIZE     (64 * 1024 * 1024)
+#define MAPPEDFILE_PREFETCH_SIZE (4 * 1024 * 1024)
+
+class MappedFile : public UserFile
+{
+#ifdef _WIN32
+	HANDLE m_file = INVALID_HANDLE_VALUE;
+	HANDLE m_mapping = nullptr;
+#else
+	int m_fd = -1;
+#endif
+	const size_t m_maxViewSize;
+	uint64_t m_length = 0;
+	uint64_t m_pos = 0;
+
+	const uint8_t* m_view = nullptr;
+	uint64_t m_viewStart = 0;
+	size_t m_viewSize = 0;
+	bool m_wholeFile = false;
+
+	uint64_t m_prefetchStart = 0; // the pages of [start, end) were prefetched
+	uint64_t m_prefetchEnd = 0;
+
+	bool MapView(uint64_t pos);
+	void UnmapView();
+
+public:
+	// viewSize - size of the sliding views, 0 - the whole file in a 64-bit process
+	MappedFile(size_t viewSize = 0);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::wstring& path);
+
+	uint64_t GetLength() override { return m_length; }
+	size_t Read(void* buffer, size_t size) override;
+	bool Seek(uint64_t pos) override;
+
+	// the whole file, nullptr if it is mapped in views
+	const uint8_t* GetData() const { return m_wholeFile ? m_view : nullptr; }
+
+	// Prefetches the pages after pos if the read position comes near the end of the prefetched block.
+	// Called by Read(), and with the read position of BASS when it reads GetData() directly.
+	void Prefetch(uint64_t pos);
+};
@@ -0,0 +1,35 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <atomic>
+
+//
+// Memory accounted by one filter instance, the sum of all instances
+// is kept for the process-wide budget.
+//
+
+class MemAccount
+{
+	inline static std::atomic<int64_t> s_processTotal = 0;
+	std::atomic<int64_t> m_total = 0;
+
+public:
+	~MemAccount() { Set(0); }
+
+	void Set(uint64_t total)
+	{
+		const int64_t prev = m_total.exchange((int64_t)total);
+		s_processTotal.fetch_add((int64_t)total - prev);
+	}
+
+	uint64_t Get() const { return (uint64_t)m_total.load(); }
+
+	static uint64_t GetProcessTotal()
+	{
+		const int64_t total = s_processTotal.load();
+		return (total > 0) ? (uint64_t)total : 0;
+	}
+};
@@ -0,0 +1,291 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include <ShlObj.h>
+#include "MidiRenderCache.h"
+#include "Utils/Util.h"
+
+#define RENDERCACHE_MAGIC    'RMAB' // "BAMR"
+#define RENDERCACHE_VERSION  2
+#define RENDERCACHE_BLOCK    (64 * 1024)
+#define RENDERCACHE_WAIT_MS  10
+
+// entry layout (little-endian): RenderHeader, PCM data
+struct RenderHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t sampleRate;
+	uint16_t channels;
+	uint8_t  bytesPerSample;
+	uint8_t  isFloat;
+	uint64_t midiSize;
+	uint64_t midiMtime;
+	uint64_t fontSize;
+	uint64_t fontMtime;
+	uint32_t voices;
+	uint32_t srcQuality;
+	uint32_t midiFlags;
+	uint32_t reserved;
+	uint64_t dataSize; // 0 until the rendering is complete
+};
+static_assert(sizeof(RenderHeader) == 72);
+
+static std::wstring GetRenderCacheDirectory()
+{
+	static const std::wstring cacheDir = []() {
+		std::wstring dir;
+		PWSTR pszPath = nullptr;
+		if (SUCCEEDED(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, nullptr, &pszPath))) {
+			dir.assign(pszPath);
+			dir.append(L"\\BassAudioSource\\RenderCache\\");
+			std::error_code ec;
+			std::filesystem::create_directories(dir, ec);
+			if (ec) {
+				DLog(L"MidiRenderCache: failed to create the cache directory");
+				dir.clear();
+			}
+		}
+		CoTaskMemFree(pszPath);
+		return dir;
+	}();
+
+	return cacheDir;
+}
+
+std::unique_ptr<MidiRenderCache> MidiRenderCache::Open(const std::wstring& midiPath, const std::wstring& soundFontPath, HSOUNDFONT soundFont,
+	const RenderFormat_t& format, const RenderSettings_t& settings)
+{
+	FileKey_t midiKey;
+	FileKey_t fontKey;
+	const std::wstring dir = GetRenderCacheDirectory();
+	if (dir.empty() || !GetFileKey(midiPath, midiKey) || !GetFileKey(soundFontPath, fontKey)) {
+		return nullptr;
+	}
+
+	const RenderHeader header = {
+		RENDERCACHE_MAGIC, RENDERCACHE_VERSION,
+		(uint32_t)format.sampleRate, (uint16_t)format.channels, (uint8_t)format.bytesPerSample, (uint8_t)format.isFloat,
+		midiKey.size, midiKey.mtime, fontKey.size, fontKey.mtime,
+		(uint32_t)settings.voices, (uint32_t)settings.srcQuality, settings.midiFlags & RENDERCACHE_MIDI_FLAGS, 0,
+		0
+	};
+
+	uint64_t hash = GetPathHash(midiPath) ^ (GetPathHash(soundFontPath) * 31);
+	hash ^= ((uint64_t)format.sampleRate << 16) ^ ((uint64_t)format.channels << 8) ^ format.bytesPerSample;
+	hash ^= ((uint64_t)header.voices << 32) ^ ((uint64_t)header.srcQuality << 48) ^ ((uint64_t)header.midiFlags << 40);
+
+	std::unique_ptr<MidiRenderCache> cache(new MidiRenderCache(midiPath));
+	cache->m_entryPath = std::format(L"{}{:016x}.pcm", dir, hash);
+
+	// FILE_SHARE_DELETE allows other processes to replace the entry while we read it
+	HANDLE hFile = CreateFileW(cache->m_entryPath.c_str(), GENERIC_READ,
+		FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile != INVALID_HANDLE_VALUE) {
+		RenderHeader cached = {};
+		DWORD read = 0;
+		LARGE_INTEGER fileSize = {};
+		if (ReadFile(hFile, &cached, sizeof(cached), &read, nullptr) && read == sizeof(cached)
+				&& GetFileSizeEx(hFile, &fileSize)
+				&& cached.dataSize && fileSize.QuadPart == (LONGLONG)(sizeof(cached) + cached.dataSize)) {
+			const uint64_t dataSize = cached.dataSize;
+			cached.dataSize = 0;
+			if (memcmp(&cached, &header, sizeof(header)) == 0) {
+				DLog(L"MidiRenderCache: using the rendered '{}'", midiPath);
+				cache->m_hFile = hFile;
+				cache->m_rendered = dataSize;
+				cache->m_complete = true;
+				// updates the last write time that Trim() uses
+				FILETIME ft;
+				GetSystemTimeAsFileTime(&ft);
+				HANDLE hTouch = CreateFileW(cache->m_entryPath.c_str(), FILE_WRITE_ATTRIBUTES,
+					FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (hTouch != INVALID_HANDLE_VALUE) {
+					SetFileTime(hTouch, nullptr, nullptr, &ft);
+					CloseHandle(hTouch);
+				}
+				return cache;
+			}
+		}
+		CloseHandle(hFile);
+	}
+
+	// render into a unique temporary file, it replaces the entry in one step when complete
+	cache->m_tmpPath = std::format(L"{}.{}.{}.tmp", cache->m_entryPath, GetCurrentProcessId(), GetCurrentThreadId());
+
+	HANDLE hWrite = CreateFileW(cache->m_tmpPath.c_str(), GENERIC_WRITE,
+		FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hWrite == INVALID_HANDLE_VALUE) {
+		return nullptr;
+	}
+	cache->m_hFile = CreateFileW(cache->m_tmpPath.c_str(), GENERIC_READ,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (cache->m_hFile == INVALID_HANDLE_VALUE) {
+		CloseHandle(hWrite);
+		DeleteFileW(cache->m_tmpPath.c_str());
+		return nullptr;
+	}
+
+	std::vector<uint8_t> headerData((const uint8_t*)&header, (const uint8_t*)&header + sizeof(header));
+	cache->m_thread = std::thread(&MidiRenderCache::RenderThread, cache.get(), hWrite, soundFont, format, settings, std::move(headerData));
+
+	DLog(L"MidiRenderCache: rendering '{}'", midiPath);
+
+	return cache;
+}
+
+MidiRenderCache::~MidiRenderCache()
+{
+	m_stop = true;
+	if (m_thread.joinable()) {
+		m_thread.join();
+	}
+	if (m_hFile != INVALID_HANDLE_VALUE) {
+		CloseHandle(m_hFile);
+	}
+}
+
+void MidiRenderCache::RenderThread(HANDLE hFile, HSOUNDFONT soundFont, RenderFormat_t format, RenderSettings_t settings, std::vector<uint8_t> header)
+{
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+	DWORD flags = BASS_STREAM_DECODE | BASS_UNICODE | (settings.midiFlags & RENDERCACHE_MIDI_FLAGS);
+	if (format.isFloat) {
+		flags |= BASS_SAMPLE_FLOAT;
+	}
+	if (format.channels == 1) {
+		flags |= BASS_SAMPLE_MONO;
+	}
+
+	HSTREAM stream = BASS_MIDI_StreamCreateFile(FALSE, m_midiPath.c_str(), 0, 0, flags, format.sampleRate);
+
+	bool ok = (stream != 0);
+	if (ok) {
+		// the SoundFont of the stream, the process-wide default can be changed by another decoder during the rendering
+		const BASS_MIDI_FONT sf = { soundFont, -1, 0 };
+		ok = !!BASS_MIDI_StreamSetFonts(stream, &sf, 1);
+		if (settings.voices > 0) {
+			BASS_ChannelSetAttribute(stream, BASS_ATTRIB_MIDI_VOICES, (float)settings.voices);
+		}
+		BASS_ChannelSetAttribute(stream, BASS_ATTRIB_SRC, (float)settings.srcQuality);
+		BASS_MIDI_StreamLoadSamples(stream);
+
+		DWORD written = 0;
+		ok = ok && WriteFile(hFile, header.data(), (DWORD)header.size(), &written, nullptr) && written == header.size();
+
+		std::vector<uint8_t> block(RENDERCACHE_BLOCK);
+		while (ok && !m_stop) {
+			const int ret = BASS_ChannelGetData(stream, block.data(), RENDERCACHE_BLOCK);
+			if (ret <= 0) {
+				break;
+			}
+			ok = WriteFile(hFile, block.data(), ret, &written, nullptr) && written == (DWORD)ret;
+			if (ok) {
+				m_rendered.fetch_add(ret, std::memory_order_release);
+			}
+		}
+		BASS_StreamFree(stream);
+	}
+
+	if (ok && !m_stop) {
+		// a complete entry has the data size in the header
+		const uint64_t dataSize = m_rendered.load();
+		LARGE_INTEGER pos = { .QuadPart = offsetof(RenderHeader, dataSize) };
+		DWORD written = 0;
+		ok = SetFilePointerEx(hFile, pos, nullptr, FILE_BEGIN)
+			&& WriteFile(hFile, &dataSize, sizeof(dataSize), &written, nullptr) && written == sizeof(dataSize);
+	}
+	CloseHandle(hFile);
+
+	if (ok && !m_stop && MoveFileExW(m_tmpPath.c_str(), m_entryPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+		DLog(L"MidiRenderCache: rendered '{}', {} KiB", m_midiPath, m_rendered.load() / 1024);
+		m_complete.store(true, std::memory_order_release);
+		Trim();
+	}
+	else {
+		DLogIf(!m_stop, L"MidiRenderCache: rendering '{}' failed", m_midiPath);
+		DeleteFileW(m_tmpPath.c_str());
+		if (!m_stop) {
+			m_failed.store(true, std::memory_order_release);
+		}
+	}
+}
+
+bool MidiRenderCache::Seek(uint64_t pos)
+{
+	if (m_failed || (!m_complete && pos > m_rendered)) {
+		return false;
+	}
+
+	m_position = m_complete ? std::min(pos, m_rendered.load()) : pos;
+
+	return true;
+}
+
+int MidiRenderCache::Read(void* buffer, int size)
+{
+	// the rendering runs ahead of the playback, usually this does not wait
+	while (!m_complete.load(std::memory_order_acquire) && m_rendered.load(std::memory_order_acquire) < m_position + size) {
+		if (m_failed.load(std::memory_order_acquire)) {
+			return -1;
+		}
+		Sleep(RENDERCACHE_WAIT_MS);
+	}
+
+	const uint64_t rendered = m_rendered.load(std::memory_order_acquire);
+	if (m_position >= rendered) {
+		return 0;
+	}
+	const DWORD toRead = (DWORD)std::min<uint64_t>(size, rendered - m_position);
+
+	OVERLAPPED ov = {};
+	const uint64_t offset = sizeof(RenderHeader) + m_position;
+	ov.Offset     = (DWORD)offset;
+	ov.OffsetHigh = (DWORD)(offset >> 32);
+
+	DWORD read = 0;
+	if (!ReadFile(m_hFile, buffer, toRead, &read, &ov)) {
+		return -1;
+	}
+	m_position += read;
+
+	return (int)read;
+}
+
+void MidiRenderCache::Trim()
+{
+	const std::wstring dir = GetRenderCacheDirectory();
+	if (dir.empty()) {
+		return;
+	}
+
+	struct Entry {
+		std::filesystem::path path;
+		std::filesystem::file_time_type time;
+		uint64_t size;
+	};
+	std::vector<Entry> entries;
+	uint64_t total = 0;
+
+	std::error_code ec;
+	for (const auto& item : std::filesystem::directory_iterator(dir, ec)) {
+		if (item.is_regular_file(ec) && item.path().extension() == L".pcm") {
+			const uint64_t size = item.file_size(ec);
+			entries.push_back({ item.path(), item.last_write_time(ec), size });
+			total += size;
+		}
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+
+	for (const auto& entry : entries) {
+		if (total <= RENDERCACHE_MAXSIZE) {
+			break;
+		}
+		// an entry that is being read by another instance is removed when it is closed
+		if (std::filesystem::remove(entry.path, ec)) {
+			total -= entry.size;
+		}
+	}
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <../Include/bass.h>
+#include <../Include/bassmidi.h>
+#include "InfoCache.h"
+
+#define RENDERCACHE_MAXSIZE (2ull << 30) // bytes
+
+// the stream flags that change the rendered sound
+#define RENDERCACHE_MIDI_FLAGS (BASS_MIDI_NOSYSRESET | BASS_MIDI_DECAYEND | BASS_MIDI_NOFX | BASS_MIDI_NOCROP | BASS_MIDI_SINCINTER)
+
+struct RenderFormat_t
+{
+	int sampleRate     = 0;
+	int channels       = 0;
+	int bytesPerSample = 0;
+	bool isFloat       = false;
+};
+
+// the settings of the live stream, the render stream uses the same
+struct RenderSettings_t
+{
+	int voices      = 0; // BASS_ATTRIB_MIDI_VOICES
+	int srcQuality  = 0; // BASS_ATTRIB_SRC
+	DWORD midiFlags = 0; // RENDERCACHE_MIDI_FLAGS
+};
+
+//
+// Pre-rendered PCM of a MIDI file.
+// A worker thread renders the MIDI file with its own BASSMIDI stream faster than real time
+// into "%LOCALAPPDATA%\BassAudioSource\RenderCache", the pin reads the rendered data
+// while the rendering continues ahead of the playback position.
+// A complete entry is keyed by the MIDI file, the SoundFont, the output format and the render settings
+// and is played without rendering next time.
+//
+
+class MidiRenderCache
+{
+	const std::wstring m_midiPath;
+	std::wstring m_entryPath;
+	std::wstring m_tmpPath;
+	HANDLE m_hFile = INVALID_HANDLE_VALUE; // read handle
+
+	uint64_t m_position = 0; // bytes
+	std::atomic<uint64_t> m_rendered = 0;
+	std::atomic<bool> m_complete = false;
+	std::atomic<bool> m_failed = false;
+	std::atomic<bool> m_stop = false;
+	std::thread m_thread;
+
+	MidiRenderCache(const std::wstring& midiPath) : m_midiPath(midiPath) {}
+
+	void RenderThread(HANDLE hFile, HSOUNDFONT soundFont, RenderFormat_t format, RenderSettings_t settings, std::vector<uint8_t> header);
+
+public:
+	// Opens a complete entry or starts the rendering, returns nullptr if neither is possible.
+	// soundFont - the loaded soundFontPath, it must stay loaded until the cache is destroyed
+	static std::unique_ptr<MidiRenderCache> Open(const std::wstring& midiPath, const std::wstring& soundFontPath, HSOUNDFONT soundFont,
+		const RenderFormat_t& format, const RenderSettings_t& settings);
+	// stops the rendering, an incomplete entry is deleted
+	~MidiRenderCache();
+
+	inline bool IsComplete() { return m_complete; }
+	inline bool IsFailed()   { return m_failed; }
+	inline uint64_t GetPosition() { return m_position; }
+
+	// returns false if the position is not rendered yet or the rendering failed, the caller must use the live stream
+	bool Seek(uint64_t pos);
+
+	// waits for the rendering if needed, returns 0 at the end and -1 if the rendering failed
+	int Read(void* buffer, int size);
+
+	// removes the oldest entries when the cache is larger than RENDERCACHE_MAXSIZE
+	static void Trim();
+};
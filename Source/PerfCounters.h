@@ -0,0 +1,160 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include "IBassSource.h"
+
+inline uint64_t GetPerfTimeNs()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Counter with a single writer thread. Increments are a relaxed load and store
+// without a locked instruction, readers on other threads see a recent value.
+class PerfValue
+{
+	std::atomic<uint64_t> m_value = 0;
+
+public:
+	void Add(uint64_t value) { m_value.store(m_value.load(std::memory_order_relaxed) + value, std::memory_order_relaxed); }
+	void Inc()               { Add(1); }
+	void Max(uint64_t value) { if (value > Get()) { m_value.store(value, std::memory_order_relaxed); } }
+	void Set(uint64_t value) { m_value.store(value, std::memory_order_relaxed); }
+	uint64_t Get() const     { return m_value.load(std::memory_order_relaxed); }
+};
+
+//
+// Per-instance performance counters.
+// Each group is written by one thread and is placed in its own cache line.
+//
+
+struct PerfCounters
+{
+	// streaming thread (FillBuffer and BASS_ChannelGetData)
+	struct alignas(64) {
+		PerfValue decodeCalls;
+		PerfValue decodeTimeNs;
+		PerfValue decodeHist[PERF_DECODE_HIST_SIZE];
+		PerfValue decodedBytes;
+
+		PerfValue fillBufferCalls;
+		PerfValue fillBufferTimeNs;
+		PerfValue fillBufferMaxNs;
+		PerfValue deliveredBytes;
+		PerfValue deliveredSamples;
+		PerfValue underruns;
+		PerfValue silenceBytes;
+
+		PerfValue midiVoices;
+		PerfValue midiQuality;
+		PerfValue midiLoadPermille;
+		PerfValue midiDecreases;
+		PerfValue midiIncreases;
+	} stream;
+
+	// application thread (IMediaSeeking)
+	struct alignas(64) {
+		PerfValue seeks;
+		PerfValue seekTimeNs;
+		PerfValue seekMaxNs;
+	} control;
+
+	// BASS download thread
+	struct alignas(64) {
+		PerfValue netBytes;
+		PerfValue netStalls;
+	} network;
+
+	// BassDecoder constructor and Load
+	struct alignas(64) {
+		PerfValue initNs;
+		PerfValue pluginsNs;
+		PerfValue cacheNs;
+		PerfValue openNs;
+		PerfValue tagsNs;
+		PerfValue totalNs;
+	} load;
+
+	void AddDecode(uint64_t timeNs, int bytes)
+	{
+		stream.decodeCalls.Inc();
+		stream.decodeTimeNs.Add(timeNs);
+		// bucket 0: < 1 us, bucket n: [2^(n-1), 2^n) us, the last bucket is open
+		const unsigned bucket = std::min<unsigned>((unsigned)std::bit_width(timeNs / 1000), PERF_DECODE_HIST_SIZE - 1);
+		stream.decodeHist[bucket].Inc();
+		if (bytes > 0) {
+			stream.decodedBytes.Add(bytes);
+		}
+	}
+
+	void AddSeek(uint64_t timeNs)
+	{
+		control.seeks.Inc();
+		control.seekTimeNs.Add(timeNs);
+		control.seekMaxNs.Max(timeNs);
+	}
+
+	void ResetStreaming()
+	{
+		for (auto* value : { &stream.decodeCalls, &stream.decodeTimeNs, &stream.decodedBytes,
+				&stream.fillBufferCalls, &stream.fillBufferTimeNs, &stream.fillBufferMaxNs,
+				&stream.deliveredBytes, &stream.deliveredSamples, &stream.underruns, &stream.silenceBytes,
+				&stream.midiVoices, &stream.midiQuality, &stream.midiLoadPermille, &stream.midiDecreases, &stream.midiIncreases,
+				&control.seeks, &control.seekTimeNs, &control.seekMaxNs,
+				&network.netBytes, &network.netStalls }) {
+			value->Set(0);
+		}
+		for (auto& value : stream.decodeHist) {
+			value.Set(0);
+		}
+	}
+
+	void GetInfo(PerfInfo_t& info, int bytesPerSecond) const
+	{
+		info.decodeCalls  = stream.decodeCalls.Get();
+		info.decodeTimeNs = stream.decodeTimeNs.Get();
+		for (int i = 0; i < PERF_DECODE_HIST_SIZE; i++) {
+			info.decodeHist[i] = stream.decodeHist[i].Get();
+		}
+		info.decodedBytes = stream.decodedBytes.Get();
+
+		info.fillBufferCalls  = stream.fillBufferCalls.Get();
+		info.fillBufferTimeNs = stream.fillBufferTimeNs.Get();
+		info.fillBufferMaxNs  = stream.fillBufferMaxNs.Get();
+		info.deliveredBytes   = stream.deliveredBytes.Get();
+		info.deliveredSamples = stream.deliveredSamples.Get();
+		info.underruns        = stream.underruns.Get();
+		info.silenceBytes     = stream.silenceBytes.Get();
+
+		info.seeks      = control.seeks.Get();
+		info.seekTimeNs = control.seekTimeNs.Get();
+		info.seekMaxNs  = control.seekMaxNs.Get();
+
+		info.midiVoices    = stream.midiVoices.Get();
+		info.midiQuality   = stream.midiQuality.Get();
+		info.midiLoad      = stream.midiLoadPermille.Get() / 1000.0;
+		info.midiDecreases = stream.midiDecreases.Get();
+		info.midiIncreases = stream.midiIncreases.Get();
+
+		info.netBytes  = network.netBytes.Get();
+		info.netStalls = network.netStalls.Get();
+
+		info.loadInitNs    = load.initNs.Get();
+		info.loadPluginsNs = load.pluginsNs.Get();
+		info.loadCacheNs   = load.cacheNs.Get();
+		info.loadOpenNs    = load.openNs.Get();
+		info.loadTagsNs    = load.tagsNs.Get();
+		info.loadTotalNs   = load.totalNs.Get();
+
+		// seconds of audio decoded per second of decoding time
+		info.realtimeFactor = (info.decodeTimeNs && bytesPerSecond)
+			? (double)info.decodedBytes / bytesPerSecond * 1e9 / info.decodeTimeNs
+			: 0.0;
+	}
+};
@@ -8,6 +8,9 @@
 #include "Utils/Util.h"
 #include "Utils/StringUtil.h"
 #include "PropPage.h"
+#include "SoundFontCatalog.h"
+
+#define WM_SOUNDFONT_CATALOG (WM_APP + 1)
 
 void SetCursor(HWND hWnd, LPCWSTR lpCursorName)
 {
@@ -117,33 +120,9 @@ HRESULT CBassMainPPage::OnActivate()
 	GetDlgItem(IDC_COMBO1).EnableWindow(m_SetsPP.bMidiEnable);
 	CheckDlgButton(IDC_CHECK2, m_SetsPP.bWebmEnable ? BST_CHECKED : BST_UNCHECKED);
 
-	const std::wstring filterDir = GetFilterDirectory();
-	std::vector<std::wstring> soundFontFiles;
-	int listPos = -1;
-	for (auto& p : std::filesystem::recursive_directory_iterator(filterDir)) {
-		if (std::filesystem::is_regular_file(p)) {
-			std::wstring ext = p.path().extension();
-			str_tolower(ext);
-			if (ext == L".sf2" || ext == L".sfz") {
-				std::wstring filename = p.path().filename();
-				if (listPos < 0
-					&& filename.length() == m_SetsPP.sMidiSoundFontDefault.length()
-					&& _wcsnicmp(filename.c_str(), m_SetsPP.sMidiSoundFontDefault.c_str(), filename.length()) == 0) {
-					listPos = (int)soundFontFiles.size();
-				}
-				soundFontFiles.emplace_back(filename);
-			}
-		}
-	}
-
-	// add empty line
-	SendDlgItemMessageW(IDC_COMBO1, CB_ADDSTRING, 0, (LPARAM)L"");
-	listPos++;
-
-	for (const auto& sff : soundFontFiles) {
-		SendDlgItemMessageW(IDC_COMBO1, CB_ADDSTRING, 0, (LPARAM)sff.c_str());
-	}
-	SendDlgItemMessageW(IDC_COMBO1, CB_SETCURSEL, listPos, 0);
+	SoundFontCatalog::SetNotifyWindow(m_hWnd, WM_SOUNDFONT_CATALOG);
+	SoundFontCatalog::Start();
+	UpdateSoundFontList();
 
 	// init monospace font
 	LOGFONTW lf = {};
@@ -156,10 +135,9 @@ HRESULT CBassMainPPage::OnActivate()
 
 	GetDlgItem(IDC_EDIT1).SetFont(m_hMonoFont);
 
-	std::wstring strInfo;
-	m_pBassSource->GetInfo(strInfo);
-	str_replace(strInfo, L"\n", L"\r\n");
-	SetDlgItemTextW(IDC_EDIT1, strInfo.c_str());
+	m_pBassSource->GetInfo(m_strInfo);
+	str_replace(m_strInfo, L"\n", L"\r\n");
+	UpdateInfo();
 
 	SetDlgItemTextW(IDC_EDIT3, GetNameAndVersion());
 
@@ -168,6 +146,56 @@ HRESULT CBassMainPPage::OnActivate()
 	return S_OK;
 }
 
+HRESULT CBassMainPPage::OnDeactivate()
+{
+	SoundFontCatalog::SetNotifyWindow(nullptr, 0);
+
+	return S_OK;
+}
+
+void CBassMainPPage::UpdateSoundFontList()
+{
+	SendDlgItemMessageW(IDC_COMBO1, CB_RESETCONTENT, 0, 0);
+
+	// add empty line
+	SendDlgItemMessageW(IDC_COMBO1, CB_ADDSTRING, 0, (LPARAM)L"");
+	int listPos = 0;
+
+	// the catalog is sorted, the list keeps its order
+	m_soundFonts = SoundFontCatalog::GetEntries();
+	for (const auto& entry : *m_soundFonts) {
+		const LRESULT idx = SendDlgItemMessageW(IDC_COMBO1, CB_ADDSTRING, 0, (LPARAM)entry.filename.c_str());
+		if (idx != CB_ERR && listPos == 0
+			&& entry.filename.length() == m_SetsPP.sMidiSoundFontDefault.length()
+			&& _wcsnicmp(entry.filename.c_str(), m_SetsPP.sMidiSoundFontDefault.c_str(), entry.filename.length()) == 0) {
+			listPos = (int)idx;
+		}
+	}
+	SendDlgItemMessageW(IDC_COMBO1, CB_SETCURSEL, listPos, 0);
+}
+
+void CBassMainPPage::UpdateInfo()
+{
+	std::wstring str(m_strInfo);
+
+	const LRESULT idx = SendDlgItemMessageW(IDC_COMBO1, CB_GETCURSEL, 0, 0);
+	if (idx > 0 && m_soundFonts && (size_t)idx <= m_soundFonts->size()) {
+		const SoundFontEntry& entry = (*m_soundFonts)[idx - 1];
+		str.append(L"\r\n\r\nSoundFont: ");
+		if (entry.parsed) {
+			str.append(entry.info.name.size() ? entry.info.name : entry.filename);
+			str += std::format(L"\r\n  version {}.{:02}, {} presets, {} MiB of samples",
+				entry.info.versionMajor, entry.info.versionMinor, entry.info.presets, entry.info.sampleDataSize / (1024 * 1024));
+		}
+		else {
+			str.append(entry.filename);
+		}
+		str += std::format(L"\r\n  {}", entry.path);
+	}
+
+	SetDlgItemTextW(IDC_EDIT1, str.c_str());
+}
+
 INT_PTR CBassMainPPage::OnReceiveMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
 	if (uMsg == WM_COMMAND) {
@@ -193,12 +221,18 @@ INT_PTR CBassMainPPage::OnReceiveMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LP
 				std::wstring str = ComboBox_GetCurItemText(m_hWnd, IDC_COMBO1);
 				if (str != m_SetsPP.sMidiSoundFontDefault) {
 					m_SetsPP.sMidiSoundFontDefault = str;
+					UpdateInfo();
 					SetDirty();
 					return (LRESULT)1;
 				}
 			}
 		}
 	}
+	else if (uMsg == WM_SOUNDFONT_CATALOG) {
+		UpdateSoundFontList();
+		UpdateInfo();
+		return (LRESULT)1;
+	}
 
 	// Let the parent class handle the message.
 	return CBasePropertyPage::OnReceiveMessage(hwnd, uMsg, wParam, lParam);
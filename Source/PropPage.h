@@ -5,6 +5,7 @@
 #pragma once
 
 #include "IBassSource.h"
+#include "SoundFontCatalog.h"
 
 // CBassMainPPage
 
@@ -16,6 +17,9 @@ class __declspec(uuid("D2E835E8-7673-4922-8CEA-5BF963FA56FD"))
 
 	HFONT m_hMonoFont = nullptr;
 
+	std::wstring m_strInfo;
+	std::shared_ptr<const std::vector<SoundFontEntry>> m_soundFonts; // the entries in IDC_COMBO1 after the empty line
+
 public:
 	CBassMainPPage(LPUNKNOWN lpunk, HRESULT* phr);
 	~CBassMainPPage();
@@ -24,6 +28,9 @@ private:
 	HRESULT OnConnect(IUnknown* pUnknown) override;
 	HRESULT OnDisconnect() override;
 	HRESULT OnActivate() override;
+	HRESULT OnDeactivate() override;
+	void UpdateSoundFontList();
+	void UpdateInfo();
 	void SetDirty()
 	{
 		m_bDirty = TRUE;
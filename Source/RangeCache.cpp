@@ -0,0 +1,606 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include "RangeCache.h"
+#include "Utils/ByteReader.h"
+#include "Utils/StringUtil.h"
+#include "Utils/Util.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <winioctl.h>
+#endif
+
+#define RANGECACHE_MAGIC         'RSAB' // "BASR"
+#define RANGECACHE_VERSION       1
+#define RANGECACHE_MAX_RANGES    65536
+#define RANGECACHE_SAVE_INTERVAL (4 * 1024 * 1024) // bytes written between index updates
+#define RANGECACHE_ORPHAN_AGE    std::chrono::hours(1) // files without an index that are not written for longer are removed
+
+// index layout (little-endian):
+// uint32 magic, uint32 version, uint32 payload size, uint32 payload checksum,
+// uint64 resource length, uint64 cached bytes, uint64 last access time,
+// payload: key size, key (UTF-8), range count, ranges (start, end)
+#define RANGECACHE_HEADER_SIZE (4 * 4 + 8 * 3)
+
+static uint32_t GetChecksum(const uint8_t* data, const size_t size)
+{
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ data[i]) * 16777619u;
+	}
+	return hash;
+}
+
+static uint64_t GetKeyHash(const std::string& key)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (const char ch : key) {
+		hash = (hash ^ (uint8_t)ch) * 1099511628211ull;
+	}
+	return hash;
+}
+
+static FILE* OpenFile(const std::wstring& path, const wchar_t* mode)
+{
+#ifdef _WIN32
+	return _wfopen(path.c_str(), mode);
+#else
+	char m[8] = {};
+	for (int i = 0; i < 7 && mode[i]; i++) {
+		m[i] = (char)mode[i];
+	}
+	return fopen(ConvertWideToUtf8(path).c_str(), m);
+#endif
+}
+
+static bool SeekFile(FILE* file, uint64_t pos)
+{
+#ifdef _WIN32
+	return _fseeki64(file, (int64_t)pos, SEEK_SET) == 0;
+#else
+	return fseeko(file, (off_t)pos, SEEK_SET) == 0;
+#endif
+}
+
+static bool IsWrittenBefore(const std::filesystem::directory_entry& item, std::filesystem::file_time_type time)
+{
+	std::error_code ec;
+	const auto lastWrite = item.last_write_time(ec);
+	return !ec && lastWrite < time;
+}
+
+static void AppendLe32(std::vector<uint8_t>& buffer, uint32_t value)
+{
+	for (int i = 0; i < 4; i++) {
+		buffer.push_back((uint8_t)(value >> (i * 8)));
+	}
+}
+
+static void AppendLe64(std::vector<uint8_t>& buffer, uint64_t value)
+{
+	AppendLe32(buffer, (uint32_t)value);
+	AppendLe32(buffer, (uint32_t)(value >> 32));
+}
+
+//
+// RangeSet
+//
+
+void RangeSet::Add(uint64_t start, uint64_t end)
+{
+	if (start >= end) {
+		return;
+	}
+
+	// merge with the overlapping and adjacent ranges
+	auto it = m_ranges.upper_bound(start);
+	if (it != m_ranges.begin()) {
+		auto prev = std::prev(it);
+		if (prev->second >= start) {
+			it = prev;
+		}
+	}
+	while (it != m_ranges.end() && it->first <= end) {
+		start = std::min(start, it->first);
+		end = std::max(end, it->second);
+		m_total -= it->second - it->first;
+		it = m_ranges.erase(it);
+	}
+
+	m_ranges.emplace(start, end);
+	m_total += end - start;
+}
+
+void RangeSet::Clear()
+{
+	m_ranges.clear();
+	m_total = 0;
+}
+
+uint64_t RangeSet::GetEnd(uint64_t pos) const
+{
+	auto it = m_ranges.upper_bound(pos);
+	if (it != m_ranges.begin()) {
+		--it;
+		if (it->second > pos) {
+			return it->second;
+		}
+	}
+	return pos;
+}
+
+uint64_t RangeSet::GetNextStart(uint64_t pos) const
+{
+	auto it = m_ranges.upper_bound(pos);
+	return (it != m_ranges.end()) ? it->first : UINT64_MAX;
+}
+
+uint64_t RangeSet::GetMissing(uint64_t start, uint64_t end) const
+{
+	if (start >= end) {
+		return 0;
+	}
+
+	uint64_t missing = end - start;
+	auto it = m_ranges.upper_bound(start);
+	if (it != m_ranges.begin()) {
+		--it;
+	}
+	for (; it != m_ranges.end() && it->first < end; ++it) {
+		const uint64_t s = std::max(start, it->first);
+		const uint64_t e = std::min(end, it->second);
+		if (s < e) {
+			missing -= e - s;
+		}
+	}
+	return missing;
+}
+
+//
+// RangeCacheEntry
+//
+
+RangeCacheEntry::RangeCacheEntry(RangeCache* cache, uint64_t hash, const std::string& key, uint64_t length)
+	: m_cache(cache)
+	, m_hash(hash)
+	, m_key(key)
+	, m_length(length)
+{
+}
+
+RangeCacheEntry::~RangeCacheEntry()
+{
+	uint64_t total;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_data) {
+			// Load() failed, the entry on disk is not changed
+			return;
+		}
+		SaveIndex(); // also updates the last access time
+		fclose(m_data);
+		m_data = nullptr;
+		total = m_ranges.GetTotal();
+	}
+
+	m_cache->Update(m_hash, total);
+}
+
+bool RangeCacheEntry::Load()
+{
+	const std::wstring indexPath = m_cache->GetEntryPath(m_hash, L"idx");
+	const std::wstring dataPath = m_cache->GetEntryPath(m_hash, L"dat");
+
+	std::vector<uint8_t> buffer;
+	if (FILE* file = OpenFile(indexPath, L"rb")) {
+		uint8_t chunk[4096];
+		size_t n;
+		while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+			buffer.insert(buffer.end(), chunk, chunk + n);
+		}
+		fclose(file);
+	}
+
+	if (buffer.size() > RANGECACHE_HEADER_SIZE) {
+		ByteReader br(buffer.data());
+		br.SetSize(buffer.size());
+
+		ByteSpan header = br.GetSpan(RANGECACHE_HEADER_SIZE);
+		const uint32_t magic       = header.Read32Le();
+		const uint32_t version     = header.Read32Le();
+		const uint32_t payloadSize = header.Read32Le();
+		const uint32_t checksum    = header.Read32Le();
+		const uint64_t length      = header.Read64Le();
+
+		if (magic == RANGECACHE_MAGIC && version == RANGECACHE_VERSION
+				&& payloadSize == br.GetRemainder()
+				&& length == m_length
+				&& checksum == GetChecksum(br.GetPtr(), payloadSize)) {
+			const uint32_t keySize = br.Read32Le();
+			if (keySize == m_key.size() && keySize <= br.GetRemainder()
+					&& memcmp(br.GetPtr(), m_key.data(), keySize) == 0) {
+				br.Skip(keySize);
+				const uint32_t count = br.Read32Le();
+				if (count <= RANGECACHE_MAX_RANGES && count * 16ull == br.GetRemainder()) {
+					for (uint32_t i = 0; i < count; i++) {
+						const uint64_t start = br.Read64Le();
+						const uint64_t end = br.Read64Le();
+						if (start < end && end <= m_length) {
+							m_ranges.Add(start, end);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// another process may use the data file, it is never truncated. Without an index
+	// its content is not used, the ranges that are written again have the same data.
+	m_data = OpenFile(dataPath, L"r+b");
+	if (!m_data) {
+		m_ranges.Clear();
+
+		m_data = OpenFile(dataPath, L"w+bx");
+		if (m_data) {
+#ifdef _WIN32
+			// the gaps between the ranges do not take disk space and are not filled with zeros
+			DWORD bytes = 0;
+			DeviceIoControl((HANDLE)_get_osfhandle(_fileno(m_data)), FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &bytes, nullptr);
+#endif
+		}
+		else {
+			// created by another process after the first attempt
+			m_data = OpenFile(dataPath, L"r+b");
+		}
+		if (!m_data) {
+			DLogError(L"RangeCache: failed to create a data file");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool RangeCacheEntry::SaveIndex()
+{
+	if (fflush(m_data) != 0) {
+		return false;
+	}
+
+	std::vector<uint8_t> buffer;
+	buffer.reserve(RANGECACHE_HEADER_SIZE + 8 + m_key.size() + m_ranges.GetRanges().size() * 16);
+	AppendLe32(buffer, RANGECACHE_MAGIC);
+	AppendLe32(buffer, RANGECACHE_VERSION);
+	AppendLe32(buffer, 0); // payload size
+	AppendLe32(buffer, 0); // checksum
+	AppendLe64(buffer, m_length);
+	AppendLe64(buffer, m_ranges.GetTotal());
+	AppendLe64(buffer, (uint64_t)std::time(nullptr));
+
+	AppendLe32(buffer, (uint32_t)m_key.size());
+	buffer.insert(buffer.end(), m_key.begin(), m_key.end());
+	const auto& ranges = m_ranges.GetRanges();
+	const uint32_t count = (uint32_t)std::min(ranges.size(), (size_t)RANGECACHE_MAX_RANGES);
+	AppendLe32(buffer, count);
+	auto it = ranges.begin();
+	for (uint32_t i = 0; i < count; i++, ++it) {
+		AppendLe64(buffer, it->first);
+		AppendLe64(buffer, it->second);
+	}
+
+	const uint32_t payloadSize = (uint32_t)(buffer.size() - RANGECACHE_HEADER_SIZE);
+	const uint32_t checksum = GetChecksum(buffer.data() + RANGECACHE_HEADER_SIZE, payloadSize);
+	memcpy(&buffer[8], &payloadSize, sizeof(payloadSize));
+	memcpy(&buffer[12], &checksum, sizeof(checksum));
+
+	// other processes see the old or the new index, never a partial one
+	const std::wstring indexPath = m_cache->GetEntryPath(m_hash, L"idx");
+	const std::wstring tmpPath = indexPath + L".tmp";
+
+	FILE* file = OpenFile(tmpPath, L"wb");
+	if (!file) {
+		return false;
+	}
+	bool ok = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+	ok = (fclose(file) == 0) && ok;
+
+	std::error_code ec;
+	if (ok) {
+		std::filesystem::rename(tmpPath, indexPath, ec);
+		ok = !ec;
+	}
+	if (!ok) {
+		std::filesystem::remove(tmpPath, ec);
+		DLogError(L"RangeCache: failed to save an index");
+	}
+	m_unsavedBytes = 0;
+
+	return ok;
+}
+
+uint64_t RangeCacheEntry::GetCachedSize(uint64_t pos)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_ranges.GetEnd(pos) - pos;
+}
+
+uint64_t RangeCacheEntry::GetNextCached(uint64_t pos)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return std::min(m_ranges.GetNextStart(pos), m_length);
+}
+
+uint64_t RangeCacheEntry::GetCachedTotal()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_ranges.GetTotal();
+}
+
+size_t RangeCacheEntry::Read(uint64_t pos, void* buffer, size_t size)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const size_t n = (size_t)std::min<uint64_t>(size, m_ranges.GetEnd(pos) - pos);
+	if (!n || !m_data || !SeekFile(m_data, pos)) {
+		return 0;
+	}
+	return fread(buffer, 1, n, m_data);
+}
+
+bool RangeCacheEntry::Write(uint64_t pos, const void* data, size_t size)
+{
+	if (pos >= m_length) {
+		return false;
+	}
+	size = (size_t)std::min<uint64_t>(size, m_length - pos);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_full || !m_data) {
+		return false;
+	}
+
+	const uint64_t missing = m_ranges.GetMissing(pos, pos + size);
+	if (!missing) {
+		return true;
+	}
+	if (!m_cache->Reserve(m_hash, missing)) {
+		m_full = true;
+		DLog(L"RangeCache: the cache is full");
+		return false;
+	}
+
+	if (!SeekFile(m_data, pos) || fwrite(data, 1, size, m_data) != size) {
+		// the reservation is corrected when the entry is closed
+		m_full = true;
+		DLogError(L"RangeCache: failed to write the data file");
+		return false;
+	}
+
+	m_ranges.Add(pos, pos + size);
+	m_unsavedBytes += size;
+	if (m_unsavedBytes >= RANGECACHE_SAVE_INTERVAL) {
+		SaveIndex();
+	}
+
+	return true;
+}
+
+//
+// RangeCache
+//
+
+RangeCache::RangeCache(const std::wstring& directory, uint64_t maxSize)
+	: m_directory(directory)
+	, m_maxSize(maxSize)
+{
+}
+
+std::wstring RangeCache::GetEntryPath(uint64_t hash, const wchar_t* ext) const
+{
+	wchar_t name[32];
+	swprintf(name, std::size(name), L"%016llx.%ls", (unsigned long long)hash, ext);
+	return m_directory + name;
+}
+
+void RangeCache::Scan()
+{
+	m_scanned = true;
+
+	std::error_code ec;
+	std::filesystem::create_directories(m_directory, ec);
+
+	// another process may be writing a temporary index or a data file whose index is not saved yet,
+	// only the files that were not written for a while are left over
+	const auto orphanTime = std::filesystem::file_time_type::clock::now() - RANGECACHE_ORPHAN_AGE;
+
+	std::vector<std::filesystem::path> orphans;
+	for (const auto& item : std::filesystem::directory_iterator(m_directory, ec)) {
+		const auto& path = item.path();
+		const auto ext = path.extension();
+		if (ext == ".tmp") {
+			if (IsWrittenBefore(item, orphanTime)) {
+				orphans.push_back(path);
+			}
+			continue;
+		}
+		if (ext != ".idx") {
+			continue;
+		}
+
+		uint8_t header[RANGECACHE_HEADER_SIZE];
+		size_t n = 0;
+		if (FILE* file = OpenFile(path.wstring(), L"rb")) {
+			n = fread(header, 1, sizeof(header), file);
+			fclose(file);
+		}
+		ByteReader br(header);
+		br.SetSize(n);
+		const uint32_t magic   = br.Read32Le();
+		const uint32_t version = br.Read32Le();
+		br.Skip(8 + 8); // payload size, checksum, length
+		const uint64_t size       = br.Read64Le();
+		const uint64_t lastAccess = br.Read64Le();
+
+		const uint64_t hash = wcstoull(path.stem().wstring().c_str(), nullptr, 16);
+		if (n == sizeof(header) && magic == RANGECACHE_MAGIC && version == RANGECACHE_VERSION && hash) {
+			m_index[hash] = { size, lastAccess };
+			m_totalSize += size;
+		}
+		else {
+			orphans.push_back(path);
+		}
+	}
+
+	// data files without an index
+	for (const auto& item : std::filesystem::directory_iterator(m_directory, ec)) {
+		const auto& path = item.path();
+		if (path.extension() == ".dat" && !m_index.count(wcstoull(path.stem().wstring().c_str(), nullptr, 16))
+				&& IsWrittenBefore(item, orphanTime)) {
+			orphans.push_back(path);
+		}
+	}
+	for (const auto& path : orphans) {
+		std::filesystem::remove(path, ec);
+	}
+
+	DLog(L"RangeCache: {} entries, {} KiB", m_index.size(), m_totalSize / 1024);
+}
+
+bool RangeCache::RemoveEntry(uint64_t hash)
+{
+	// the data file may be open in another process, then the entry keeps its size
+	std::error_code ec;
+	std::filesystem::remove(GetEntryPath(hash, L"dat"), ec);
+	if (ec) {
+		DLog(L"RangeCache: failed to remove a data file");
+		return false;
+	}
+	// an index without the data file is not used by Load()
+	std::filesystem::remove(GetEntryPath(hash, L"idx"), ec);
+
+	auto it = m_index.find(hash);
+	if (it != m_index.end()) {
+		m_totalSize -= std::min(m_totalSize, it->second.size);
+		m_index.erase(it);
+	}
+	m_evicted++;
+
+	return true;
+}
+
+bool RangeCache::Reserve(uint64_t hash, uint64_t size)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::vector<uint64_t> failed; // entries that could not be removed
+	while (m_totalSize + size > m_maxSize) {
+		// the least recently used entry that is not open
+		auto lru = m_index.end();
+		for (auto it = m_index.begin(); it != m_index.end(); ++it) {
+			if (it->first == hash || std::find(failed.begin(), failed.end(), it->first) != failed.end()) {
+				continue;
+			}
+			auto open = m_open.find(it->first);
+			if (open != m_open.end() && !open->second.expired()) {
+				continue;
+			}
+			if (lru == m_index.end() || it->second.lastAccess < lru->second.lastAccess) {
+				lru = it;
+			}
+		}
+		if (lru == m_index.end()) {
+			return false;
+		}
+		if (!RemoveEntry(lru->first)) {
+			failed.push_back(lru->first);
+		}
+	}
+
+	auto& info = m_index[hash];
+	info.size += size;
+	info.lastAccess = (uint64_t)std::time(nullptr);
+	m_totalSize += size;
+
+	return true;
+}
+
+void RangeCache::Update(uint64_t hash, uint64_t size)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto& info = m_index[hash];
+	m_totalSize = m_totalSize - std::min(m_totalSize, info.size) + size;
+	info.size = size;
+	info.lastAccess = (uint64_t)std::time(nullptr);
+
+	auto it = m_open.find(hash);
+	if (it != m_open.end() && it->second.expired()) {
+		m_open.erase(it);
+	}
+}
+
+void RangeCache::SetMaxSize(uint64_t maxSize)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_maxSize = maxSize;
+}
+
+std::shared_ptr<RangeCacheEntry> RangeCache::Open(const std::wstring& url, const std::wstring& validator, uint64_t length)
+{
+	const std::string key = ConvertWideToUtf8(url + L'\n' + validator);
+	const uint64_t hash = GetKeyHash(key);
+
+	// declared before the lock, the destructor of the last reference locks m_mutex
+	std::shared_ptr<RangeCacheEntry> entry;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (!m_scanned) {
+		Scan();
+	}
+
+	auto it = m_open.find(hash);
+	if (it != m_open.end()) {
+		entry = it->second.lock();
+		if (entry) {
+			// the same resource is played by another filter instance
+			if (entry->m_key == key && entry->m_length == length) {
+				return entry;
+			}
+			return nullptr;
+		}
+	}
+
+	entry = std::make_shared<RangeCacheEntry>(this, hash, key, length);
+	if (!entry->Load()) {
+		return nullptr;
+	}
+
+	auto& info = m_index[hash];
+	const uint64_t total = entry->m_ranges.GetTotal();
+	m_totalSize = m_totalSize - std::min(m_totalSize, info.size) + total;
+	info.size = total;
+	info.lastAccess = (uint64_t)std::time(nullptr);
+	m_open[hash] = entry;
+
+	DLog(L"RangeCache: opened an entry with {} KiB of {} KiB cached", total / 1024, length / 1024);
+
+	return entry;
+}
+
+void RangeCache::GetStats(RangeCacheStats_t& stats)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	stats.entries        = m_index.size();
+	stats.totalBytes     = m_totalSize;
+	stats.maxBytes       = m_maxSize;
+	stats.evictedEntries = m_evicted;
+}
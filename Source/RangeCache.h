@@ -0,0 +1,130 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+//
+// Persistent, size-bounded cache of byte ranges of remote files.
+// An entry is keyed by the URL and the validator of the resource (ETag or Last-Modified),
+// a new version of the resource gets a new entry.
+// Each entry is a data file that holds the downloaded ranges at their offsets
+// and an index file with the list of the ranges, which is replaced atomically,
+// so the index never lists data that was not written.
+// When the total size of the ranges exceeds the limit, the least recently used entries
+// that are not open are removed.
+// Several processes may use the directory, an entry is opened without truncating its data file.
+//
+
+// Sorted set of disjoint half-open byte ranges [start, end).
+class RangeSet
+{
+	std::map<uint64_t, uint64_t> m_ranges; // start -> end
+	uint64_t m_total = 0;
+
+public:
+	void Add(uint64_t start, uint64_t end);
+	void Clear();
+
+	// end of the range that contains pos, pos if pos is not in the set
+	uint64_t GetEnd(uint64_t pos) const;
+	// start of the first range after pos, UINT64_MAX if there is none
+	uint64_t GetNextStart(uint64_t pos) const;
+	// number of bytes of [start, end) that are not in the set
+	uint64_t GetMissing(uint64_t start, uint64_t end) const;
+
+	uint64_t GetTotal() const { return m_total; }
+	const std::map<uint64_t, uint64_t>& GetRanges() const { return m_ranges; }
+};
+
+class RangeCache;
+
+class RangeCacheEntry
+{
+	friend class RangeCache;
+
+	RangeCache* const m_cache;
+	const uint64_t m_hash;
+	const std::string m_key; // UTF-8 URL and validator
+	const uint64_t m_length;
+
+	std::mutex m_mutex;
+	FILE* m_data = nullptr;
+	RangeSet m_ranges;
+	uint64_t m_unsavedBytes = 0; // written since the index was saved
+	bool m_full = false;         // the cache is full, nothing more is written
+
+	bool Load();      // called by RangeCache::Open
+	bool SaveIndex(); // must be called with m_mutex locked
+
+public:
+	RangeCacheEntry(RangeCache* cache, uint64_t hash, const std::string& key, uint64_t length);
+	~RangeCacheEntry();
+
+	RangeCacheEntry(const RangeCacheEntry&) = delete;
+	RangeCacheEntry& operator=(const RangeCacheEntry&) = delete;
+
+	uint64_t GetLength() const { return m_length; }
+	// number of bytes from pos that are cached
+	uint64_t GetCachedSize(uint64_t pos);
+	// start of the next cached range after pos, the length of the resource if there is none
+	uint64_t GetNextCached(uint64_t pos);
+	uint64_t GetCachedTotal();
+
+	// reads only cached data, returns the number of bytes read
+	size_t Read(uint64_t pos, void* buffer, size_t size);
+	// adds downloaded data, false if it was not stored
+	bool Write(uint64_t pos, const void* data, size_t size);
+};
+
+struct RangeCacheStats_t {
+	uint64_t entries;
+	uint64_t totalBytes;
+	uint64_t maxBytes;
+	uint64_t evictedEntries;
+};
+
+// The cache must outlive the entries that it returns.
+class RangeCache
+{
+	friend class RangeCacheEntry;
+
+	struct IndexInfo {
+		uint64_t size;       // cached bytes
+		uint64_t lastAccess; // seconds since epoch
+	};
+
+	const std::wstring m_directory;
+
+	std::mutex m_mutex;
+	uint64_t m_maxSize;
+	uint64_t m_totalSize = 0;
+	uint64_t m_evicted = 0;
+	bool m_scanned = false;
+	std::map<uint64_t, IndexInfo> m_index;                   // all entries on disk by hash
+	std::map<uint64_t, std::weak_ptr<RangeCacheEntry>> m_open;
+
+	std::wstring GetEntryPath(uint64_t hash, const wchar_t* ext) const;
+	void Scan();                        // must be called with m_mutex locked
+	bool RemoveEntry(uint64_t hash);    // must be called with m_mutex locked
+	bool Reserve(uint64_t hash, uint64_t size);
+	void Update(uint64_t hash, uint64_t size);
+
+public:
+	// directory - with a trailing separator
+	RangeCache(const std::wstring& directory, uint64_t maxSize);
+
+	RangeCache(const RangeCache&) = delete;
+	RangeCache& operator=(const RangeCache&) = delete;
+
+	void SetMaxSize(uint64_t maxSize);
+
+	// returns the entry of the resource version, creates an empty one if it is not cached
+	std::shared_ptr<RangeCacheEntry> Open(const std::wstring& url, const std::wstring& validator, uint64_t length);
+
+	void GetStats(RangeCacheStats_t& stats);
+};
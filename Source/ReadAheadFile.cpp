@@ -0,0 +1,331 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include "ReadAheadFile.h"
+#include "PerfCounters.h"
+#include "Utils/StringUtil.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//
+// OverlappedFile, PreadFile
+//
+
+#ifdef _WIN32
+
+class OverlappedFile : public AsyncReader
+{
+	const HANDLE m_file;
+	const uint64_t m_length;
+	OVERLAPPED m_overlapped[READAHEAD_MAX_DEPTH] = {};
+
+public:
+	OverlappedFile(HANDLE file, uint64_t length)
+		: m_file(file)
+		, m_length(length)
+	{
+		for (auto& overlapped : m_overlapped) {
+			overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		}
+	}
+
+	~OverlappedFile()
+	{
+		for (auto& overlapped : m_overlapped) {
+			if (overlapped.hEvent) {
+				CloseHandle(overlapped.hEvent);
+			}
+		}
+		CloseHandle(m_file);
+	}
+
+	uint64_t GetLength() override { return m_length; }
+
+	bool Start(unsigned slot, uint64_t pos, void* buffer, size_t size) override
+	{
+		OVERLAPPED& overlapped = m_overlapped[slot];
+		const HANDLE event = overlapped.hEvent;
+		overlapped = {};
+		overlapped.hEvent = event;
+		overlapped.Offset = (DWORD)pos;
+		overlapped.OffsetHigh = (DWORD)(pos >> 32);
+
+		return ReadFile(m_file, buffer, (DWORD)size, nullptr, &overlapped) || GetLastError() == ERROR_IO_PENDING;
+	}
+
+	bool IsDone(unsigned slot) override
+	{
+		return HasOverlappedIoCompleted(&m_overlapped[slot]);
+	}
+
+	size_t Wait(unsigned slot) override
+	{
+		DWORD read = 0;
+		if (!GetOverlappedResult(m_file, &m_overlapped[slot], &read, TRUE)) {
+			return GetLastError() == ERROR_HANDLE_EOF ? 0 : SIZE_MAX;
+		}
+		return read;
+	}
+
+	void Cancel(unsigned slot) override
+	{
+		DWORD read = 0;
+		CancelIoEx(m_file, &m_overlapped[slot]);
+		GetOverlappedResult(m_file, &m_overlapped[slot], &read, TRUE);
+	}
+};
+
+std::unique_ptr<AsyncReader> OpenAsyncFile(const std::wstring& path)
+{
+	const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+		OPEN_EXISTING, FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return nullptr;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	return std::make_unique<OverlappedFile>(file, size.QuadPart);
+}
+
+#else
+
+// without overlapped I/O the read is done in Start()
+class PreadFile : public AsyncReader
+{
+	const int m_fd;
+	const uint64_t m_length;
+	size_t m_read[READAHEAD_MAX_DEPTH] = {};
+
+public:
+	PreadFile(int fd, uint64_t length)
+		: m_fd(fd)
+		, m_length(length)
+	{
+	}
+
+	~PreadFile()
+	{
+		close(m_fd);
+	}
+
+	uint64_t GetLength() override { return m_length; }
+
+	bool Start(unsigned slot, uint64_t pos, void* buffer, size_t size) override
+	{
+		const ssize_t read = pread(m_fd, buffer, size, (off_t)pos);
+		m_read[slot] = (read >= 0) ? (size_t)read : SIZE_MAX;
+		return true;
+	}
+
+	bool IsDone(unsigned /*slot*/) override { return true; }
+	size_t Wait(unsigned slot) override { return m_read[slot]; }
+	void Cancel(unsigned /*slot*/) override {}
+};
+
+std::unique_ptr<AsyncReader> OpenAsyncFile(const std::wstring& path)
+{
+	const int fd = open(ConvertWideToUtf8(path).c_str(), O_RDONLY);
+	if (fd < 0) {
+		return nullptr;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return nullptr;
+	}
+
+	return std::make_unique<PreadFile>(fd, st.st_size);
+}
+
+#endif
+
+//
+// ReadAheadFile
+//
+
+ReadAheadFile::ReadAheadFile(std::unique_ptr<AsyncReader> reader)
+	: m_reader(std::move(reader))
+	, m_length(m_reader->GetLength())
+	, m_startNs(GetPerfTimeNs())
+{
+}
+
+ReadAheadFile::~ReadAheadFile()
+{
+	Reset(0);
+}
+
+void ReadAheadFile::Reset(uint64_t pos)
+{
+	for (unsigned i = 0; i < m_count; i++) {
+		const unsigned index = (m_head + i) % READAHEAD_MAX_DEPTH;
+		if (m_slots[index].pending) {
+			m_reader->Cancel(index);
+			m_slots[index].pending = false;
+		}
+	}
+	m_count = 0;
+	m_nextPos = pos;
+	m_afterSeek = true;
+}
+
+void ReadAheadFile::Fill()
+{
+	while (m_count < m_depth && m_nextPos < m_length) {
+		const unsigned index = (m_head + m_count) % READAHEAD_MAX_DEPTH;
+		Slot& slot = m_slots[index];
+		if (slot.capacity < m_blockSize) {
+			slot.buffer = std::make_unique<uint8_t[]>(m_blockSize);
+			slot.capacity = m_blockSize;
+		}
+
+		slot.pos = m_nextPos;
+		slot.size = (size_t)std::min<uint64_t>(m_blockSize, m_length - m_nextPos);
+		slot.read = 0;
+		slot.startNs = GetPerfTimeNs();
+		slot.pending = m_reader->Start(index, slot.pos, slot.buffer.get(), slot.size);
+		if (!slot.pending) {
+			slot.read = SIZE_MAX;
+		}
+
+		m_count++;
+		m_nextPos += slot.size;
+		m_reads++;
+	}
+}
+
+bool ReadAheadFile::WaitHead()
+{
+	Slot& slot = m_slots[m_head];
+	if (!slot.pending) {
+		return slot.read != SIZE_MAX;
+	}
+
+	const bool stall = !m_reader->IsDone(m_head);
+	const uint64_t waitStart = GetPerfTimeNs();
+	slot.read = m_reader->Wait(m_head);
+	slot.pending = false;
+	if (slot.read != SIZE_MAX) {
+		m_readBytes += slot.read;
+	}
+
+	if (stall) {
+		const uint64_t now = GetPerfTimeNs();
+		const uint64_t stallNs = now - waitStart;
+		m_stalls++;
+		m_stallTimeNs += stallNs;
+		if (stallNs > m_stallMaxNs) {
+			m_stallMaxNs = stallNs;
+		}
+
+		// the read has just completed, so this is its real latency
+		const uint64_t latency = now - slot.startNs;
+		const uint64_t smoothed = m_latencyNs;
+		m_latencyNs = smoothed ? (smoothed * 3 + latency) / 4 : latency;
+
+		if (!m_afterSeek) {
+			Extend();
+		}
+	}
+	m_afterSeek = false;
+
+	return slot.read != SIZE_MAX;
+}
+
+void ReadAheadFile::Extend()
+{
+	// the data that is consumed during two read latencies should be in the ring
+	const uint64_t elapsedNs = GetPerfTimeNs() - m_startNs;
+	const double rate = elapsedNs ? m_consumed * 1e9 / elapsedNs : 0.0; // bytes per second
+	const uint64_t needed = (uint64_t)(rate * m_latencyNs * 2 / 1e9);
+
+	// at least one step after a stall
+	do {
+		if (m_depth < READAHEAD_MAX_DEPTH) {
+			m_depth++;
+		}
+		else if (m_blockSize < READAHEAD_MAX_BLOCK) {
+			m_blockSize *= 2;
+		}
+		else {
+			break;
+		}
+	} while ((uint64_t)m_depth * m_blockSize < needed);
+
+	m_statDepth = m_depth;
+	m_statBlockSize = m_blockSize;
+}
+
+size_t ReadAheadFile::Read(void* buffer, size_t size)
+{
+	uint8_t* p = (uint8_t*)buffer;
+	size_t done = 0;
+
+	while (done < size && m_pos < m_length) {
+		// release the slots before the position
+		while (m_count && m_pos >= m_slots[m_head].pos + m_slots[m_head].size) {
+			if (m_slots[m_head].pending) {
+				m_reader->Cancel(m_head);
+				m_slots[m_head].pending = false;
+			}
+			m_head = (m_head + 1) % READAHEAD_MAX_DEPTH;
+			m_count--;
+		}
+		if (!m_count || m_pos < m_slots[m_head].pos) {
+			Reset(m_pos);
+		}
+		Fill();
+
+		if (!WaitHead()) {
+			break;
+		}
+		const Slot& slot = m_slots[m_head];
+		const uint64_t end = slot.pos + slot.read;
+		if (m_pos >= end) {
+			break; // the file is shorter than its length
+		}
+
+		const size_t n = (size_t)std::min<uint64_t>(size - done, end - m_pos);
+		memcpy(p + done, slot.buffer.get() + (m_pos - slot.pos), n);
+		done += n;
+		m_pos += n;
+		m_consumed += n;
+	}
+
+	return done;
+}
+
+bool ReadAheadFile::Seek(uint64_t pos)
+{
+	if (pos > m_length) {
+		return false;
+	}
+	// the ring is kept, a seek inside it does not start new reads
+	m_pos = pos;
+
+	return true;
+}
+
+void ReadAheadFile::GetStats(ReadAheadStats_t& stats) const
+{
+	stats.reads       = m_reads;
+	stats.readBytes   = m_readBytes;
+	stats.stalls      = m_stalls;
+	stats.stallTimeNs = m_stallTimeNs;
+	stats.stallMaxNs  = m_stallMaxNs;
+	stats.latencyNs   = m_latencyNs;
+	stats.depth       = m_statDepth;
+	stats.blockSize   = m_statBlockSize;
+}
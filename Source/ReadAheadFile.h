@@ -0,0 +1,107 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <atomic>
+#include "UserFile.h"
+
+// Positioned reads that run in the background, several at a time.
+// Overlapped I/O on Windows, a simulated network share in the benchmarks.
+class AsyncReader
+{
+public:
+	virtual ~AsyncReader() = default;
+
+	virtual uint64_t GetLength() = 0;
+	// starts a read into the buffer, slot < READAHEAD_MAX_DEPTH identifies it in the other calls
+	virtual bool Start(unsigned slot, uint64_t pos, void* buffer, size_t size) = 0;
+	virtual bool IsDone(unsigned slot) = 0;
+	// waits for the read, returns the number of bytes read, SIZE_MAX on error
+	virtual size_t Wait(unsigned slot) = 0;
+	// cancels the read and waits until the buffer is not used
+	virtual void Cancel(unsigned slot) = 0;
+};
+
+// overlapped reads of a file, nullptr if it can not be opened
+std::unique_ptr<AsyncReader> OpenAsyncFile(const std::wstring& path);
+
+#define READAHEAD_MAX_DEPTH     8
+#define READAHEAD_MIN_BLOCK     (256 * 1024)
+#define READAHEAD_MAX_BLOCK     (4 * 1024 * 1024)
+#define READAHEAD_INITIAL_DEPTH 2
+
+struct ReadAheadStats_t {
+	uint64_t reads;       // reads issued
+	uint64_t readBytes;
+	uint64_t stalls;      // Read() calls that waited for data
+	uint64_t stallTimeNs;
+	uint64_t stallMaxNs;
+	uint64_t latencyNs;   // smoothed time of a read that was waited for
+	unsigned depth;
+	size_t   blockSize;
+};
+
+//
+// Reads a file on a network share ahead of the decoder.
+// BASS makes small reads on the decoding thread, here they are served from a ring of large
+// reads that run in the background, so a round trip to the server is paid only when the ring runs dry.
+// After such a stall the ring is extended until it holds the data that is consumed
+// during two measured read latencies: first more reads in flight, then larger reads
+// (at most READAHEAD_MAX_DEPTH * READAHEAD_MAX_BLOCK bytes).
+// The time that Read() waits is counted separately, so it can be told from the decoding time.
+//
+
+class ReadAheadFile : public UserFile
+{
+	struct Slot {
+		std::unique_ptr<uint8_t[]> buffer;
+		size_t capacity = 0;
+		uint64_t pos = 0;
+		size_t size = 0;
+		size_t read = 0;     // result of the read, SIZE_MAX - error
+		bool pending = false;
+		uint64_t startNs = 0;
+	};
+
+	std::unique_ptr<AsyncReader> m_reader;
+	const uint64_t m_length;
+	uint64_t m_pos = 0;
+
+	Slot m_slots[READAHEAD_MAX_DEPTH];
+	unsigned m_head = 0;   // the slot with the lowest position
+	unsigned m_count = 0;  // slots in use, their ranges follow each other
+	uint64_t m_nextPos = 0; // the position of the next read
+	unsigned m_depth = READAHEAD_INITIAL_DEPTH;
+	size_t m_blockSize = READAHEAD_MIN_BLOCK;
+	bool m_afterSeek = true; // the first read after a seek always waits, it does not extend the ring
+
+	uint64_t m_startNs = 0;
+	uint64_t m_consumed = 0;
+
+	std::atomic<uint64_t> m_reads = 0;
+	std::atomic<uint64_t> m_readBytes = 0;
+	std::atomic<uint64_t> m_stalls = 0;
+	std::atomic<uint64_t> m_stallTimeNs = 0;
+	std::atomic<uint64_t> m_stallMaxNs = 0;
+	std::atomic<uint64_t> m_latencyNs = 0;
+	std::atomic<unsigned> m_statDepth = READAHEAD_INITIAL_DEPTH;
+	std::atomic<size_t> m_statBlockSize = READAHEAD_MIN_BLOCK;
+
+	Slot& GetSlot(unsigned i) { return m_slots[(m_head + i) % READAHEAD_MAX_DEPTH]; }
+	void Reset(uint64_t pos);
+	void Fill();
+	bool WaitHead();
+	void Extend();
+
+public:
+	ReadAheadFile(std::unique_ptr<AsyncReader> reader);
+	~ReadAheadFile();
+
+	uint64_t GetLength() override { return m_length; }
+	size_t Read(void* buffer, size_t size) override;
+	bool Seek(uint64_t pos) override;
+
+	void GetStats(ReadAheadStats_t& stats) const;
+};
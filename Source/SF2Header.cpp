@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include "SF2Header.h"
+
+#define SF2_PHDR_SIZE 38
+#define SF2_NAME_MAX  256
+
+static inline uint32_t GetFourCC(const uint8_t* p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint32_t GetLE32(const uint8_t* p)
+{
+	return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool ParseSF2Header(SF2ReadFn read, void* context, uint64_t fileSize, SF2Info& info)
+{
+	uint8_t header[12];
+	if (fileSize < sizeof(header) || !read(context, 0, header, sizeof(header))
+			|| GetFourCC(header) != 'RIFF' || GetFourCC(header + 8) != 'sfbk') {
+		return false;
+	}
+
+	const uint64_t end = std::min<uint64_t>(fileSize, 8 + (uint64_t)GetLE32(header + 4));
+	bool hasPresets = false;
+
+	uint64_t pos = sizeof(header);
+	while (pos + 12 <= end) {
+		if (!read(context, pos, header, 12)) {
+			return false;
+		}
+		const uint32_t size = GetLE32(header + 4);
+		const uint64_t chunkEnd = std::min(end, pos + 8 + size);
+
+		if (GetFourCC(header) == 'LIST') {
+			const uint32_t listType = GetFourCC(header + 8);
+
+			uint64_t sub = pos + 12;
+			while (sub + 8 <= chunkEnd) {
+				if (!read(context, sub, header, 8)) {
+					return false;
+				}
+				const uint32_t id = GetFourCC(header);
+				const uint32_t subSize = GetLE32(header + 4);
+
+				if (listType == 'INFO') {
+					if (id == 'ifil' && subSize >= 4 && read(context, sub + 8, header, 4)) {
+						info.versionMajor = (uint16_t)(header[0] | (header[1] << 8));
+						info.versionMinor = (uint16_t)(header[2] | (header[3] << 8));
+					}
+					else if (id == 'INAM') {
+						char name[SF2_NAME_MAX];
+						const size_t len = std::min<size_t>(subSize, sizeof(name));
+						if (sub + 8 + len <= chunkEnd && read(context, sub + 8, name, len)) {
+							// ASCII, other bytes are treated as ISO-8859-1
+							info.name.clear();
+							for (size_t i = 0; i < len && name[i]; i++) {
+								info.name += (wchar_t)(uint8_t)name[i];
+							}
+						}
+					}
+				}
+				else if (listType == 'sdta') {
+					if (id == 'smpl' || id == 'sm24') {
+						info.sampleDataSize += subSize;
+					}
+				}
+				else if (listType == 'pdta') {
+					if (id == 'phdr') {
+						info.presets = (subSize >= SF2_PHDR_SIZE) ? subSize / SF2_PHDR_SIZE - 1 : 0;
+						hasPresets = true;
+					}
+				}
+
+				sub += 8 + (uint64_t)subSize + (subSize & 1);
+			}
+		}
+
+		pos += 8 + (uint64_t)size + (size & 1);
+	}
+
+	return hasPresets;
+}
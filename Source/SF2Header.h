@@ -0,0 +1,24 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+//
+// SoundFont 2 header parser.
+// Only the chunk headers and the INFO list are read, the sample data is skipped,
+// so a large SoundFont is parsed with a few small reads.
+//
+
+struct SF2Info {
+	std::wstring name;           // INAM
+	uint16_t versionMajor = 0;   // ifil
+	uint16_t versionMinor = 0;
+	uint32_t presets = 0;        // phdr records without the terminal record
+	uint64_t sampleDataSize = 0; // smpl and sm24 chunks
+};
+
+// reads size bytes at offset, returns false on error
+typedef bool (*SF2ReadFn)(void* context, uint64_t offset, void* buffer, size_t size);
+
+bool ParseSF2Header(SF2ReadFn read, void* context, uint64_t fileSize, SF2Info& info);
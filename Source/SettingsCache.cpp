@@ -0,0 +1,357 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include <atomic>
+#include <list>
+#include <mutex>
+#include "SettingsCache.h"
+#include "HttpFile.h"
+#include "Trace.h"
+#include "dllmain.h"
+#include "Utils/Util.h"
+#include "Utils/StringUtil.h"
+
+#define OPT_REGKEY_BassAudioSource L"Software\\MPC-BE Filters\\BassAudioSource"
+#define OPT_MidiEnable             L"MIDI_Enable"
+#define OPT_MidiSoundFontDefault   L"MIDI_SoundFontDefault"
+#define OPT_MidiPrerender          L"MIDI_Prerender"
+#define OPT_MidiRenderThreads      L"MIDI_RenderThreads"
+#define OPT_MidiAdaptiveVoices     L"MIDI_AdaptiveVoices"
+#define OPT_WebmEnable             L"WebM_Enable"
+#define OPT_InfoCache              L"InfoCache"
+#define OPT_Trace                  L"Trace"
+#define OPT_MemoryBudget           L"MemoryBudget"
+#define OPT_ProcessMemoryBudget    L"ProcessMemoryBudget"
+#define OPT_MemoryMap              L"MemoryMap"
+#define OPT_NetworkReadAhead       L"NetworkReadAhead"
+#define OPT_ArchiveFiles           L"ArchiveFiles"
+#define OPT_HttpClient             L"HttpClient"
+#define OPT_HttpCacheSize          L"HttpCacheSize"
+#define OPT_HttpConnections        L"HttpConnections"
+
+#ifndef REG_NOTIFY_THREAD_AGNOSTIC
+#define REG_NOTIFY_THREAD_AGNOSTIC 0x10000000L
+#endif
+
+namespace SettingsCache
+{
+	static std::atomic<const Settings_t*> s_current = nullptr;
+	static std::mutex s_mutex;
+	static std::list<std::unique_ptr<const Settings_t>> s_snapshots; // all published snapshots
+
+	static HKEY s_notifyKey = nullptr;
+	static HANDLE s_notifyEvent = nullptr;
+	static PTP_WAIT s_notifyWait = nullptr;
+	static TP_CALLBACK_ENVIRON s_callbackEnv;
+
+	static void ReadRegistry(Settings_t& sets)
+	{
+		HKEY key;
+		DWORD dwType;
+		ULONG nBytes;
+
+		LSTATUS lRes = RegOpenKeyW(HKEY_CURRENT_USER, OPT_REGKEY_BassAudioSource, &key);
+		if (lRes == ERROR_SUCCESS) {
+			DWORD dwValue;
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_MidiEnable, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.bMidiEnable = !!dwValue;
+			}
+
+			lRes = ::RegQueryValueExW(key, OPT_MidiSoundFontDefault, nullptr, &dwType, nullptr, &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_SZ) {
+				std::wstring str(nBytes, 0);
+				lRes = ::RegQueryValueExW(key, OPT_MidiSoundFontDefault, nullptr, &dwType, reinterpret_cast<LPBYTE>(str.data()), &nBytes);
+				if (lRes == ERROR_SUCCESS && dwType == REG_SZ) {
+					str_truncate_after_null(str);
+					sets.sMidiSoundFontDefault = str;
+				}
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_MidiPrerender, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.bMidiPrerender = !!dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_MidiRenderThreads, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.nMidiRenderThreads = std::min(dwValue, (DWORD)MIDI_SPLIT_MAX_STREAMS);
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_MidiAdaptiveVoices, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.bMidiAdaptiveVoices = !!dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_WebmEnable, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.bWebmEnable = !!dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_InfoCache, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.bInfoCache = !!dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_Trace, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.bTrace = !!dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_MemoryBudget, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.nMemoryBudget = dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_ProcessMemoryBudget, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.nProcessMemoryBudget = dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_MemoryMap, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.bMemoryMap = !!dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_NetworkReadAhead, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.bNetworkReadAhead = !!dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_ArchiveFiles, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.bArchiveFiles = !!dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_HttpClient, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.bHttpClient = !!dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_HttpCacheSize, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.nHttpCacheSize = dwValue;
+			}
+
+			nBytes = sizeof(DWORD);
+			lRes = ::RegQueryValueExW(key, OPT_HttpConnections, nullptr, &dwType, reinterpret_cast<LPBYTE>(&dwValue), &nBytes);
+			if (lRes == ERROR_SUCCESS && dwType == REG_DWORD) {
+				sets.nHttpConnections = std::min(dwValue, (DWORD)HTTPFILE_MAX_CONNECTIONS);
+			}
+
+			RegCloseKey(key);
+		}
+	}
+
+	static void WriteRegistry(const Settings_t& sets)
+	{
+		HKEY key;
+
+		LSTATUS lRes = RegCreateKeyW(HKEY_CURRENT_USER, OPT_REGKEY_BassAudioSource, &key);
+		if (lRes == ERROR_SUCCESS) {
+
+			DWORD dwValue = sets.bMidiEnable;
+			lRes = ::RegSetValueExW(key, OPT_MidiEnable, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			std::wstring str(sets.sMidiSoundFontDefault);
+			lRes = ::RegSetValueExW(key, OPT_MidiSoundFontDefault, 0, REG_SZ, reinterpret_cast<const BYTE*>(str.c_str()), (DWORD)(str.size() + 1) * sizeof(wchar_t));
+
+			dwValue = sets.bMidiPrerender;
+			lRes = ::RegSetValueExW(key, OPT_MidiPrerender, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.nMidiRenderThreads;
+			lRes = ::RegSetValueExW(key, OPT_MidiRenderThreads, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.bMidiAdaptiveVoices;
+			lRes = ::RegSetValueExW(key, OPT_MidiAdaptiveVoices, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.bWebmEnable;
+			lRes = ::RegSetValueExW(key, OPT_WebmEnable, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.bInfoCache;
+			lRes = ::RegSetValueExW(key, OPT_InfoCache, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.bTrace;
+			lRes = ::RegSetValueExW(key, OPT_Trace, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.nMemoryBudget;
+			lRes = ::RegSetValueExW(key, OPT_MemoryBudget, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.nProcessMemoryBudget;
+			lRes = ::RegSetValueExW(key, OPT_ProcessMemoryBudget, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.bMemoryMap;
+			lRes = ::RegSetValueExW(key, OPT_MemoryMap, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.bNetworkReadAhead;
+			lRes = ::RegSetValueExW(key, OPT_NetworkReadAhead, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.bArchiveFiles;
+			lRes = ::RegSetValueExW(key, OPT_ArchiveFiles, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.bHttpClient;
+			lRes = ::RegSetValueExW(key, OPT_HttpClient, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.nHttpCacheSize;
+			lRes = ::RegSetValueExW(key, OPT_HttpCacheSize, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			dwValue = sets.nHttpConnections;
+			lRes = ::RegSetValueExW(key, OPT_HttpConnections, 0, REG_DWORD, reinterpret_cast<const BYTE*>(&dwValue), sizeof(DWORD));
+
+			RegCloseKey(key);
+		}
+	}
+
+	// must be called with s_mutex locked
+	static void Publish(const Settings_t& sets)
+	{
+		const Settings_t* current = s_current.load(std::memory_order_relaxed);
+		if (current && *current == sets) {
+			return;
+		}
+
+		s_snapshots.emplace_back(std::make_unique<const Settings_t>(sets));
+		s_current.store(s_snapshots.back().get(), std::memory_order_release);
+
+		Trace::Enable(sets.bTrace);
+	}
+
+	static VOID CALLBACK OnKeyChanged(PTP_CALLBACK_INSTANCE, PVOID, PTP_WAIT, TP_WAIT_RESULT);
+
+	// (re)arms the one-shot change notification, must be called with s_mutex locked
+	static void ArmNotify()
+	{
+		if (!s_notifyKey) {
+			if (s_notifyEvent) {
+				return; // failed before
+			}
+			s_notifyEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+			if (!s_notifyEvent) {
+				return;
+			}
+
+			HKEY key;
+			LSTATUS lRes = RegCreateKeyExW(HKEY_CURRENT_USER, OPT_REGKEY_BassAudioSource, 0, nullptr, 0, KEY_NOTIFY, nullptr, &key, nullptr);
+			if (lRes != ERROR_SUCCESS) {
+				DLogError(L"SettingsCache: failed to open the registry key, error {}", lRes);
+				return;
+			}
+
+			// the callback holds a reference to the DLL, it can not be unloaded while the callback runs
+			InitializeThreadpoolEnvironment(&s_callbackEnv);
+			SetThreadpoolCallbackLibrary(&s_callbackEnv, HInstance);
+			s_notifyWait = CreateThreadpoolWait(OnKeyChanged, nullptr, &s_callbackEnv);
+			if (!s_notifyWait) {
+				RegCloseKey(key);
+				return;
+			}
+			s_notifyKey = key;
+		}
+
+		// REG_NOTIFY_THREAD_AGNOSTIC keeps the notification when the calling pool thread exits,
+		// it is not supported before Windows 8
+		LSTATUS lRes = RegNotifyChangeKeyValue(s_notifyKey, FALSE, REG_NOTIFY_CHANGE_LAST_SET | REG_NOTIFY_THREAD_AGNOSTIC, s_notifyEvent, TRUE);
+		if (lRes != ERROR_SUCCESS) {
+			lRes = RegNotifyChangeKeyValue(s_notifyKey, FALSE, REG_NOTIFY_CHANGE_LAST_SET, s_notifyEvent, TRUE);
+		}
+		if (lRes == ERROR_SUCCESS) {
+			SetThreadpoolWait(s_notifyWait, s_notifyEvent, nullptr);
+		}
+		else {
+			DLogError(L"SettingsCache: RegNotifyChangeKeyValue failed, error {}", lRes);
+		}
+	}
+
+	static VOID CALLBACK OnKeyChanged(PTP_CALLBACK_INSTANCE, PVOID, PTP_WAIT, TP_WAIT_RESULT)
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		if (!s_notifyKey) {
+			return; // shut down
+		}
+
+		Settings_t sets;
+		ReadRegistry(sets);
+		DLogIf(*s_current.load(std::memory_order_relaxed) != sets, L"SettingsCache: the registry settings have changed");
+		Publish(sets);
+
+		ArmNotify();
+	}
+
+	static const Settings_t* Load()
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		if (!s_current.load(std::memory_order_relaxed)) {
+			Settings_t sets;
+			ReadRegistry(sets);
+			Publish(sets);
+			ArmNotify();
+		}
+
+		return s_current.load(std::memory_order_relaxed);
+	}
+
+	const Settings_t& Get()
+	{
+		const Settings_t* sets = s_current.load(std::memory_order_acquire);
+		if (!sets) {
+			sets = Load();
+		}
+
+		return *sets;
+	}
+
+	void Set(const Settings_t& sets)
+	{
+		Get(); // loads the registry settings and starts the notification
+
+		std::lock_guard<std::mutex> lock(s_mutex);
+		Publish(sets);
+	}
+
+	void Save()
+	{
+		const Settings_t& sets = Get();
+
+		// the notification that follows reads back the same settings and publishes nothing
+		std::lock_guard<std::mutex> lock(s_mutex);
+		WriteRegistry(sets);
+	}
+
+	void Shutdown()
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		if (s_notifyWait) {
+			SetThreadpoolWait(s_notifyWait, nullptr, nullptr);
+			CloseThreadpoolWait(s_notifyWait);
+			s_notifyWait = nullptr;
+			DestroyThreadpoolEnvironment(&s_callbackEnv);
+		}
+		if (s_notifyKey) {
+			RegCloseKey(s_notifyKey);
+			s_notifyKey = nullptr;
+		}
+		if (s_notifyEvent) {
+			CloseHandle(s_notifyEvent);
+			s_notifyEvent = nullptr;
+		}
+	}
+}
@@ -0,0 +1,30 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include "IBassSource.h"
+
+//
+// Process-wide filter settings.
+// The registry is read once per process into an immutable snapshot, a new snapshot
+// is published when the registry key is changed (RegNotifyChangeKeyValue) or the
+// settings are changed through IBassSource. Snapshots are never freed, a reference
+// returned by Get() stays valid for the life of the process.
+//
+
+namespace SettingsCache
+{
+	// the current snapshot, one atomic load after the first call
+	const Settings_t& Get();
+
+	// publishes new settings without saving them
+	void Set(const Settings_t& sets);
+
+	// writes the current settings to the registry
+	void Save();
+
+	// stops the change notification, called on DLL unload
+	void Shutdown();
+}
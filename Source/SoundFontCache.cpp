@@ -0,0 +1,154 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include <list>
+#include <mutex>
+#include "SoundFontCache.h"
+#include "Utils/Util.h"
+
+namespace SoundFontCache
+{
+	struct Font {
+		std::wstring path;
+		uint64_t     fileSize;
+		FILETIME     lastWrite;
+		HSOUNDFONT   handle;
+		unsigned     refs;
+	};
+
+	// the most recently used first
+	static std::list<Font> s_fonts;
+	static std::mutex s_mutex;
+
+	static uint64_t GetFontSize(HSOUNDFONT handle)
+	{
+		BASS_MIDI_FONTINFO info;
+		if (BASS_MIDI_FontGetInfo(handle, &info)) {
+			return info.samload;
+		}
+
+		return 0;
+	}
+
+	// must be called with s_mutex locked
+	static uint64_t Free(std::list<Font>::iterator it)
+	{
+		const uint64_t size = GetFontSize(it->handle);
+		DLog(L"SoundFontCache: freeing '{}', {} KiB of samples", it->path, size / 1024);
+		BASS_MIDI_FontFree(it->handle);
+		s_fonts.erase(it);
+
+		return size;
+	}
+
+	// must be called with s_mutex locked
+	static void Trim(unsigned maxIdle)
+	{
+		unsigned idle = 0;
+		for (auto it = s_fonts.begin(); it != s_fonts.end();) {
+			auto next = std::next(it);
+			if (it->refs == 0 && ++idle > maxIdle) {
+				Free(it);
+			}
+			it = next;
+		}
+	}
+
+	HSOUNDFONT Acquire(const std::wstring& path)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA fad;
+		if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &fad)) {
+			return 0;
+		}
+		const uint64_t fileSize = ((uint64_t)fad.nFileSizeHigh << 32) | fad.nFileSizeLow;
+
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		for (auto it = s_fonts.begin(); it != s_fonts.end(); ++it) {
+			if (_wcsicmp(it->path.c_str(), path.c_str()) != 0) {
+				continue;
+			}
+			if (it->fileSize == fileSize && CompareFileTime(&it->lastWrite, &fad.ftLastWriteTime) == 0) {
+				it->refs++;
+				s_fonts.splice(s_fonts.begin(), s_fonts, it);
+				DLog(L"SoundFontCache: reusing '{}', {} users", path, it->refs);
+				return it->handle;
+			}
+			if (it->refs == 0) {
+				// the file has changed, the old version is not used anymore
+				Free(it);
+			}
+			break;
+		}
+
+		// loaded under the lock, so concurrent opens of the same font share one load
+		const HSOUNDFONT handle = BASS_MIDI_FontInit((const void*)path.c_str(), BASS_MIDI_FONT_MMAP | BASS_UNICODE);
+		if (!handle) {
+			DLogError(L"SoundFontCache: failed to load '{}', error {}", path, BASS_ErrorGetCode());
+			return 0;
+		}
+
+		s_fonts.push_front({ path, fileSize, fad.ftLastWriteTime, handle, 1 });
+		DLog(L"SoundFontCache: loaded '{}'", path);
+
+		return handle;
+	}
+
+	void Release(HSOUNDFONT font)
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		for (auto it = s_fonts.begin(); it != s_fonts.end(); ++it) {
+			if (it->handle == font) {
+				ASSERT(it->refs > 0);
+				if (--it->refs == 0) {
+					// keep the font warm, it becomes the most recently used idle font
+					s_fonts.splice(s_fonts.begin(), s_fonts, it);
+					Trim(SOUNDFONT_CACHE_IDLE_MAX);
+				}
+				return;
+			}
+		}
+		ASSERT(0);
+	}
+
+	uint64_t GetLoadedBytes()
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		uint64_t size = 0;
+		for (const auto& font : s_fonts) {
+			size += GetFontSize(font.handle);
+		}
+
+		return size;
+	}
+
+	uint64_t EvictIdle()
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		uint64_t size = 0;
+		for (auto it = s_fonts.begin(); it != s_fonts.end();) {
+			auto next = std::next(it);
+			if (it->refs == 0) {
+				size += Free(it);
+			}
+			it = next;
+		}
+
+		return size;
+	}
+
+	void Shutdown()
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		for (const auto& font : s_fonts) {
+			BASS_MIDI_FontFree(font.handle);
+		}
+		s_fonts.clear();
+	}
+}
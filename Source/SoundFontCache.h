@@ -0,0 +1,32 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <../Include/bassmidi.h>
+
+//
+// Process-wide cache of SoundFonts, shared by the MIDI streams of all filter instances.
+// A font is keyed by path, size and modification time and is reference counted.
+// Up to SOUNDFONT_CACHE_IDLE_MAX fonts without users are kept loaded (least recently used
+// are freed first), so reopening a MIDI file does not parse the font again.
+//
+
+#define SOUNDFONT_CACHE_IDLE_MAX 2
+
+namespace SoundFontCache
+{
+	// returns a font with an added reference or 0, must be released with Release()
+	HSOUNDFONT Acquire(const std::wstring& path);
+	void Release(HSOUNDFONT font);
+
+	// loaded sample data of all cached fonts
+	uint64_t GetLoadedBytes();
+
+	// frees the fonts without users, returns the number of released bytes
+	uint64_t EvictIdle();
+
+	// frees all fonts, called on DLL unload
+	void Shutdown();
+}
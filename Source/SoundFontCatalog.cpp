@@ -0,0 +1,298 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include "SoundFontCatalog.h"
+#include "Helper.h"
+#include "dllmain.h"
+#include "Utils/StringUtil.h"
+
+#define SOUNDFONTCATALOG_WAIT_TIMEOUT 5000 // ms, Find waits for the first scan
+
+namespace SoundFontCatalog
+{
+	static std::mutex s_mutex;     // the fields below
+	static std::condition_variable s_readyCv;
+	static std::mutex s_scanMutex; // one scan at a time
+	static std::shared_ptr<const std::vector<SoundFontEntry>> s_entries;
+	static bool s_ready = false;
+	static HWND s_notifyWnd = nullptr;
+	static UINT s_notifyMessage = 0;
+
+	static std::wstring s_directory;
+	static std::atomic<bool> s_rescan = false;
+	static std::atomic<bool> s_stop = false;
+
+	static HANDLE s_changeHandle = INVALID_HANDLE_VALUE;
+	static PTP_WAIT s_changeWait = nullptr;
+	static PTP_WORK s_scanWork = nullptr;
+	static TP_CALLBACK_ENVIRON s_callbackEnv;
+	static bool s_started = false;
+
+	static bool ReadFileAt(void* context, uint64_t offset, void* buffer, size_t size)
+	{
+		OVERLAPPED ov = {};
+		ov.Offset     = (DWORD)offset;
+		ov.OffsetHigh = (DWORD)(offset >> 32);
+		DWORD dwRead = 0;
+
+		return ReadFile((HANDLE)context, buffer, (DWORD)size, &dwRead, &ov) && dwRead == size;
+	}
+
+	static void ReadHeader(SoundFontEntry& entry)
+	{
+		HANDLE hFile = CreateFileW(entry.path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE) {
+			return;
+		}
+		entry.parsed = ParseSF2Header(ReadFileAt, hFile, entry.size, entry.info);
+		CloseHandle(hFile);
+
+		DLogIf(!entry.parsed, L"SoundFontCatalog: '{}' is not a valid SoundFont 2 file", entry.path);
+	}
+
+	static void ScanDirectory(const std::wstring& dir, std::vector<SoundFontEntry>& entries)
+	{
+		WIN32_FIND_DATAW fd;
+		HANDLE hFind = FindFirstFileExW((dir + L'*').c_str(), FindExInfoBasic, &fd, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+		if (hFind == INVALID_HANDLE_VALUE) {
+			return;
+		}
+
+		do {
+			if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+				if (wcscmp(fd.cFileName, L".") && wcscmp(fd.cFileName, L"..")
+						&& !(fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
+					ScanDirectory(dir + fd.cFileName + L'\\', entries);
+				}
+				continue;
+			}
+
+			const wchar_t* ext = wcsrchr(fd.cFileName, L'.');
+			if (ext && (_wcsicmp(ext, L".sf2") == 0 || _wcsicmp(ext, L".sfz") == 0)) {
+				SoundFontEntry& entry = entries.emplace_back();
+				entry.path     = dir + fd.cFileName;
+				entry.filename = fd.cFileName;
+				entry.size     = ((uint64_t)fd.nFileSizeHigh << 32) | fd.nFileSizeLow;
+				entry.mtime    = ((uint64_t)fd.ftLastWriteTime.dwHighDateTime << 32) | fd.ftLastWriteTime.dwLowDateTime;
+			}
+		} while (!s_stop.load(std::memory_order_relaxed) && FindNextFileW(hFind, &fd));
+
+		FindClose(hFind);
+	}
+
+	static void Scan()
+	{
+		std::vector<SoundFontEntry> entries;
+		ScanDirectory(s_directory, entries);
+		if (s_stop.load()) {
+			return;
+		}
+
+		std::shared_ptr<const std::vector<SoundFontEntry>> prev;
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			prev = s_entries;
+		}
+
+		unsigned parsed = 0;
+		for (auto& entry : entries) {
+			const SoundFontEntry* old = nullptr;
+			if (prev) {
+				for (const auto& e : *prev) {
+					if (e.size == entry.size && e.mtime == entry.mtime && e.path == entry.path) {
+						old = &e;
+						break;
+					}
+				}
+			}
+
+			if (old) {
+				entry = *old;
+			}
+			else if (_wcsicmp(wcsrchr(entry.filename.c_str(), L'.'), L".sf2") == 0) {
+				ReadHeader(entry);
+				parsed++;
+			}
+		}
+
+		// the same filename in several subdirectories: the shallowest path first, then alphabetically
+		auto GetDepth = [](const std::wstring& path) { return std::count(path.begin(), path.end(), L'\\'); };
+		std::sort(entries.begin(), entries.end(), [&](const SoundFontEntry& a, const SoundFontEntry& b) {
+			if (const int cmp = _wcsicmp(a.filename.c_str(), b.filename.c_str())) {
+				return cmp < 0;
+			}
+			if (const auto depthA = GetDepth(a.path), depthB = GetDepth(b.path); depthA != depthB) {
+				return depthA < depthB;
+			}
+			return _wcsicmp(a.path.c_str(), b.path.c_str()) < 0;
+		});
+
+		const bool changed = !prev || parsed || prev->size() != entries.size()
+			|| !std::equal(entries.begin(), entries.end(), prev->begin(), [](const SoundFontEntry& a, const SoundFontEntry& b) {
+				return a.path == b.path && a.size == b.size && a.mtime == b.mtime;
+			});
+
+		DLog(L"SoundFontCatalog: {} SoundFonts, {} headers read", entries.size(), parsed);
+
+		std::lock_guard<std::mutex> lock(s_mutex);
+		if (changed) {
+			s_entries = std::make_shared<const std::vector<SoundFontEntry>>(std::move(entries));
+		}
+		s_ready = true;
+		s_readyCv.notify_all();
+		if (changed && s_notifyWnd) {
+			PostMessageW(s_notifyWnd, s_notifyMessage, 0, 0);
+		}
+	}
+
+	static VOID CALLBACK OnScan(PTP_CALLBACK_INSTANCE, PVOID, PTP_WORK)
+	{
+		std::lock_guard<std::mutex> lock(s_scanMutex);
+
+		// notifications that arrive during a scan are handled by one more scan
+		while (s_rescan.exchange(false) && !s_stop.load()) {
+			Scan();
+		}
+	}
+
+	static void RequestScan()
+	{
+		if (!s_rescan.exchange(true)) {
+			SubmitThreadpoolWork(s_scanWork);
+		}
+	}
+
+	static VOID CALLBACK OnDirectoryChanged(PTP_CALLBACK_INSTANCE, PVOID, PTP_WAIT, TP_WAIT_RESULT)
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		if (s_changeHandle == INVALID_HANDLE_VALUE) {
+			return; // shut down
+		}
+
+		RequestScan();
+
+		if (FindNextChangeNotification(s_changeHandle)) {
+			SetThreadpoolWait(s_changeWait, s_changeHandle, nullptr);
+		}
+	}
+
+	void Start()
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		if (s_started) {
+			return;
+		}
+		s_started = true;
+
+		s_directory = GetFilterDirectory();
+
+		// the callbacks hold a reference to the DLL, it can not be unloaded while they run
+		InitializeThreadpoolEnvironment(&s_callbackEnv);
+		SetThreadpoolCallbackLibrary(&s_callbackEnv, HInstance);
+
+		s_scanWork = CreateThreadpoolWork(OnScan, nullptr, &s_callbackEnv);
+		if (!s_scanWork) {
+			s_ready = true;
+			s_readyCv.notify_all();
+			return;
+		}
+		RequestScan();
+
+		s_changeHandle = FindFirstChangeNotificationW(s_directory.c_str(), TRUE,
+			FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+		if (s_changeHandle == INVALID_HANDLE_VALUE) {
+			DLogError(L"SoundFontCatalog: FindFirstChangeNotification failed, error {}", GetLastError());
+			return;
+		}
+		s_changeWait = CreateThreadpoolWait(OnDirectoryChanged, nullptr, &s_callbackEnv);
+		if (s_changeWait) {
+			SetThreadpoolWait(s_changeWait, s_changeHandle, nullptr);
+		}
+	}
+
+	bool IsReady()
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		return s_ready;
+	}
+
+	std::shared_ptr<const std::vector<SoundFontEntry>> GetEntries()
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		if (s_entries) {
+			return s_entries;
+		}
+
+		return std::make_shared<const std::vector<SoundFontEntry>>();
+	}
+
+	std::wstring Find(const std::wstring_view filename)
+	{
+		{
+			std::unique_lock<std::mutex> lock(s_mutex);
+			if (!s_readyCv.wait_for(lock, std::chrono::milliseconds(SOUNDFONTCATALOG_WAIT_TIMEOUT), [] { return s_ready; })) {
+				DLog(L"SoundFontCatalog: the first scan is not finished");
+				return {};
+			}
+		}
+
+		// the entries with the same filename are sorted by the depth of the path
+		const auto entries = GetEntries();
+		for (const auto& entry : *entries) {
+			if (entry.filename.length() == filename.length()
+					&& _wcsnicmp(entry.filename.c_str(), filename.data(), filename.length()) == 0) {
+				return entry.path;
+			}
+		}
+
+		return {};
+	}
+
+	void SetNotifyWindow(HWND hWnd, UINT message)
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		s_notifyWnd = hWnd;
+		s_notifyMessage = message;
+	}
+
+	void Shutdown()
+	{
+		s_stop = true;
+
+		PTP_WAIT changeWait = nullptr;
+		PTP_WORK scanWork = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+
+			if (s_changeHandle != INVALID_HANDLE_VALUE) {
+				FindCloseChangeNotification(s_changeHandle);
+				s_changeHandle = INVALID_HANDLE_VALUE;
+			}
+			changeWait = std::exchange(s_changeWait, nullptr);
+			scanWork = std::exchange(s_scanWork, nullptr);
+			s_notifyWnd = nullptr;
+		}
+
+		// outside of s_mutex, the callbacks lock it
+		if (changeWait) {
+			SetThreadpoolWait(changeWait, nullptr, nullptr);
+			WaitForThreadpoolWaitCallbacks(changeWait, TRUE);
+			CloseThreadpoolWait(changeWait);
+		}
+		if (scanWork) {
+			WaitForThreadpoolWorkCallbacks(scanWork, TRUE);
+			CloseThreadpoolWork(scanWork);
+		}
+		if (s_started) {
+			DestroyThreadpoolEnvironment(&s_callbackEnv);
+		}
+	}
+}
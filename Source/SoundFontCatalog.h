@@ -0,0 +1,46 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include "SF2Header.h"
+
+//
+// Process-wide catalog of the SoundFonts (*.sf2, *.sfz) in the filter directory and its subdirectories.
+// The directory is scanned on a pool thread, unchanged files (same size and modification time)
+// keep their entries, so only new or modified SoundFonts have their headers read.
+// A directory change notification starts a rescan.
+//
+
+struct SoundFontEntry {
+	std::wstring path;     // full path
+	std::wstring filename;
+	uint64_t size  = 0;
+	uint64_t mtime = 0;    // FILETIME
+	bool parsed = false;   // the SF2 header is read, false for SFZ and damaged files
+	SF2Info info;
+};
+
+namespace SoundFontCatalog
+{
+	// starts the first scan and the change notification, returns immediately
+	void Start();
+
+	// is the first scan finished
+	bool IsReady();
+
+	// the entries sorted by filename, the same filename by the depth of the path and then by the path,
+	// empty until the first scan is finished
+	std::shared_ptr<const std::vector<SoundFontEntry>> GetEntries();
+
+	// full path of a SoundFont by filename (case-insensitive), the shallowest one if there are several,
+	// empty if it is not found. Waits for the first scan for up to 5 seconds.
+	std::wstring Find(const std::wstring_view filename);
+
+	// the message is posted to the window when the catalog has changed, nullptr removes the window
+	void SetNotifyWindow(HWND hWnd, UINT message);
+
+	// stops the change notification and waits for a running scan, called on DLL unload
+	void Shutdown();
+}
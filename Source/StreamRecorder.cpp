@@ -0,0 +1,210 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include <cstdio>
+#include <ctime>
+#include "StreamRecorder.h"
+#include "PerfCounters.h"
+#include "Utils/StringUtil.h"
+
+#define RECORD_TITLE_MAX 80 // characters of the title in a file name
+
+static FILE* OpenFile(const std::wstring& path)
+{
+#ifdef _WIN32
+	return _wfopen(path.c_str(), L"wb");
+#else
+	return fopen(ConvertWideToUtf8(path).c_str(), "wb");
+#endif
+}
+
+StreamRecorder::StreamRecorder(const std::wstring& directory, const std::wstring& ext, const std::wstring& title, size_t bufferSize)
+	: m_directory(directory)
+	, m_ext(ext)
+{
+	for (auto& buffer : m_buffers) {
+		buffer.data.resize(bufferSize);
+	}
+	m_buffers[m_front].splits.push_back({ 0, MakeFileName(title) });
+
+	m_thread = std::thread(&StreamRecorder::ThreadProc, this);
+}
+
+StreamRecorder::~StreamRecorder()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_cond.notify_one();
+	m_thread.join();
+}
+
+std::wstring StreamRecorder::MakeFileName(const std::wstring& title)
+{
+	const std::time_t now = std::time(nullptr);
+	std::tm tm = {};
+#ifdef _WIN32
+	localtime_s(&tm, &now);
+#else
+	localtime_r(&now, &tm);
+#endif
+	wchar_t time[32];
+	wcsftime(time, std::size(time), L"%Y-%m-%d %H-%M-%S", &tm);
+
+	wchar_t number[16];
+	swprintf(number, std::size(number), L" %03u", ++m_fileNumber);
+
+	std::wstring name = m_directory + time + number;
+
+	if (title.size()) {
+		name += L' ';
+		for (const wchar_t ch : title.substr(0, RECORD_TITLE_MAX)) {
+			name += (ch < 32 || wcschr(L"\\/:*?\"<>|", ch)) ? L'_' : ch;
+		}
+		while (name.back() == L' ' || name.back() == L'.') {
+			name.pop_back();
+		}
+	}
+
+	return name + L'.' + m_ext;
+}
+
+bool StreamRecorder::Submit()
+{
+	if (m_backBusy) {
+		return false;
+	}
+
+	m_backBusy = true;
+	m_front ^= 1;
+
+	m_buffers[m_front].used = 0;
+
+	m_cond.notify_one();
+
+	return true;
+}
+
+void StreamRecorder::Write(const void* data, size_t size)
+{
+	const uint8_t* p = (const uint8_t*)data;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	while (size) {
+		Buffer& front = m_buffers[m_front];
+		if (front.used == front.data.size() && !Submit()) {
+			// both buffers are full, the writes are slower than the stream
+			m_stats.droppedBytes += size;
+			break;
+		}
+
+		Buffer& buffer = m_buffers[m_front];
+		const size_t n = std::min(size, buffer.data.size() - buffer.used);
+		memcpy(buffer.data.data() + buffer.used, p, n);
+		buffer.used += n;
+		p += n;
+		size -= n;
+	}
+
+	const uint64_t queued = m_buffers[m_front].used + (m_backBusy ? m_buffers[m_front ^ 1].used : 0);
+	m_stats.queuedBytes = queued;
+	m_stats.maxQueuedBytes = std::max(m_stats.maxQueuedBytes, queued);
+}
+
+void StreamRecorder::Split(const std::wstring& title)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// the split is kept with the buffer at the current offset, the data before it
+	// is written to the old file even if the other buffer is still being written
+	Buffer& front = m_buffers[m_front];
+	if (front.splits.size() && front.splits.back().offset == front.used) {
+		// no data was written since the previous split, it is replaced
+		front.splits.back().file = MakeFileName(title);
+	}
+	else {
+		front.splits.push_back({ front.used, MakeFileName(title) });
+	}
+}
+
+void StreamRecorder::ThreadProc()
+{
+	FILE* file = nullptr;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	for (;;) {
+		if (!m_backBusy) {
+			m_cond.wait_for(lock, std::chrono::milliseconds(RECORD_FLUSH_INTERVAL), [this] { return m_stop || m_backBusy; });
+			if (!m_backBusy) {
+				// timeout or stop, write the partially filled buffer
+				if (m_buffers[m_front].used) {
+					Submit();
+				}
+				else if (m_stop) {
+					break;
+				}
+				else {
+					continue;
+				}
+			}
+		}
+
+		Buffer& buffer = m_buffers[m_front ^ 1];
+		lock.unlock();
+
+		const uint64_t start = GetPerfTimeNs();
+		uint64_t written = 0;
+		uint64_t files = 0;
+		size_t pos = 0;
+		for (size_t i = 0; i <= buffer.splits.size(); i++) {
+			const size_t end = (i < buffer.splits.size()) ? buffer.splits[i].offset : buffer.used;
+			if (end > pos && file && fwrite(buffer.data.data() + pos, 1, end - pos, file) == end - pos) {
+				written += end - pos;
+			}
+			pos = end;
+
+			if (i < buffer.splits.size()) {
+				if (file) {
+					fclose(file);
+				}
+				file = OpenFile(buffer.splits[i].file);
+				if (file) {
+					files++;
+				}
+			}
+		}
+		const uint64_t time = GetPerfTimeNs() - start;
+
+		lock.lock();
+
+		m_stats.files += files;
+		m_stats.writtenBytes += written;
+		if (written < buffer.used) {
+			m_stats.droppedBytes += buffer.used - written;
+			m_stats.writeErrors++;
+		}
+		m_stats.writeTimeNs += time;
+
+		buffer.used = 0;
+		buffer.splits.clear();
+		m_backBusy = false;
+		m_stats.queuedBytes = m_buffers[m_front].used;
+	}
+
+	lock.unlock();
+
+	if (file) {
+		fclose(file);
+	}
+}
+
+void StreamRecorder::GetStats(RecordStats_t& stats)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	stats = m_stats;
+}
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+//
+// Records the compressed data of a network stream to files.
+// Write() only copies the data into one of two buffers, a full buffer is written
+// to the file on the recorder thread, so the download thread never waits for file I/O.
+// If both buffers are full, the data is dropped and counted.
+// Split() starts a new file at the current byte of the stream, e.g. on a stream title change.
+// A recording is the exact byte stream received from the server,
+// so it can be replayed as a fixture for the network tests.
+//
+
+#define RECORD_BUFFER_SIZE    (256 * 1024)
+#define RECORD_FLUSH_INTERVAL 500 // ms, a partially filled buffer is written after this time
+
+struct RecordStats_t {
+	uint64_t files;
+	uint64_t writtenBytes;
+	uint64_t droppedBytes;
+	uint64_t writeTimeNs;    // time spent in file writes
+	uint64_t queuedBytes;    // received but not written yet
+	uint64_t maxQueuedBytes;
+	uint64_t writeErrors;
+};
+
+class StreamRecorder
+{
+	struct Split_t {
+		size_t offset;     // in the buffer data
+		std::wstring file; // opened before the data from the offset is written
+	};
+	struct Buffer {
+		std::vector<uint8_t> data;
+		size_t used = 0;
+		std::vector<Split_t> splits; // in the order of the offsets
+	};
+
+	const std::wstring m_directory;
+	const std::wstring m_ext;
+
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	Buffer m_buffers[2];
+	int m_front = 0;           // the buffer that Write() fills
+	bool m_backBusy = false;   // the other buffer is being written
+	bool m_stop = false;
+	unsigned m_fileNumber = 0;
+	RecordStats_t m_stats = {};
+
+	std::thread m_thread;
+
+	std::wstring MakeFileName(const std::wstring& title);
+	bool Submit(); // must be called with m_mutex locked
+	void ThreadProc();
+
+public:
+	// directory - with a trailing separator, ext - file extension without a dot
+	StreamRecorder(const std::wstring& directory, const std::wstring& ext, const std::wstring& title, size_t bufferSize = RECORD_BUFFER_SIZE);
+	// writes the buffered data and closes the file
+	~StreamRecorder();
+
+	StreamRecorder(const StreamRecorder&) = delete;
+	StreamRecorder& operator=(const StreamRecorder&) = delete;
+
+	void Write(const void* data, size_t size);
+	void Split(const std::wstring& title);
+
+	void GetStats(RecordStats_t& stats);
+};
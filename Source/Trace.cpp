@@ -0,0 +1,225 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include "Trace.h"
+
+#define TRACE_RING_SIZE 8192 // records per thread, must be a power of two
+
+namespace Trace
+{
+	std::atomic<bool> g_enabled = false;
+
+	struct ThreadRing
+	{
+		Record records[TRACE_RING_SIZE];
+		std::atomic<uint64_t> head = 0; // total number of records written
+		std::atomic<bool> inUse = false;
+		uint32_t tid = 0;
+	};
+
+	// The rings are never freed. The ring of a finished thread keeps its events
+	// until it is given to a new thread.
+	static std::mutex s_ringsMutex;
+	static std::vector<std::unique_ptr<ThreadRing>> s_rings;
+	static std::atomic<uint64_t> s_timeBase = 0;
+
+	struct RingHolder
+	{
+		ThreadRing* ring = nullptr;
+
+		~RingHolder()
+		{
+			if (ring) {
+				ring->inUse.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	static thread_local RingHolder t_holder;
+
+	static uint64_t GetTimeNs()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static uint32_t GetThreadId()
+	{
+#ifdef _WIN32
+		return GetCurrentThreadId();
+#else
+		static std::atomic<uint32_t> s_nextId = 1;
+		static thread_local uint32_t t_id = s_nextId++;
+		return t_id;
+#endif
+	}
+
+	static ThreadRing* AcquireRing()
+	{
+		std::lock_guard<std::mutex> lock(s_ringsMutex);
+
+		ThreadRing* ring = nullptr;
+		for (const auto& r : s_rings) {
+			bool expected = false;
+			if (r->inUse.compare_exchange_strong(expected, true)) {
+				ring = r.get();
+				break;
+			}
+		}
+		if (!ring) {
+			s_rings.emplace_back(std::make_unique<ThreadRing>());
+			ring = s_rings.back().get();
+			ring->inUse = true;
+		}
+
+		ring->tid = GetThreadId();
+		ring->head.store(0, std::memory_order_relaxed);
+
+		return ring;
+	}
+
+	void Enable(bool enable)
+	{
+		if (enable && !s_timeBase.load()) {
+			s_timeBase = GetTimeNs();
+		}
+		g_enabled.store(enable, std::memory_order_relaxed);
+	}
+
+	void Write(Event event, Type type, uint32_t arg)
+	{
+		ThreadRing* ring = t_holder.ring;
+		if (!ring) {
+			ring = t_holder.ring = AcquireRing();
+		}
+
+		// single writer per ring
+		const uint64_t pos = ring->head.load(std::memory_order_relaxed);
+		Record& record = ring->records[pos & (TRACE_RING_SIZE - 1)];
+		record.time     = GetTimeNs();
+		record.event    = event;
+		record.type     = type;
+		record.reserved = 0;
+		record.arg      = arg;
+		ring->head.store(pos + 1, std::memory_order_release);
+	}
+
+	const char* GetEventName(Event event)
+	{
+		static const char* const names[EV_Count] = {
+			"Load",
+			"LoadInit",
+			"LoadPlugins",
+			"PluginLoad",
+			"LoadCache",
+			"LoadOpen",
+			"LoadTags",
+			"FillBuffer",
+			"GetData",
+			"Seek",
+			"Flush",
+			"MetaData",
+			"StreamTitle",
+			"ResourceData",
+			"NetData",
+			"NetStall",
+			"Underrun",
+			"MidiPreload",
+			"ModPrescan",
+		};
+
+		return (event < EV_Count) ? names[event] : "Unknown";
+	}
+
+	std::string ExportChromeJson()
+	{
+#ifdef _WIN32
+		const unsigned pid = GetCurrentProcessId();
+#else
+		const unsigned pid = 1;
+#endif
+		const uint64_t timeBase = s_timeBase.load();
+
+		std::string json;
+		json.reserve(1024 * 1024);
+		json.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+		std::vector<Record> records(TRACE_RING_SIZE);
+		bool first = true;
+		char buf[256];
+
+		std::lock_guard<std::mutex> lock(s_ringsMutex);
+
+		for (const auto& ring : s_rings) {
+			const uint64_t head1 = ring->head.load(std::memory_order_acquire);
+			memcpy(records.data(), ring->records, sizeof(ring->records));
+			const uint64_t head2 = ring->head.load(std::memory_order_acquire);
+
+			// skip the records that may have been overwritten while copying
+			uint64_t start = (head1 > TRACE_RING_SIZE) ? head1 - TRACE_RING_SIZE : 0;
+			if (head2 + 1 > TRACE_RING_SIZE) {
+				start = std::max<uint64_t>(start, head2 + 1 - TRACE_RING_SIZE);
+			}
+
+			for (uint64_t i = start; i < head1; i++) {
+				const Record& r = records[i & (TRACE_RING_SIZE - 1)];
+				if (r.time < timeBase) {
+					continue; // recorded before Clear()
+				}
+				const double ts = (r.time - timeBase) / 1000.0;
+				const char* name = GetEventName((Event)r.event);
+				int len = 0;
+
+				switch (r.type) {
+				case TYPE_BEGIN:
+					len = snprintf(buf, sizeof(buf), "{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u,\"args\":{\"arg\":%u}}",
+						name, ts, pid, ring->tid, r.arg);
+					break;
+				case TYPE_END:
+					len = snprintf(buf, sizeof(buf), "{\"name\":\"%s\",\"ph\":\"E\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u}",
+						name, ts, pid, ring->tid);
+					break;
+				case TYPE_INSTANT:
+					len = snprintf(buf, sizeof(buf), "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u,\"args\":{\"arg\":%u}}",
+						name, ts, pid, ring->tid, r.arg);
+					break;
+				case TYPE_COUNTER:
+					len = snprintf(buf, sizeof(buf), "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u,\"args\":{\"value\":%u}}",
+						name, ts, pid, ring->tid, r.arg);
+					break;
+				}
+
+				if (len > 0) {
+					if (!first) {
+						json.append(",\n");
+					}
+					json.append(buf, len);
+					first = false;
+				}
+			}
+		}
+
+		json.append("\n]}\n");
+
+		return json;
+	}
+
+	void Clear()
+	{
+		std::lock_guard<std::mutex> lock(s_ringsMutex);
+
+		for (const auto& ring : s_rings) {
+			if (!ring->inUse.load()) {
+				ring->head.store(0, std::memory_order_relaxed);
+			}
+		}
+		// the rings of running threads are written without a lock,
+		// their old records are skipped on export by the new time base
+		s_timeBase = GetTimeNs();
+	}
+}
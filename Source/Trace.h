@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <atomic>
+
+//
+// Binary event trace.
+// Every thread writes fixed size records to its own lock-free ring buffer,
+// the rings are collected on demand and exported as Chrome/Perfetto trace JSON
+// (chrome://tracing, https://ui.perfetto.dev).
+// When tracing is disabled, an event costs one relaxed atomic load.
+//
+
+namespace Trace
+{
+	enum Event : uint16_t {
+		EV_Load = 0,
+		EV_LoadInit,
+		EV_LoadPlugins,
+		EV_PluginLoad,     // arg - plugin index
+		EV_LoadCache,
+		EV_LoadOpen,
+		EV_LoadTags,
+		EV_FillBuffer,     // arg - bytes delivered
+		EV_GetData,        // arg - bytes decoded
+		EV_Seek,
+		EV_Flush,
+		EV_MetaData,
+		EV_StreamTitle,
+		EV_ResourceData,   // arg - resource count
+		EV_NetData,        // arg - bytes received
+		EV_NetStall,
+		EV_Underrun,
+		EV_MidiPreload,    // arg - loaded sample bytes
+		EV_ModPrescan,     // arg - module length in milliseconds
+		EV_Count
+	};
+
+	enum Type : uint8_t {
+		TYPE_BEGIN = 0,
+		TYPE_END,
+		TYPE_INSTANT,
+		TYPE_COUNTER,
+	};
+
+	struct Record {
+		uint64_t time;  // nanoseconds, steady clock
+		uint16_t event;
+		uint8_t  type;
+		uint8_t  reserved;
+		uint32_t arg;
+	};
+
+	extern std::atomic<bool> g_enabled;
+
+	inline bool IsEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+	void Enable(bool enable);
+
+	// slow path, called only when tracing is enabled
+	void Write(Event event, Type type, uint32_t arg);
+
+	inline void Begin(Event event, uint32_t arg = 0)   { if (IsEnabled()) { Write(event, TYPE_BEGIN, arg); } }
+	inline void End(Event event, uint32_t arg = 0)     { if (IsEnabled()) { Write(event, TYPE_END, arg); } }
+	inline void Instant(Event event, uint32_t arg = 0) { if (IsEnabled()) { Write(event, TYPE_INSTANT, arg); } }
+	inline void Counter(Event event, uint32_t value)   { if (IsEnabled()) { Write(event, TYPE_COUNTER, value); } }
+
+	class Scope
+	{
+		const Event m_event;
+		const bool m_enabled;
+
+	public:
+		Scope(Event event, uint32_t arg = 0)
+			: m_event(event)
+			, m_enabled(IsEnabled())
+		{
+			if (m_enabled) {
+				Write(m_event, TYPE_BEGIN, arg);
+			}
+		}
+
+		~Scope()
+		{
+			if (m_enabled) {
+				Write(m_event, TYPE_END, 0);
+			}
+		}
+	};
+
+	const char* GetEventName(Event event);
+
+	// Exports the events of all threads in the Chrome trace event format.
+	// Safe to call while other threads are writing; records overwritten during the copy are dropped.
+	std::string ExportChromeJson();
+
+	// drops all recorded events
+	void Clear();
+}
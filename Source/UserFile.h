@@ -0,0 +1,23 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+//
+// Input of a stream that is opened with BASS_StreamCreateFileUser.
+// BassDecoder forwards the BASS file callbacks to it, the calls are made
+// on the thread that reads the file (the decoding thread or the BASS buffering thread).
+//
+
+class UserFile
+{
+public:
+	virtual ~UserFile() = default;
+
+	// 0 if the length is unknown
+	virtual uint64_t GetLength() = 0;
+	// reads from the current position, returns the number of bytes read, 0 at the end of the file or on error
+	virtual size_t Read(void* buffer, size_t size) = 0;
+	virtual bool Seek(uint64_t pos) = 0;
+};
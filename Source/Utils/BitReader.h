@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2026 v0lt
+//
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include "ByteReader.h"
+
+//
+// Bit readers for codec headers.
+// BitReader reads the most significant bit first (MPEG, ADTS, FLAC, Xing/LAME),
+// BitReaderLsb reads the least significant bit first.
+// Reads past the end return zero bits and set the error flag.
+//
+
+template <bool msb>
+class BasicBitReader
+{
+	const uint8_t* m_data = nullptr;
+	size_t m_bitSize = 0;
+	size_t m_bitPos = 0;
+
+	bool m_error = false;
+
+	// n <= 32, m_bitPos + n <= m_bitSize
+	uint32_t Peek(unsigned n) const
+	{
+		if (n == 0) {
+			return 0;
+		}
+
+		const size_t bytePos = m_bitPos >> 3;
+		const unsigned shift = m_bitPos & 7;
+		uint64_t cache;
+
+		if (bytePos + 8 <= (m_bitSize + 7) >> 3) {
+			cache = bytes::load<uint64_t>(m_data + bytePos);
+			if constexpr (msb) {
+				cache = bytes::bswap(cache);
+			}
+		}
+		else {
+			// near the end of the buffer
+			cache = 0;
+			const size_t count = ((m_bitSize + 7) >> 3) - bytePos;
+			for (size_t i = 0; i < count; i++) {
+				if constexpr (msb) {
+					cache |= uint64_t(m_data[bytePos + i]) << (56 - 8 * i);
+				}
+				else {
+					cache |= uint64_t(m_data[bytePos + i]) << (8 * i);
+				}
+			}
+		}
+
+		if constexpr (msb) {
+			return uint32_t((cache << shift) >> (64 - n));
+		}
+		else {
+			return uint32_t((cache >> shift) & ((uint64_t(1) << n) - 1));
+		}
+	}
+
+public:
+	BasicBitReader(const uint8_t* data, size_t size)
+		: m_data(data)
+		, m_bitSize(size * 8)
+	{
+		assert(data || !size);
+	}
+
+	bool GetError() const { return m_error; }
+
+	size_t GetBitPos() const { return m_bitPos; }
+	size_t GetBitsLeft() const { return m_bitSize - m_bitPos; }
+
+	// pointer to the byte containing the current bit
+	const uint8_t* GetPtr() const { return m_data + (m_bitPos >> 3); }
+
+	// n <= 32
+	uint32_t ShowBits(unsigned n)
+	{
+		assert(n <= 32);
+		if (n > GetBitsLeft()) {
+			m_error = true;
+			return 0;
+		}
+		return Peek(n);
+	}
+
+	// n <= 32
+	uint32_t ReadBits(unsigned n)
+	{
+		assert(n <= 32);
+		if (n > GetBitsLeft()) {
+			m_bitPos = m_bitSize;
+			m_error = true;
+			return 0;
+		}
+		const uint32_t value = Peek(n);
+		m_bitPos += n;
+		return value;
+	}
+
+	// n <= 64
+	uint64_t ReadBits64(unsigned n)
+	{
+		assert(n <= 64);
+		if (n <= 32) {
+			return ReadBits(n);
+		}
+		if constexpr (msb) {
+			const uint64_t hi = ReadBits(n - 32);
+			return (hi << 32) | ReadBits(32);
+		}
+		else {
+			const uint64_t lo = ReadBits(32);
+			return lo | (uint64_t(ReadBits(n - 32)) << 32);
+		}
+	}
+
+	bool ReadBit()
+	{
+		return ReadBits(1) != 0;
+	}
+
+	bool SkipBits(size_t n)
+	{
+		if (n > GetBitsLeft()) {
+			m_bitPos = m_bitSize;
+			m_error = true;
+			return false;
+		}
+		m_bitPos += n;
+		return true;
+	}
+
+	void ByteAlign()
+	{
+		m_bitPos = std::min((m_bitPos + 7) & ~size_t(7), m_bitSize);
+	}
+};
+
+typedef BasicBitReader<true>  BitReader;
+typedef BasicBitReader<false> BitReaderLsb;
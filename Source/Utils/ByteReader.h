@@ -1,5 +1,5 @@
 //
-// Copyright (c) 2022-2025 v0lt
+// Copyright (c) 2022-2026 v0lt
 //
 // SPDX-License-Identifier: MIT
 //
@@ -7,6 +7,84 @@
 #pragma once
 
 #include <cassert>
+#include <cstring>
+
+namespace bytes
+{
+	template<typename T>
+	inline T load(const uint8_t* p)
+	{
+		T value;
+		memcpy(&value, p, sizeof(T));
+		return value;
+	}
+
+	inline uint16_t bswap(uint16_t v) { return _byteswap_ushort(v); }
+	inline uint32_t bswap(uint32_t v) { return _byteswap_ulong(v); }
+	inline uint64_t bswap(uint64_t v) { return _byteswap_uint64(v); }
+
+	inline uint16_t load16be(const uint8_t* p) { return bswap(load<uint16_t>(p)); }
+	inline uint32_t load32be(const uint8_t* p) { return bswap(load<uint32_t>(p)); }
+	inline uint64_t load64be(const uint8_t* p) { return bswap(load<uint64_t>(p)); }
+
+	inline uint32_t load24le(const uint8_t* p)
+	{
+		return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16);
+	}
+
+	inline uint32_t load24be(const uint8_t* p)
+	{
+		return (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | uint32_t(p[2]);
+	}
+}
+
+//
+// A region that was validated once by ByteReader::GetSpan().
+// Reads inside the span are not bounds checked (only asserted in debug builds).
+//
+
+class ByteSpan
+{
+	const uint8_t* m_pos = nullptr;
+	const uint8_t* m_end = nullptr;
+
+	const uint8_t* Advance(size_t size)
+	{
+		assert(size <= size_t(m_end - m_pos));
+		const uint8_t* p = m_pos;
+		m_pos += size;
+		return p;
+	}
+
+public:
+	ByteSpan() = default;
+	ByteSpan(const uint8_t* data, size_t size)
+		: m_pos(data)
+		, m_end(data + size)
+	{
+	}
+
+	explicit operator bool() const { return m_pos != nullptr; }
+
+	const uint8_t* GetPtr() const { return m_pos; }
+	size_t GetRemainder() const { return m_end - m_pos; }
+
+	void Skip(size_t size) { Advance(size); }
+
+	uint8_t  ReadByte() { return *Advance(1); }
+
+	uint16_t Read16Le() { return bytes::load<uint16_t>(Advance(2)); }
+	uint32_t Read24Le() { return bytes::load24le(Advance(3)); }
+	uint32_t Read32Le() { return bytes::load<uint32_t>(Advance(4)); }
+	uint64_t Read64Le() { return bytes::load<uint64_t>(Advance(8)); }
+
+	uint16_t Read16Be() { return bytes::load16be(Advance(2)); }
+	uint32_t Read24Be() { return bytes::load24be(Advance(3)); }
+	uint32_t Read32Be() { return bytes::load32be(Advance(4)); }
+	uint64_t Read64Be() { return bytes::load64be(Advance(8)); }
+
+	void ReadBytes(void* dst, size_t size) { memcpy(dst, Advance(size), size); }
+};
 
 class ByteReader
 {
@@ -16,30 +94,35 @@ class ByteReader
 
 	bool m_error = false;
 
-	template<typename T>
-	T Read()
+	// returns the current position and advances it, or nullptr if there is not enough data
+	const uint8_t* Advance(size_t size)
 	{
-		if (m_pos + sizeof(T) <= m_end) {
-			T value = *(T*)m_pos;
-			m_pos += sizeof(T);
+		if (size <= size_t(m_end - m_pos)) {
+			const uint8_t* p = m_pos;
+			m_pos += size;
 
-			return value;
+			return p;
 		}
 		else {
 			m_pos = m_end;
 			m_error = true;
 
-			return 0;
+			return nullptr;
 		}
 	}
 
 	template<typename T>
-	T Look()
+	T Read()
 	{
-		if (m_pos + sizeof(T) <= m_end) {
-			T value = *(T*)m_pos;
+		const uint8_t* p = Advance(sizeof(T));
+		return p ? bytes::load<T>(p) : 0;
+	}
 
-			return value;
+	template<typename T>
+	T Look()
+	{
+		if (sizeof(T) <= size_t(m_end - m_pos)) {
+			return bytes::load<T>(m_pos);
 		}
 		else {
 			m_error = true;
@@ -48,11 +131,36 @@ class ByteReader
 		}
 	}
 
+	template<typename T, bool swap>
+	bool ReadArray(T* dst, size_t count)
+	{
+		if (count > GetRemainder() / sizeof(T)) {
+			m_pos = m_end;
+			m_error = true;
+
+			return false;
+		}
+
+		if constexpr (swap) {
+			const uint8_t* p = m_pos;
+			for (size_t i = 0; i < count; i++) {
+				dst[i] = bytes::bswap(bytes::load<T>(p));
+				p += sizeof(T);
+			}
+		}
+		else {
+			memcpy(dst, m_pos, count * sizeof(T));
+		}
+		m_pos += count * sizeof(T);
+
+		return true;
+	}
+
 public:
 	ByteReader(const uint8_t* data)
 		: m_start(data)
-		, m_pos(data)
 		, m_end(data)
+		, m_pos(data)
 	{
 		assert(data);
 	}
@@ -84,23 +192,14 @@ public:
 
 	bool Skip(size_t size)
 	{
-		m_pos += size;
-
-		if (m_pos <= m_end) {
-			return true;
-		}
-
-		m_pos = m_end;
-		m_error = true;
-
-		return false;
+		return Advance(size) != nullptr;
 	}
 
 	bool Seek(size_t pos)
 	{
-		m_pos = m_start + pos;
+		if (pos <= GetSize()) {
+			m_pos = m_start + pos;
 
-		if (m_pos <= m_end) {
 			return true;
 		}
 
@@ -115,6 +214,14 @@ public:
 		return m_error;
 	}
 
+	// Checks that 'size' bytes are available once and returns them as a span for unchecked reads.
+	// The reader position is moved past the span. On failure an empty span is returned and the error is set.
+	ByteSpan GetSpan(size_t size)
+	{
+		const uint8_t* p = Advance(size);
+		return p ? ByteSpan(p, size) : ByteSpan();
+	}
+
 	uint8_t ReadByte()
 	{
 		if (m_pos < m_end) {
@@ -141,49 +248,34 @@ public:
 	uint32_t Read32Le() { return Read<uint32_t>(); }
 	uint64_t Read64Le() { return Read<uint64_t>(); }
 
-	uint16_t Read16Be() { return _byteswap_ushort(Read<uint16_t>()); }
-	uint32_t Read32Be() { return _byteswap_ulong(Read<uint32_t>()); }
-	uint64_t Read64Be() { return _byteswap_uint64(Read<uint64_t>()); }
-
-	uint32_t Read24Le() {
-		if (m_pos + 3 <= m_end) {
-			uint32_t value =
-				uint32_t(m_pos[0]) |
-				(uint32_t(m_pos[0]) << 8) |
-				(uint32_t(m_pos[0]) >> 16);
-			m_pos += 3;
+	uint16_t Read16Be() { return bytes::bswap(Read<uint16_t>()); }
+	uint32_t Read32Be() { return bytes::bswap(Read<uint32_t>()); }
+	uint64_t Read64Be() { return bytes::bswap(Read<uint64_t>()); }
 
-			return value;
-		}
-		else {
-			m_pos = m_end;
-			m_error = true;
-
-			return 0;
-		}
+	uint32_t Read24Le()
+	{
+		const uint8_t* p = Advance(3);
+		return p ? bytes::load24le(p) : 0;
 	}
 
-	uint32_t Read24Be() {
-		if (m_pos + 3 <= m_end) {
-			uint32_t value =
-				(uint32_t(m_pos[0]) << 16) |
-				(uint32_t(m_pos[0]) << 8) |
-				(uint32_t(m_pos[0]));
-			m_pos += 3;
+	uint32_t Read24Be()
+	{
+		const uint8_t* p = Advance(3);
+		return p ? bytes::load24be(p) : 0;
+	}
 
-			return value;
-		}
-		else {
-			m_pos = m_end;
-			m_error = true;
+	//
+	// bulk reads, the whole array is checked once
+	//
 
-			return 0;
-		}
-	}
+	bool ReadArray16Le(uint16_t* dst, size_t count) { return ReadArray<uint16_t, false>(dst, count); }
+	bool ReadArray32Le(uint32_t* dst, size_t count) { return ReadArray<uint32_t, false>(dst, count); }
+	bool ReadArray16Be(uint16_t* dst, size_t count) { return ReadArray<uint16_t, true>(dst, count); }
+	bool ReadArray32Be(uint32_t* dst, size_t count) { return ReadArray<uint32_t, true>(dst, count); }
 
 	bool ReadBytes(void* dst, size_t size)
 	{
-		if (m_pos + size <= m_end) {
+		if (size <= GetRemainder()) {
 			memcpy(dst, m_pos, size);
 			m_pos += size;
 
@@ -0,0 +1,258 @@
+//
+// Copyright (c) 2026 v0lt
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "stdafx.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include "Log.h"
+
+#define LOG_QUEUE_SIZE 1024 // entries, must be a power of two
+
+namespace Log
+{
+	// Bounded MPMC queue (D. Vyukov), used here with a single consumer.
+	// A producer reserves a cell with one CAS, the cell sequence publishes it to the consumer.
+	struct Cell {
+		Entry entry; // first member, Commit() gets the cell from the entry pointer
+		std::atomic<uint64_t> sequence;
+	};
+
+	static Cell s_cells[LOG_QUEUE_SIZE];
+	static std::atomic<uint64_t> s_enqueuePos = 0;
+	static uint64_t s_dequeuePos = 0;
+	static std::atomic<uint64_t> s_dropped = 0;
+
+	static std::mutex s_threadMutex;
+	static std::thread s_thread;
+	static std::atomic<bool> s_running = false;
+	static std::atomic<bool> s_stop = false;
+	static std::atomic<bool> s_shutdown = false; // after Shutdown() the thread is not started
+	static uint64_t s_timeBase = 0;
+
+	static void ThreadProc();
+
+	// The logger thread must not be joined from the static destructors of a DLL,
+	// there the loader lock is held and at process exit the thread is already terminated.
+	// BassSource calls Shutdown() when the last filter instance is destroyed,
+	// later messages (registry notifications, background scans) do not start the thread again.
+	static struct ThreadGuard {
+		~ThreadGuard()
+		{
+			if (s_thread.joinable()) {
+#ifdef _WIN32
+				s_thread.detach();
+#else
+				s_stop = true;
+				s_thread.join();
+#endif
+			}
+		}
+	} s_threadGuard;
+
+	static uint64_t GetTimeNs()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static uint32_t GetThreadId()
+	{
+#ifdef _WIN32
+		return GetCurrentThreadId();
+#else
+		static std::atomic<uint32_t> s_nextId = 1;
+		static thread_local uint32_t t_id = s_nextId++;
+		return t_id;
+#endif
+	}
+
+	static void Output(Level level, const std::wstring& str)
+	{
+#ifdef _WIN32
+#ifdef _DEBUG
+		DbgLogInfo((level == LEVEL_ERROR) ? LOG_ERROR : LOG_TRACE, (level == LEVEL_ERROR) ? 1 : 3, L"%s", str.c_str());
+#else
+		OutputDebugStringW((str + L'\n').c_str());
+#endif
+#else
+		const int len = WideCharToMultiByte(CP_UTF8, 0, str.c_str(), (int)str.size(), nullptr, 0, nullptr, nullptr);
+		std::string utf8(len, '\0');
+		WideCharToMultiByte(CP_UTF8, 0, str.c_str(), (int)str.size(), utf8.data(), len, nullptr, nullptr);
+		fprintf((level <= LEVEL_WARNING) ? stderr : stdout, "%s\n", utf8.c_str());
+#endif
+	}
+
+	static bool ProcessEntry(std::wstring& str)
+	{
+		Cell& cell = s_cells[s_dequeuePos & (LOG_QUEUE_SIZE - 1)];
+		if (cell.sequence.load(std::memory_order_acquire) != s_dequeuePos + 1) {
+			return false;
+		}
+
+		const Entry& entry = cell.entry;
+		static const wchar_t* const levelStr[] = { L"", L"ERROR: ", L"WARNING: ", L"", L"" };
+
+		// the time of the call, not of the output
+		wchar_t prefix[64];
+		swprintf(prefix, std::size(prefix), L"%10.3f [%u] %ls",
+			(entry.time > s_timeBase ? entry.time - s_timeBase : 0) / 1e6, entry.tid, levelStr[entry.level <= LEVEL_DEBUG ? entry.level : 0]);
+		str.assign(prefix);
+		try {
+			entry.format(entry, str);
+		}
+		catch (...) {
+			str.append(L"<format error>");
+		}
+		const Level level = entry.level;
+
+		cell.sequence.store(s_dequeuePos + LOG_QUEUE_SIZE, std::memory_order_release);
+		s_dequeuePos++;
+
+		Output(level, str);
+
+		return true;
+	}
+
+	static void ThreadProc()
+	{
+#ifdef _WIN32
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#endif
+		std::wstring str;
+		str.reserve(LOG_ENTRY_SIZE);
+
+		for (;;) {
+			bool processed = false;
+			while (ProcessEntry(str)) {
+				processed = true;
+			}
+
+			const uint64_t dropped = s_dropped.exchange(0);
+			if (dropped) {
+				Output(LEVEL_WARNING, std::to_wstring(dropped) + L" log messages dropped, the queue is full");
+			}
+
+			if (!processed) {
+				if (s_stop.load()) {
+					break;
+				}
+				// the producers do not signal the consumer, so they never make a system call
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			}
+		}
+	}
+
+	// the queue cells are initialized once, also when the thread is never started
+	static void InitQueue()
+	{
+		if (!s_timeBase) {
+			for (uint64_t i = 0; i < LOG_QUEUE_SIZE; i++) {
+				s_cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+			s_timeBase = GetTimeNs();
+		}
+	}
+
+	static void Start()
+	{
+		std::lock_guard<std::mutex> lock(s_threadMutex);
+
+		if (s_running.load() || s_shutdown.load()) {
+			return;
+		}
+		InitQueue();
+
+		s_stop = false;
+		s_thread = std::thread(ThreadProc);
+		s_running.store(true, std::memory_order_release);
+	}
+
+	// prints the committed entries on the calling thread when the logger thread is not running
+	static void Drain()
+	{
+		std::lock_guard<std::mutex> lock(s_threadMutex);
+
+		if (!s_running.load()) {
+			std::wstring str;
+			while (ProcessEntry(str)) {
+			}
+		}
+	}
+
+	void Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_threadMutex);
+
+			InitQueue();
+			s_shutdown = true;
+			if (s_running.load()) {
+				s_stop = true;
+				s_thread.join();
+				s_running = false;
+			}
+		}
+		// the entries that were committed while the thread was stopping
+		Drain();
+	}
+
+	void Resume()
+	{
+		s_shutdown = false;
+	}
+
+	Entry* Acquire(Level level)
+	{
+		if (!s_running.load(std::memory_order_acquire) && !s_shutdown.load()) {
+			Start();
+		}
+
+		uint64_t pos = s_enqueuePos.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell& cell = s_cells[pos & (LOG_QUEUE_SIZE - 1)];
+			const int64_t diff = (int64_t)(cell.sequence.load(std::memory_order_acquire) - pos);
+			if (diff == 0) {
+				if (s_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					Entry& entry = cell.entry;
+					entry.time  = GetTimeNs();
+					entry.tid   = GetThreadId();
+					entry.level = level;
+					return &entry;
+				}
+			}
+			else if (diff < 0) {
+				s_dropped++;
+				return nullptr;
+			}
+			else {
+				pos = s_enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void Commit(Entry* entry)
+	{
+		Cell* cell = reinterpret_cast<Cell*>(entry);
+		const uint64_t pos = cell->sequence.load(std::memory_order_relaxed);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+
+		if (!s_running.load(std::memory_order_acquire)) {
+			Drain();
+		}
+	}
+
+	void AppendUtf8(std::wstring& out, std::string_view str)
+	{
+		const int len = MultiByteToWideChar(CP_UTF8, 0, str.data(), (int)str.size(), nullptr, 0);
+		if (len > 0) {
+			const size_t pos = out.size();
+			out.resize(pos + len);
+			MultiByteToWideChar(CP_UTF8, 0, str.data(), (int)str.size(), out.data() + pos, len);
+		}
+	}
+}
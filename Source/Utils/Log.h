@@ -0,0 +1,277 @@
+//
+// Copyright (c) 2026 v0lt
+//
+// SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+//
+// Deferred debug log.
+// The calling thread copies the format string pointer and the arguments into
+// a lock-free queue, formatting and output are done on a background thread.
+// Messages above DLOG_LEVEL are removed at compile time, the arguments are not evaluated.
+// When the queue is full, messages are dropped and counted.
+//
+
+#define DLOG_LEVEL_NONE    0
+#define DLOG_LEVEL_ERROR   1
+#define DLOG_LEVEL_WARNING 2
+#define DLOG_LEVEL_INFO    3
+#define DLOG_LEVEL_DEBUG   4
+
+// define DLOG_LEVEL in the project settings for diagnostic release builds
+#ifndef DLOG_LEVEL
+#if defined(_DEBUG) && defined(_WIN32)
+#define DLOG_LEVEL DLOG_LEVEL_DEBUG
+#else
+#define DLOG_LEVEL DLOG_LEVEL_NONE
+#endif
+#endif
+
+#if DLOG_LEVEL > DLOG_LEVEL_NONE
+#if __has_include(<format>)
+#include <format>
+#else
+#error "DLOG_LEVEL requires <format>"
+#endif
+#endif
+
+#define LOG_ENTRY_SIZE 512 // bytes, a message with longer strings is formatted on the calling thread and split
+
+namespace Log
+{
+	enum Level : uint8_t {
+		LEVEL_ERROR = DLOG_LEVEL_ERROR,
+		LEVEL_WARNING,
+		LEVEL_INFO,
+		LEVEL_DEBUG,
+	};
+
+	struct Entry;
+
+	// formats an entry on the logger thread
+	typedef void (*FormatFn)(const Entry& entry, std::wstring& out);
+
+	struct Entry {
+		uint64_t    time; // nanoseconds, steady clock
+		uint32_t    tid;
+		Level       level;
+		FormatFn    format;
+		const void* fmt;     // format string literal
+		size_t      fmtSize; // in characters
+		alignas(8) uint8_t payload[LOG_ENTRY_SIZE - 40];
+	};
+
+	// string argument copied into Entry::payload
+	struct StrRef {
+		uint16_t offset; // in bytes
+		uint16_t size;   // in characters
+	};
+
+	// returns a free entry or nullptr if the queue is full, must be followed by Commit()
+	Entry* Acquire(Level level);
+	void Commit(Entry* entry);
+
+	// Formats and prints the remaining messages and stops the logger thread.
+	// Until Resume() the messages are formatted and printed on the calling thread,
+	// so a message from a callback does not start a thread that outlives the DLL.
+	void Shutdown();
+	// allows the logger thread to start again, called when a filter instance is created
+	void Resume();
+
+	void AppendUtf8(std::wstring& out, std::string_view str);
+
+	template <typename CharT, typename T>
+	constexpr bool IsStrArg = std::is_convertible_v<const T&, std::basic_string_view<CharT>>;
+
+	// type of the copy of an argument, void if the argument can not be copied as is
+	template <typename CharT, typename T>
+	using StoredArg = std::conditional_t<IsStrArg<CharT, T>, StrRef,
+		std::conditional_t<std::is_arithmetic_v<T>, T,
+		std::conditional_t<std::is_pointer_v<T> || std::is_null_pointer_v<T>, const void*,
+		void>>>;
+
+	template <typename CharT, typename T>
+	inline StoredArg<CharT, T> StoreArg(const T& arg, Entry& entry, size_t& strPos)
+	{
+		if constexpr (IsStrArg<CharT, T>) {
+			std::basic_string_view<CharT> str;
+			if constexpr (std::is_pointer_v<T>) {
+				if (arg) {
+					str = arg;
+				}
+			}
+			else {
+				str = arg;
+			}
+			const size_t size = std::min(str.size(), (sizeof(entry.payload) - strPos) / sizeof(CharT));
+			memcpy(entry.payload + strPos, str.data(), size * sizeof(CharT));
+			const StrRef ref = { (uint16_t)strPos, (uint16_t)size };
+			strPos += size * sizeof(CharT);
+			return ref;
+		}
+		else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+			return (const void*)arg;
+		}
+		else {
+			return arg;
+		}
+	}
+
+	// bytes of a string argument in Entry::payload
+	template <typename CharT, typename T>
+	inline size_t StrArgSize(const T& arg)
+	{
+		if constexpr (IsStrArg<CharT, T>) {
+			if constexpr (std::is_pointer_v<T>) {
+				return arg ? std::char_traits<CharT>::length(arg) * sizeof(CharT) : 0;
+			}
+			else {
+				return std::basic_string_view<CharT>(arg).size() * sizeof(CharT);
+			}
+		}
+		else {
+			return 0;
+		}
+	}
+
+#if DLOG_LEVEL > DLOG_LEVEL_NONE
+
+	template <typename CharT, typename... Stored>
+	void FormatEntry(const Entry& entry, std::wstring& out)
+	{
+		const auto& stored = *reinterpret_cast<const std::tuple<Stored...>*>(entry.payload);
+		const std::basic_string_view<CharT> fmt((const CharT*)entry.fmt, entry.fmtSize);
+
+		auto unwrap = [&entry](const auto& arg) {
+			if constexpr (std::is_same_v<std::decay_t<decltype(arg)>, StrRef>) {
+				return std::basic_string_view<CharT>((const CharT*)(entry.payload + arg.offset), arg.size);
+			}
+			else {
+				return arg;
+			}
+		};
+
+		std::apply([&](const auto&... storedArgs) {
+			auto args = std::make_tuple(unwrap(storedArgs)...);
+			std::apply([&](auto&... a) {
+				if constexpr (std::is_same_v<CharT, wchar_t>) {
+					out += std::vformat(fmt, std::make_wformat_args(a...));
+				}
+				else {
+					AppendUtf8(out, std::vformat(fmt, std::make_format_args(a...)));
+				}
+			}, args);
+		}, stored);
+	}
+
+	template <typename CharT>
+	constexpr std::basic_string_view<CharT> StrFormat()
+	{
+		if constexpr (std::is_same_v<CharT, wchar_t>) {
+			return L"{}";
+		}
+		else {
+			return "{}";
+		}
+	}
+
+	template <typename CharT, typename... Args>
+	std::basic_string<CharT> FormatInline(std::basic_string_view<CharT> fmt, const Args&... args)
+	{
+		using Context = std::conditional_t<std::is_same_v<CharT, wchar_t>, std::wformat_context, std::format_context>;
+		return std::vformat(fmt, std::make_format_args<Context>(args...));
+	}
+
+	template <typename CharT>
+	void WriteSplit(Level level, std::basic_string_view<CharT> str);
+
+	template <typename CharT, typename... Args>
+	void WriteDeferred(Level level, std::basic_string_view<CharT> fmt, const Args&... args)
+	{
+		if constexpr ((std::is_void_v<StoredArg<CharT, std::remove_cvref_t<Args>>> || ...)) {
+			// an argument without a trivial copy, format it on the calling thread
+			WriteSplit<CharT>(level, FormatInline<CharT>(fmt, args...));
+		}
+		else {
+			using Stored = std::tuple<StoredArg<CharT, std::remove_cvref_t<Args>>...>;
+			static_assert(sizeof(Stored) < sizeof(Entry::payload));
+
+			size_t strPos = (sizeof(Stored) + alignof(CharT) - 1) & ~(alignof(CharT) - 1);
+			if (strPos + (StrArgSize<CharT>(args) + ... + 0) > sizeof(Entry::payload)) {
+				// the strings do not fit into one entry
+				WriteSplit<CharT>(level, FormatInline<CharT>(fmt, args...));
+				return;
+			}
+
+			Entry* entry = Acquire(level);
+			if (!entry) {
+				return;
+			}
+			entry->format  = FormatEntry<CharT, StoredArg<CharT, std::remove_cvref_t<Args>>...>;
+			entry->fmt     = fmt.data();
+			entry->fmtSize = fmt.size();
+
+			new (entry->payload) Stored{ StoreArg<CharT>(args, *entry, strPos)... };
+
+			Commit(entry);
+		}
+	}
+
+	// writes a formatted message in as many entries as needed, a character is not split between them
+	template <typename CharT>
+	void WriteSplit(Level level, std::basic_string_view<CharT> str)
+	{
+		constexpr size_t capacity = (sizeof(Entry::payload) - sizeof(std::tuple<StrRef>)) / sizeof(CharT);
+
+		do {
+			size_t size = std::min(str.size(), capacity);
+			if (size < str.size()) {
+				auto IsContinuation = [](const CharT ch) {
+					if constexpr (std::is_same_v<CharT, wchar_t>) {
+						return ch >= 0xDC00 && ch <= 0xDFFF; // low surrogate
+					}
+					else {
+						return ((uint8_t)ch & 0xC0) == 0x80;
+					}
+				};
+				while (size > 1 && IsContinuation(str[size])) {
+					size--;
+				}
+			}
+			WriteDeferred<CharT>(level, StrFormat<CharT>(), str.substr(0, size));
+			str.remove_prefix(size);
+		} while (str.size());
+	}
+
+	template <typename... Args>
+	inline void Write(Level level, std::wformat_string<Args...> fmt, Args&&... args)
+	{
+		WriteDeferred<wchar_t>(level, fmt.get(), args...);
+	}
+
+	template <typename... Args>
+	inline void Write(Level level, std::format_string<Args...> fmt, Args&&... args)
+	{
+		WriteDeferred<char>(level, fmt.get(), args...);
+	}
+
+	inline void Write(Level level, std::wstring_view str)
+	{
+		WriteDeferred<wchar_t>(level, StrFormat<wchar_t>(), str);
+	}
+
+	inline void Write(Level level, std::string_view str)
+	{
+		WriteDeferred<char>(level, StrFormat<char>(), str);
+	}
+
+#endif // DLOG_LEVEL > DLOG_LEVEL_NONE
+}
@@ -0,0 +1,260 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+
+#ifndef _WIN32
+
+#include "Platform.h"
+
+// decodes one UTF-8 sequence, returns the number of bytes used or 0 if the sequence is invalid
+static int DecodeUtf8(const uint8_t* p, const uint8_t* end, uint32_t& cp)
+{
+	const uint8_t c = p[0];
+	int len;
+	uint32_t min;
+
+	if (c < 0x80) {
+		cp = c;
+		return 1;
+	}
+	else if ((c & 0xE0) == 0xC0) {
+		cp = c & 0x1F;
+		len = 2;
+		min = 0x80;
+	}
+	else if ((c & 0xF0) == 0xE0) {
+		cp = c & 0x0F;
+		len = 3;
+		min = 0x800;
+	}
+	else if ((c & 0xF8) == 0xF0) {
+		cp = c & 0x07;
+		len = 4;
+		min = 0x10000;
+	}
+	else {
+		return 0;
+	}
+
+	if (end - p < len) {
+		return 0;
+	}
+	for (int i = 1; i < len; i++) {
+		if ((p[i] & 0xC0) != 0x80) {
+			return 0;
+		}
+		cp = (cp << 6) | (p[i] & 0x3F);
+	}
+
+	if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+		return 0;
+	}
+
+	return len;
+}
+
+// returns the number of wchar_t needed for the code point
+static int PutWide(uint32_t cp, wchar_t* dst, int& pos, int size)
+{
+	if constexpr (sizeof(wchar_t) == 2) {
+		if (cp >= 0x10000) {
+			if (dst) {
+				if (pos + 2 > size) {
+					return 0;
+				}
+				cp -= 0x10000;
+				dst[pos++] = (wchar_t)(0xD800 | (cp >> 10));
+				dst[pos++] = (wchar_t)(0xDC00 | (cp & 0x3FF));
+			}
+			else {
+				pos += 2;
+			}
+			return 2;
+		}
+	}
+
+	if (dst) {
+		if (pos + 1 > size) {
+			return 0;
+		}
+		dst[pos] = (wchar_t)cp;
+	}
+	pos++;
+
+	return 1;
+}
+
+int MultiByteToWideChar(UINT CodePage, DWORD dwFlags, LPCSTR lpMultiByteStr, int cbMultiByte, LPWSTR lpWideCharStr, int cchWideChar)
+{
+	if (!lpMultiByteStr || cbMultiByte == 0 || (CodePage != CP_ACP && CodePage != CP_UTF8)) {
+		return 0;
+	}
+
+	const uint8_t* p = (const uint8_t*)lpMultiByteStr;
+	const uint8_t* end = p + ((cbMultiByte < 0) ? strlen(lpMultiByteStr) + 1 : (size_t)cbMultiByte);
+	LPWSTR dst = cchWideChar ? lpWideCharStr : nullptr;
+	int pos = 0;
+
+	while (p < end) {
+		uint32_t cp;
+		int len = 1;
+
+		if (CodePage == CP_UTF8) {
+			len = DecodeUtf8(p, end, cp);
+			if (len == 0) {
+				if (dwFlags & MB_ERR_INVALID_CHARS) {
+					return 0;
+				}
+				cp = 0xFFFD;
+				len = 1;
+			}
+		}
+		else {
+			cp = *p; // ISO-8859-1
+		}
+
+		if (!PutWide(cp, dst, pos, cchWideChar)) {
+			return 0; // insufficient buffer
+		}
+		p += len;
+	}
+
+	return pos;
+}
+
+int WideCharToMultiByte(UINT CodePage, DWORD /*dwFlags*/, LPCWSTR lpWideCharStr, int cchWideChar, LPSTR lpMultiByteStr, int cbMultiByte, LPCSTR lpDefaultChar, BOOL* lpUsedDefaultChar)
+{
+	if (!lpWideCharStr || cchWideChar == 0 || (CodePage != CP_ACP && CodePage != CP_UTF8)) {
+		return 0;
+	}
+
+	const wchar_t* p = lpWideCharStr;
+	const wchar_t* end = p + ((cchWideChar < 0) ? wcslen(lpWideCharStr) + 1 : (size_t)cchWideChar);
+	uint8_t* dst = cbMultiByte ? (uint8_t*)lpMultiByteStr : nullptr;
+	int pos = 0;
+
+	if (lpUsedDefaultChar) {
+		*lpUsedDefaultChar = FALSE;
+	}
+
+	while (p < end) {
+		uint32_t cp = (uint32_t)*p++;
+		if constexpr (sizeof(wchar_t) == 2) {
+			if (cp >= 0xD800 && cp <= 0xDBFF && p < end && (uint32_t)*p >= 0xDC00 && (uint32_t)*p <= 0xDFFF) {
+				cp = 0x10000 + ((cp - 0xD800) << 10) + ((uint32_t)*p++ - 0xDC00);
+			}
+		}
+
+		uint8_t buf[4];
+		int len = 0;
+
+		if (CodePage == CP_UTF8) {
+			if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+				cp = 0xFFFD;
+			}
+			if (cp < 0x80) {
+				buf[len++] = (uint8_t)cp;
+			}
+			else if (cp < 0x800) {
+				buf[len++] = (uint8_t)(0xC0 | (cp >> 6));
+				buf[len++] = (uint8_t)(0x80 | (cp & 0x3F));
+			}
+			else if (cp < 0x10000) {
+				buf[len++] = (uint8_t)(0xE0 | (cp >> 12));
+				buf[len++] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+				buf[len++] = (uint8_t)(0x80 | (cp & 0x3F));
+			}
+			else {
+				buf[len++] = (uint8_t)(0xF0 | (cp >> 18));
+				buf[len++] = (uint8_t)(0x80 | ((cp >> 12) & 0x3F));
+				buf[len++] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+				buf[len++] = (uint8_t)(0x80 | (cp & 0x3F));
+			}
+		}
+		else if (cp <= 0xFF) {
+			buf[len++] = (uint8_t)cp;
+		}
+		else {
+			buf[len++] = lpDefaultChar ? (uint8_t)*lpDefaultChar : '?';
+			if (lpUsedDefaultChar) {
+				*lpUsedDefaultChar = TRUE;
+			}
+		}
+
+		if (dst) {
+			if (pos + len > cbMultiByte) {
+				return 0; // insufficient buffer
+			}
+			memcpy(dst + pos, buf, len);
+		}
+		pos += len;
+	}
+
+	return pos;
+}
+
+BOOL CryptStringToBinaryA(LPCSTR pszString, DWORD cchString, DWORD dwFlags, BYTE* pbBinary, DWORD* pcbBinary, DWORD* pdwSkip, DWORD* pdwFlags)
+{
+	if (!pszString || !pcbBinary || dwFlags != CRYPT_STRING_BASE64) {
+		return FALSE;
+	}
+
+	static const auto decodeTable = []() {
+		struct { int8_t v[256]; } table;
+		memset(table.v, -1, sizeof(table.v));
+		const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		for (int i = 0; i < 64; i++) {
+			table.v[(uint8_t)alphabet[i]] = (int8_t)i;
+		}
+		return table;
+	}();
+
+	const size_t len = cchString ? cchString : strlen(pszString);
+
+	uint32_t accum = 0;
+	int bits = 0;
+	DWORD count = 0;
+	bool padding = false;
+
+	for (size_t i = 0; i < len; i++) {
+		const uint8_t c = (uint8_t)pszString[i];
+		if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+			continue;
+		}
+		if (c == '=') {
+			padding = true;
+			continue;
+		}
+		const int v = decodeTable.v[c];
+		if (v < 0 || padding) {
+			return FALSE;
+		}
+
+		accum = (accum << 6) | (uint32_t)v;
+		bits += 6;
+		if (bits >= 8) {
+			bits -= 8;
+			if (pbBinary) {
+				if (count >= *pcbBinary) {
+					return FALSE;
+				}
+				pbBinary[count] = (BYTE)(accum >> bits);
+			}
+			count++;
+		}
+	}
+
+	*pcbBinary = count;
+	if (pdwSkip) {
+		*pdwSkip = 0;
+	}
+	if (pdwFlags) {
+		*pdwFlags = CRYPT_STRING_BASE64;
+	}
+
+	return TRUE;
+}
+
+#endif // !_WIN32
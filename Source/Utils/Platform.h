@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+//
+// Minimal replacements for the Win32 API used by the portable core
+// (tag parsers, string utilities) when it is built outside of Windows.
+//
+// Note: wchar_t is 32-bit on Linux, so wide strings hold UTF-32 there.
+// CP_ACP is treated as ISO-8859-1.
+//
+
+#ifndef _WIN32
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
+#include <memory>
+
+typedef uint8_t  BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef uint64_t QWORD;
+typedef int      BOOL;
+typedef unsigned UINT;
+typedef int32_t  HRESULT;
+typedef uintptr_t DWORD_PTR;
+typedef int64_t  REFERENCE_TIME;
+
+typedef wchar_t WCHAR;
+
+typedef char*          LPSTR;
+typedef const char*    LPCSTR;
+typedef wchar_t*       LPWSTR;
+typedef const wchar_t* LPCWSTR;
+
+#ifndef TRUE
+#define TRUE  1
+#define FALSE 0
+#endif
+
+#define S_OK    ((HRESULT)0)
+#define S_FALSE ((HRESULT)1)
+#define E_FAIL  ((HRESULT)0x80004005)
+
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr)    (((HRESULT)(hr)) < 0)
+
+#define __noop ((void)0)
+
+#ifndef ASSERT
+#define ASSERT(x) assert(x)
+#endif
+
+//
+// byte swapping
+//
+
+inline uint16_t _byteswap_ushort(uint16_t x) { return __builtin_bswap16(x); }
+inline uint32_t _byteswap_ulong(uint32_t x)  { return __builtin_bswap32(x); }
+inline uint64_t _byteswap_uint64(uint64_t x) { return __builtin_bswap64(x); }
+
+//
+// string conversion
+//
+
+#define CP_ACP  0
+#define CP_UTF8 65001
+
+#define MB_ERR_INVALID_CHARS 0x00000008
+
+int MultiByteToWideChar(UINT CodePage, DWORD dwFlags, LPCSTR lpMultiByteStr, int cbMultiByte, LPWSTR lpWideCharStr, int cchWideChar);
+int WideCharToMultiByte(UINT CodePage, DWORD dwFlags, LPCWSTR lpWideCharStr, int cchWideChar, LPSTR lpMultiByteStr, int cbMultiByte, LPCSTR lpDefaultChar, BOOL* lpUsedDefaultChar);
+
+inline int _wcsicmp(const wchar_t* s1, const wchar_t* s2)
+{
+	while (*s1 && std::towlower(*s1) == std::towlower(*s2)) {
+		s1++;
+		s2++;
+	}
+	return (int)std::towlower(*s1) - (int)std::towlower(*s2);
+}
+
+//
+// Base64 decoding
+//
+
+#define CRYPT_STRING_BASE64 0x00000001
+
+// Only CRYPT_STRING_BASE64 is supported. Whitespace is ignored.
+BOOL CryptStringToBinaryA(LPCSTR pszString, DWORD cchString, DWORD dwFlags, BYTE* pbBinary, DWORD* pcbBinary, DWORD* pdwSkip, DWORD* pdwFlags);
+
+#endif // !_WIN32
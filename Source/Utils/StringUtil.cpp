@@ -107,6 +107,6 @@ std::string ConvertWideToUtf8(const std::wstring_view wsv)
 {
 	int count = WideCharToMultiByte(CP_UTF8, 0, wsv.data(), (int)wsv.length(), nullptr, 0, nullptr, nullptr);
 	std::string str(count, 0);
-	WideCharToMultiByte(CP_UTF8, 0, wsv.data(), -1, &str[0], count, nullptr, nullptr);
+	WideCharToMultiByte(CP_UTF8, 0, wsv.data(), (int)wsv.length(), &str[0], count, nullptr, nullptr);
 	return str;
 }
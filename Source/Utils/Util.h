@@ -6,30 +6,28 @@
 
 #pragma once
 
-#ifdef _DEBUG
+#include "Log.h"
 
-inline void DLog(std::wstring_view str)
-{
-	DbgLogInfo(LOG_TRACE, 3, str.data());
-}
-
-inline void DLog(std::string_view str)
-{
-	DbgLogInfo(LOG_TRACE, 3, str.data());
-}
+#if DLOG_LEVEL >= DLOG_LEVEL_ERROR
+#define DLogError(...) Log::Write(Log::LEVEL_ERROR, __VA_ARGS__)
+#else
+#define DLogError(...) __noop
+#endif
 
-template <typename... Args>
-inline void DLog(std::wformat_string<Args...> fmt, Args&&... args)
-{
-	DbgLogInfo(LOG_TRACE, 3, std::format(fmt, std::forward<Args>(args)...).c_str());
-}
+#if DLOG_LEVEL >= DLOG_LEVEL_WARNING
+#define DLogWarning(...) Log::Write(Log::LEVEL_WARNING, __VA_ARGS__)
+#else
+#define DLogWarning(...) __noop
+#endif
 
-template <typename... Args>
-inline void DLog(std::format_string<Args...> fmt, Args&&... args)
-{
-	DbgLogInfo(LOG_TRACE, 3, std::format(fmt, std::forward<Args>(args)...).c_str());
-}
+#if DLOG_LEVEL >= DLOG_LEVEL_INFO
+#define DLogInfo(...) Log::Write(Log::LEVEL_INFO, __VA_ARGS__)
+#else
+#define DLogInfo(...) __noop
+#endif
 
+#if DLOG_LEVEL >= DLOG_LEVEL_DEBUG
+#define DLog(...) Log::Write(Log::LEVEL_DEBUG, __VA_ARGS__)
 #define DLogIf(f,...) {if (f) DLog(__VA_ARGS__);}
 #else
 #define DLog(...) __noop
@@ -66,6 +64,8 @@ inline T round_pow2(T number, T pow2)
 	}
 }
 
+#ifdef _WIN32
+
 [[nodiscard]] bool IsWindows11_24H2OrGreater();
 LPCWSTR GetWindowsVersion();
 
@@ -87,3 +87,5 @@ HRESULT GetDataFromResource(LPVOID& data, DWORD& size, UINT resid);
 
 // Usage: SetThreadName ((DWORD)-1, "MainThread");
 void SetThreadName(DWORD dwThreadID, const char* threadName);
+
+#endif // _WIN32
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include "VoiceController.h"
+
+VoiceController::VoiceController(int voices, int quality)
+	: m_state{ std::clamp(voices, VOICECTRL_MIN_VOICES, VOICECTRL_MAX_VOICES), std::clamp(quality, 0, VOICECTRL_MAX_QUALITY) }
+{
+}
+
+bool VoiceController::Update(uint64_t renderNs, uint64_t audioNs, int activeVoices)
+{
+	if (!audioNs) {
+		return false;
+	}
+
+	// exponential moving average over about 8 blocks
+	const double load = (double)renderNs / audioNs;
+	m_load += (load - m_load) / 8;
+	m_blocks++;
+
+	if (m_load > VOICECTRL_LOAD_HIGH && m_blocks >= VOICECTRL_HOLD_DOWN) {
+		if (m_state.quality > 0) {
+			m_state.quality--;
+		}
+		else if (m_state.voices > VOICECTRL_MIN_VOICES) {
+			m_state.voices = std::max(m_state.voices * 3 / 4, VOICECTRL_MIN_VOICES);
+		}
+		else {
+			return false;
+		}
+		m_decreases++;
+		m_blocks = 0;
+		m_holdUp = std::min(m_holdUp * 2, (uint32_t)VOICECTRL_HOLD_UP_MAX);
+		return true;
+	}
+
+	if (m_load < VOICECTRL_LOAD_LOW && m_blocks >= m_holdUp) {
+		// more voices only help if the limit is reached
+		if (m_state.voices < VOICECTRL_MAX_VOICES && activeVoices >= m_state.voices - m_state.voices / 8) {
+			m_state.voices = std::min(m_state.voices + std::max(m_state.voices / 4, 8), VOICECTRL_MAX_VOICES);
+		}
+		else if (m_state.quality < VOICECTRL_MAX_QUALITY) {
+			m_state.quality++;
+		}
+		else {
+			return false;
+		}
+		m_increases++;
+		m_blocks = 0;
+		return true;
+	}
+
+	return false;
+}
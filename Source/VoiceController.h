@@ -0,0 +1,52 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+//
+// Adaptive voice limit and interpolation quality of the MIDI rendering.
+// The render load (render time / audio duration) is smoothed over the blocks.
+// Above VOICECTRL_LOAD_HIGH the interpolation quality is lowered first, then the voice limit.
+// Below VOICECTRL_LOAD_LOW the voice limit is raised if the voices are used up, otherwise the quality.
+// After a change the load must stay out of the band for a number of blocks (hysteresis),
+// lowering reacts faster than raising. Every lowering doubles the wait for the next raising,
+// so the controller does not oscillate around a limit.
+//
+
+#define VOICECTRL_LOAD_HIGH      0.70
+#define VOICECTRL_LOAD_LOW       0.35
+#define VOICECTRL_HOLD_DOWN      8  // blocks
+#define VOICECTRL_HOLD_UP        64 // blocks
+#define VOICECTRL_HOLD_UP_MAX    4096
+#define VOICECTRL_MIN_VOICES     16
+#define VOICECTRL_MAX_VOICES     1000
+#define VOICECTRL_MAX_QUALITY    2  // BASS_ATTRIB_MIDI_SRC: 0 - linear, 1 - 8 point sinc, 2 - 16 point sinc
+
+class VoiceController
+{
+public:
+	struct State {
+		int voices;
+		int quality;
+	};
+
+private:
+	State m_state;
+	double m_load = 0.0;
+	uint32_t m_blocks = 0; // since the last change
+	uint32_t m_holdUp = VOICECTRL_HOLD_UP;
+	uint64_t m_decreases = 0;
+	uint64_t m_increases = 0;
+
+public:
+	VoiceController(int voices, int quality);
+
+	// returns true if the voice limit or the quality has changed
+	bool Update(uint64_t renderNs, uint64_t audioNs, int activeVoices);
+
+	const State& GetState() const { return m_state; }
+	double GetLoad() const        { return m_load; }
+	uint64_t GetDecreases() const { return m_decreases; }
+	uint64_t GetIncreases() const { return m_increases; }
+};
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(size_t threadCount)
+{
+	m_threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++) {
+		m_threads.emplace_back(&WorkerPool::ThreadProc, this);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_startCond.notify_all();
+
+	for (auto& thread : m_threads) {
+		thread.join();
+	}
+}
+
+void WorkerPool::RunTasks()
+{
+	size_t done = 0;
+	for (;;) {
+		const size_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+		if (index >= m_count) {
+			break;
+		}
+		m_fn(m_context, index);
+		done++;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_pending -= done;
+	m_active--;
+	if (m_pending == 0 && m_active == 0) {
+		m_doneCond.notify_one();
+	}
+}
+
+void WorkerPool::ThreadProc()
+{
+	uint64_t generation = 0;
+
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_startCond.wait(lock, [&] { return m_stop || m_generation != generation; });
+			if (m_stop) {
+				return;
+			}
+			generation = m_generation;
+			m_active++;
+		}
+
+		RunTasks();
+	}
+}
+
+void WorkerPool::Run(TaskFn fn, void* context, size_t count)
+{
+	if (m_threads.empty() || count <= 1) {
+		for (size_t i = 0; i < count; i++) {
+			fn(context, i);
+		}
+		return;
+	}
+
+	{
+		// a thread that woke up late may still be in RunTasks() of the previous run
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_doneCond.wait(lock, [&] { return m_active == 0; });
+		m_fn      = fn;
+		m_context = context;
+		m_count   = count;
+		m_pending = count;
+		m_next.store(0, std::memory_order_relaxed);
+		m_generation++;
+	}
+	m_startCond.notify_all();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_active++;
+	}
+	RunTasks();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneCond.wait(lock, [&] { return m_pending == 0 && m_active == 0; });
+}
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//
+// Fixed pool of threads for fork-join work on the streaming thread.
+// Run() distributes the tasks over the pool threads and the calling thread
+// and returns when all tasks are done. It does not allocate memory.
+//
+
+class WorkerPool
+{
+public:
+	typedef void (*TaskFn)(void* context, size_t index);
+
+private:
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_mutex;
+	std::condition_variable m_startCond;
+	std::condition_variable m_doneCond;
+	uint64_t m_generation = 0;
+	bool m_stop = false;
+
+	TaskFn m_fn = nullptr;
+	void* m_context = nullptr;
+	size_t m_count = 0;
+	std::atomic<size_t> m_next = 0;
+	size_t m_pending = 0; // tasks not finished, guarded by m_mutex
+	size_t m_active = 0;  // threads in RunTasks(), guarded by m_mutex
+
+	void ThreadProc();
+	void RunTasks();
+
+public:
+	// threadCount - threads in addition to the calling thread of Run()
+	explicit WorkerPool(size_t threadCount);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	size_t GetThreadCount() const { return m_threads.size(); }
+
+	// calls fn(context, i) for every i in [0, count)
+	void Run(TaskFn fn, void* context, size_t count);
+};
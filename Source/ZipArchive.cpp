@@ -0,0 +1,793 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#include "stdafx.h"
+#include "ZipArchive.h"
+#include "Utils/ByteReader.h"
+#include "Utils/StringUtil.h"
+#include "Utils/Util.h"
+
+#define ZIP_SIG_LOCAL_HEADER  0x04034b50
+#define ZIP_SIG_CENTRAL_DIR   0x02014b50
+#define ZIP_SIG_END           0x06054b50
+#define ZIP64_SIG_END         0x06064b50
+#define ZIP64_SIG_LOCATOR     0x07064b50
+#define ZIP64_EXTRA_ID        0x0001
+
+#define ZIP_LOCAL_HEADER_SIZE 30
+#define ZIP_CENTRAL_DIR_SIZE  46
+#define ZIP_END_SIZE          22
+#define ZIP64_END_SIZE        56
+#define ZIP64_LOCATOR_SIZE    20
+#define ZIP_MAX_COMMENT       65535
+#define ZIP_MAX_DIRECTORY     (256 * 1024 * 1024)
+
+static bool ReadAt(UserFile& file, uint64_t pos, void* buffer, size_t size)
+{
+	if (!file.Seek(pos)) {
+		return false;
+	}
+
+	uint8_t* p = (uint8_t*)buffer;
+	while (size) {
+		const size_t n = file.Read(p, size);
+		if (!n) {
+			return false;
+		}
+		p += n;
+		size -= n;
+	}
+
+	return true;
+}
+
+static std::wstring ConvertZipName(const char* name, size_t size, bool utf8)
+{
+	if (utf8) {
+		return ConvertUtf8ToWide({ name, size });
+	}
+#ifdef _WIN32
+	// without the UTF-8 flag the names are in the OEM code page of the system that made the archive
+	const int len = MultiByteToWideChar(CP_OEMCP, 0, name, (int)size, nullptr, 0);
+	std::wstring wstr(len, L'\0');
+	MultiByteToWideChar(CP_OEMCP, 0, name, (int)size, wstr.data(), len);
+	return wstr;
+#else
+	return ConvertAnsiToWide({ name, size });
+#endif
+}
+
+static std::wstring NormalizeZipName(std::wstring name)
+{
+	std::replace(name.begin(), name.end(), L'\\', L'/');
+	str_tolower_all(name);
+	return name;
+}
+
+bool SplitArchivePath(const std::wstring& path, std::wstring& archivePath, std::wstring& memberName)
+{
+	std::wstring lower(path);
+	str_tolower_all(lower);
+
+	size_t pos = 0;
+	while ((pos = lower.find(L".zip", pos)) != std::wstring::npos) {
+		const size_t end = pos + 4;
+		pos = end;
+		if (end + 1 >= path.size() || (path[end] != L'\\' && path[end] != L'/')) {
+			continue;
+		}
+
+		// a folder can be named "*.zip" as well
+		std::error_code ec;
+		if (std::filesystem::is_regular_file(path.substr(0, end), ec)) {
+			archivePath = path.substr(0, end);
+			memberName = path.substr(end + 1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ReadZipDirectory(UserFile& archive, std::vector<ZipEntry_t>& entries)
+{
+	const uint64_t length = archive.GetLength();
+	if (length < ZIP_END_SIZE) {
+		return false;
+	}
+
+	// the end of central directory record is followed by the archive comment, it is searched from the end
+	const size_t tailSize = (size_t)std::min<uint64_t>(length, ZIP64_LOCATOR_SIZE + ZIP_END_SIZE + ZIP_MAX_COMMENT);
+	std::vector<uint8_t> tail(tailSize);
+	if (!ReadAt(archive, length - tailSize, tail.data(), tailSize)) {
+		return false;
+	}
+
+	size_t end = tailSize - ZIP_END_SIZE;
+	while (bytes::load<uint32_t>(&tail[end]) != ZIP_SIG_END
+			|| end + ZIP_END_SIZE + bytes::load<uint16_t>(&tail[end + 20]) > tailSize) {
+		if (end == 0) {
+			DLog(L"ZipArchive: the end of central directory is not found");
+			return false;
+		}
+		end--;
+	}
+
+	ByteReader br(&tail[end]);
+	br.SetSize(ZIP_END_SIZE);
+	br.Skip(4);
+	uint32_t disk   = br.Read16Le();
+	uint32_t cdDisk = br.Read16Le();
+	br.Skip(2); // entries on this disk
+	uint64_t count    = br.Read16Le();
+	uint64_t cdSize   = br.Read32Le();
+	uint64_t cdOffset = br.Read32Le();
+
+	if (end >= ZIP64_LOCATOR_SIZE && bytes::load<uint32_t>(&tail[end - ZIP64_LOCATOR_SIZE]) == ZIP64_SIG_LOCATOR) {
+		const uint64_t offset = bytes::load<uint64_t>(&tail[end - ZIP64_LOCATOR_SIZE + 8]);
+		uint8_t record[ZIP64_END_SIZE];
+		if (offset > length - ZIP64_END_SIZE || !ReadAt(archive, offset, record, sizeof(record))) {
+			return false;
+		}
+
+		ByteReader br64(record);
+		br64.SetSize(sizeof(record));
+		if (br64.Read32Le() != ZIP64_SIG_END) {
+			return false;
+		}
+		br64.Skip(8 + 2 + 2); // record size, versions
+		disk   = br64.Read32Le();
+		cdDisk = br64.Read32Le();
+		br64.Skip(8); // entries on this disk
+		count    = br64.Read64Le();
+		cdSize   = br64.Read64Le();
+		cdOffset = br64.Read64Le();
+	}
+
+	if (disk != 0 || cdDisk != 0) {
+		DLog(L"ZipArchive: archives on several disks are not supported");
+		return false;
+	}
+	if (cdOffset > length || cdSize > length - cdOffset || cdSize > ZIP_MAX_DIRECTORY) {
+		return false;
+	}
+
+	std::vector<uint8_t> directory((size_t)cdSize);
+	if (cdSize && !ReadAt(archive, cdOffset, directory.data(), directory.size())) {
+		return false;
+	}
+
+	entries.clear();
+	entries.reserve((size_t)std::min<uint64_t>(count, cdSize / ZIP_CENTRAL_DIR_SIZE));
+
+	ByteReader dir(directory.data());
+	dir.SetSize(directory.size());
+	for (uint64_t i = 0; i < count; i++) {
+		ByteSpan header = dir.GetSpan(ZIP_CENTRAL_DIR_SIZE);
+		if (!header || header.Read32Le() != ZIP_SIG_CENTRAL_DIR) {
+			return false;
+		}
+		ZipEntry_t entry;
+		header.Skip(2 + 2); // versions
+		entry.flags  = header.Read16Le();
+		entry.method = header.Read16Le();
+		header.Skip(2 + 2); // time, date
+		entry.crc32          = header.Read32Le();
+		entry.compressedSize = header.Read32Le();
+		entry.size           = header.Read32Le();
+		const uint16_t nameLen    = header.Read16Le();
+		const uint16_t extraLen   = header.Read16Le();
+		const uint16_t commentLen = header.Read16Le();
+		header.Skip(2 + 2 + 4); // disk, attributes
+		entry.localHeaderOffset = header.Read32Le();
+
+		ByteSpan name  = dir.GetSpan(nameLen);
+		ByteSpan extra = dir.GetSpan(extraLen);
+		if (dir.GetError() || !dir.Skip(commentLen)) {
+			return false;
+		}
+
+		// the ZIP64 extra field has the 64-bit values of the fields that are 0xFFFFFFFF, in this order
+		while (extra.GetRemainder() >= 4) {
+			const uint16_t id   = extra.Read16Le();
+			const uint16_t size = extra.Read16Le();
+			if (size > extra.GetRemainder()) {
+				break;
+			}
+			ByteSpan field(extra.GetPtr(), size);
+			extra.Skip(size);
+			if (id == ZIP64_EXTRA_ID) {
+				for (uint64_t* value : { &entry.size, &entry.compressedSize, &entry.localHeaderOffset }) {
+					if (*value == UINT32_MAX && field.GetRemainder() >= 8) {
+						*value = field.Read64Le();
+					}
+				}
+			}
+		}
+
+		entry.name = ConvertZipName((const char*)name.GetPtr(), nameLen, entry.flags & ZIP_FLAG_UTF8);
+		if (entry.name.size() && entry.name.back() != L'/') { // not a folder
+			entries.emplace_back(std::move(entry));
+		}
+	}
+
+	return true;
+}
+
+const ZipEntry_t* FindZipEntry(const std::vector<ZipEntry_t>& entries, const std::wstring& name)
+{
+	const std::wstring normalized = NormalizeZipName(name);
+	for (const auto& entry : entries) {
+		if (entry.name.size() == name.size() && NormalizeZipName(entry.name) == normalized) {
+			return &entry;
+		}
+	}
+
+	return nullptr;
+}
+
+bool GetZipDataOffset(UserFile& archive, const ZipEntry_t& entry, uint64_t& offset)
+{
+	uint8_t header[ZIP_LOCAL_HEADER_SIZE];
+	if (!ReadAt(archive, entry.localHeaderOffset, header, sizeof(header))
+			|| bytes::load<uint32_t>(header) != ZIP_SIG_LOCAL_HEADER) {
+		return false;
+	}
+
+	// the extra field of the local header can differ from the one in the central directory
+	const uint16_t nameLen  = bytes::load<uint16_t>(header + 26);
+	const uint16_t extraLen = bytes::load<uint16_t>(header + 28);
+	offset = entry.localHeaderOffset + ZIP_LOCAL_HEADER_SIZE + nameLen + extraLen;
+
+	// the data of a stored member is the member itself, different sizes mean a damaged directory
+	if (entry.method == ZIP_METHOD_STORED && !(entry.flags & ZIP_FLAG_ENCRYPTED) && entry.size != entry.compressedSize) {
+		DLog(L"ZipArchive: \"{}\" is stored with different sizes", entry.name);
+		return false;
+	}
+
+	const uint64_t length = archive.GetLength();
+	return offset <= length && entry.compressedSize <= length - offset;
+}
+
+std::unique_ptr<UserFile> OpenZipMember(std::unique_ptr<UserFile> archive, const ZipEntry_t& entry, uint64_t dataOffset)
+{
+	if (entry.flags & ZIP_FLAG_ENCRYPTED) {
+		DLog(L"ZipArchive: \"{}\" is encrypted", entry.name);
+		return nullptr;
+	}
+
+	switch (entry.method) {
+	case ZIP_METHOD_STORED:
+		return std::make_unique<ZipRangeFile>(std::move(archive), dataOffset, entry.compressedSize);
+	case ZIP_METHOD_DEFLATE:
+		return std::make_unique<InflateFile>(std::move(archive), dataOffset, entry.compressedSize, entry.size);
+	}
+
+	DLog(L"ZipArchive: \"{}\" uses the unsupported compression method {}", entry.name, entry.method);
+	return nullptr;
+}
+
+//
+// ZipRangeFile
+//
+
+ZipRangeFile::ZipRangeFile(std::unique_ptr<UserFile> archive, uint64_t offset, uint64_t length)
+	: m_archive(std::move(archive))
+	, m_offset(offset)
+	, m_length(length)
+{
+}
+
+size_t ZipRangeFile::Read(void* buffer, size_t size)
+{
+	if (m_pos >= m_length || !m_archive->Seek(m_offset + m_pos)) {
+		return 0;
+	}
+
+	const size_t n = m_archive->Read(buffer, (size_t)std::min<uint64_t>(size, m_length - m_pos));
+	m_pos += n;
+
+	return n;
+}
+
+bool ZipRangeFile::Seek(uint64_t pos)
+{
+	if (pos > m_length) {
+		return false;
+	}
+	m_pos = pos;
+
+	return true;
+}
+
+//
+// InflateFile
+//
+
+// base values and extra bits of the length and distance symbols
+static const uint16_t s_lengthBase[29] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t s_lengthExtra[29] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t s_distanceBase[30] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t s_distanceExtra[30] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+// the order of the code length code lengths in a dynamic block header
+static const uint8_t s_codeLengthOrder[19] = {
+	16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+// canonical Huffman code of the code lengths, false for an over-subscribed code
+template <typename Huffman>
+static bool BuildHuffman(Huffman& h, const uint8_t* lengths, unsigned count)
+{
+	memset(h.count, 0, sizeof(h.count));
+	for (unsigned i = 0; i < count; i++) {
+		h.count[lengths[i]]++;
+	}
+	h.count[0] = 0;
+
+	int left = 1;
+	for (unsigned len = 1; len < 16; len++) {
+		left = (left << 1) - h.count[len];
+		if (left < 0) {
+			return false;
+		}
+	}
+
+	uint16_t offsets[16];
+	uint16_t codes[16];
+	offsets[1] = 0;
+	codes[1] = 0;
+	for (unsigned len = 1; len < 15; len++) {
+		offsets[len + 1] = offsets[len] + h.count[len];
+		codes[len + 1] = (codes[len] + h.count[len]) << 1;
+	}
+
+	// the codes are stored from the most significant bit, the table is indexed by the reversed bits
+	memset(h.fast, 0, sizeof(h.fast));
+	for (unsigned symbol = 0; symbol < count; symbol++) {
+		const unsigned len = lengths[symbol];
+		if (!len) {
+			continue;
+		}
+		h.symbol[offsets[len]++] = symbol;
+
+		const unsigned code = codes[len]++;
+		if (len <= INFLATE_FAST_BITS) {
+			unsigned reversed = 0;
+			for (unsigned i = 0; i < len; i++) {
+				reversed |= ((code >> i) & 1) << (len - 1 - i);
+			}
+			for (unsigned i = reversed; i < (1u << INFLATE_FAST_BITS); i += 1u << len) {
+				h.fast[i] = (uint16_t)(symbol << 4 | len);
+			}
+		}
+	}
+
+	return true;
+}
+
+InflateFile::InflateFile(std::unique_ptr<UserFile> archive, uint64_t offset, uint64_t compressedSize, uint64_t length,
+	uint64_t checkpointSpan)
+	: m_archive(std::move(archive))
+	, m_offset(offset)
+	, m_compressedSize(compressedSize)
+	, m_length(length)
+	, m_checkpointSpan(checkpointSpan)
+	, m_input(std::make_unique<uint8_t[]>(INFLATE_INPUT_SIZE))
+	, m_window(std::make_unique<uint8_t[]>(INFLATE_WINDOW_SIZE))
+{
+	// the start of the stream, it needs no window
+	m_checkpoints.push_back({});
+}
+
+bool InflateFile::LoadInput()
+{
+	const uint64_t next = m_inBase + m_inEnd;
+	if (next >= m_compressedSize || !m_archive->Seek(m_offset + next)) {
+		return false;
+	}
+
+	const size_t n = m_archive->Read(m_input.get(), (size_t)std::min<uint64_t>(INFLATE_INPUT_SIZE, m_compressedSize - next));
+	if (!n) {
+		return false;
+	}
+	m_inBase = next;
+	m_inPos = 0;
+	m_inEnd = n;
+
+	return true;
+}
+
+void InflateFile::Refill()
+{
+	while (m_bitCount <= 56) {
+		if (m_inPos == m_inEnd && !LoadInput()) {
+			break;
+		}
+		m_bitBuf |= (uint64_t)m_input[m_inPos++] << m_bitCount;
+		m_bitCount += 8;
+	}
+}
+
+uint32_t InflateFile::GetBits(unsigned n)
+{
+	if (m_bitCount < n) {
+		Refill();
+		if (m_bitCount < n) {
+			m_overrun = true;
+			m_bitBuf = 0;
+			m_bitCount = 0;
+			return 0;
+		}
+	}
+
+	const uint32_t value = (uint32_t)(m_bitBuf & ((1ull << n) - 1));
+	m_bitBuf >>= n;
+	m_bitCount -= n;
+
+	return value;
+}
+
+// the next symbol, -1 for an invalid code
+int InflateFile::Decode(const Huffman& h)
+{
+	if (m_bitCount < 15) {
+		Refill();
+	}
+
+	const unsigned entry = h.fast[m_bitBuf & ((1u << INFLATE_FAST_BITS) - 1)];
+	unsigned len = entry & 15;
+	if (len) {
+		if (len > m_bitCount) {
+			m_overrun = true;
+			return -1;
+		}
+		m_bitBuf >>= len;
+		m_bitCount -= len;
+		return entry >> 4;
+	}
+
+	// a longer code, decoded bit by bit
+	int code = 0;
+	int first = 0;
+	int index = 0;
+	for (len = 1; len < 16 && len <= m_bitCount; len++) {
+		code |= (m_bitBuf >> (len - 1)) & 1;
+		const int count = h.count[len];
+		if (code - count < first) {
+			m_bitBuf >>= len;
+			m_bitCount -= len;
+			return h.symbol[index + (code - first)];
+		}
+		index += count;
+		first = (first + count) << 1;
+		code <<= 1;
+	}
+
+	return -1;
+}
+
+bool InflateFile::ReadDynamicTables()
+{
+	const unsigned nlen  = GetBits(5) + 257;
+	const unsigned ndist = GetBits(5) + 1;
+	const unsigned ncode = GetBits(4) + 4;
+	if (nlen > 286 || ndist > 30) {
+		return false;
+	}
+
+	uint8_t lengths[286 + 30] = {};
+	for (unsigned i = 0; i < ncode; i++) {
+		lengths[s_codeLengthOrder[i]] = (uint8_t)GetBits(3);
+	}
+	Huffman& codeLengths = m_dynLit; // built again below
+	if (!BuildHuffman(codeLengths, lengths, 19)) {
+		return false;
+	}
+
+	for (unsigned i = 0; i < nlen + ndist; ) {
+		const int symbol = Decode(codeLengths);
+		if (symbol < 0) {
+			return false;
+		}
+		if (symbol < 16) {
+			lengths[i++] = (uint8_t)symbol;
+			continue;
+		}
+
+		uint8_t len = 0;
+		unsigned repeat;
+		if (symbol == 16) {
+			if (i == 0) {
+				return false;
+			}
+			len = lengths[i - 1];
+			repeat = 3 + GetBits(2);
+		}
+		else if (symbol == 17) {
+			repeat = 3 + GetBits(3);
+		}
+		else {
+			repeat = 11 + GetBits(7);
+		}
+		if (i + repeat > nlen + ndist) {
+			return false;
+		}
+		memset(&lengths[i], len, repeat);
+		i += repeat;
+	}
+
+	// the end of block code is required
+	if (!lengths[256] || m_overrun) {
+		return false;
+	}
+
+	return BuildHuffman(m_dynLit, lengths, nlen) && BuildHuffman(m_dynDist, lengths + nlen, ndist);
+}
+
+bool InflateFile::ReadBlockHeader()
+{
+	m_final = GetBits(1);
+	const unsigned type = GetBits(2);
+
+	if (type == 0) {
+		// stored block, its length follows at the next byte boundary
+		GetBits(m_bitCount & 7);
+		const uint32_t len  = GetBits(16);
+		const uint32_t nlen = GetBits(16);
+		if (len != (~nlen & 0xFFFF)) {
+			return false;
+		}
+		m_storedLeft = len;
+		m_state = STATE_STORED;
+	}
+	else if (type == 1) {
+		struct FixedTables {
+			Huffman lit;
+			Huffman dist;
+			FixedTables() {
+				uint8_t lengths[288];
+				memset(lengths, 8, 144);
+				memset(lengths + 144, 9, 112);
+				memset(lengths + 256, 7, 24);
+				memset(lengths + 280, 8, 8);
+				BuildHuffman(lit, lengths, 288);
+				memset(lengths, 5, 30);
+				BuildHuffman(dist, lengths, 30);
+			}
+		};
+		static const FixedTables fixed;
+
+		m_lit = &fixed.lit;
+		m_dist = &fixed.dist;
+		m_state = STATE_CODES;
+	}
+	else if (type == 2) {
+		if (!ReadDynamicTables()) {
+			return false;
+		}
+		m_lit = &m_dynLit;
+		m_dist = &m_dynDist;
+		m_state = STATE_CODES;
+	}
+	else {
+		return false;
+	}
+
+	return !m_overrun;
+}
+
+void InflateFile::AddCheckpoint()
+{
+	const uint64_t bitPos = (m_inBase + m_inPos) * 8 - m_bitCount;
+
+	Checkpoint& cp = m_checkpoints.emplace_back();
+	cp.out = m_outPos;
+	cp.in = bitPos / 8;
+	cp.bits = (unsigned)(bitPos % 8);
+	cp.window = std::make_unique<uint8_t[]>(INFLATE_WINDOW_SIZE);
+	memcpy(cp.window.get(), m_window.get(), INFLATE_WINDOW_SIZE);
+}
+
+void InflateFile::Restore(const Checkpoint& cp)
+{
+	m_inBase = cp.in;
+	m_inPos = 0;
+	m_inEnd = 0;
+	m_bitBuf = 0;
+	m_bitCount = 0;
+	m_overrun = false;
+	GetBits(cp.bits);
+
+	m_state = STATE_HEADER;
+	m_final = false;
+	m_storedLeft = 0;
+	m_copyLength = 0;
+	m_outPos = cp.out;
+	if (cp.window) {
+		memcpy(m_window.get(), cp.window.get(), INFLATE_WINDOW_SIZE);
+	}
+}
+
+size_t InflateFile::Inflate(uint8_t* out, size_t size)
+{
+	const uint64_t mask = INFLATE_WINDOW_SIZE - 1;
+	uint8_t* const window = m_window.get();
+	size_t done = 0;
+
+	while (done < size) {
+		if (m_copyLength) {
+			const size_t n = std::min<size_t>(m_copyLength, size - done);
+			for (size_t i = 0; i < n; i++) {
+				const uint8_t b = window[(m_outPos - m_copyDistance) & mask];
+				out[done++] = b;
+				window[m_outPos++ & mask] = b;
+			}
+			m_copyLength -= (unsigned)n;
+			continue;
+		}
+
+		if (m_state == STATE_HEADER) {
+			if (m_final) {
+				m_state = STATE_DONE;
+				break;
+			}
+			const uint64_t last = m_checkpoints.back().out;
+			if (m_outPos > last && m_outPos - last >= m_checkpointSpan) {
+				AddCheckpoint();
+			}
+			if (!ReadBlockHeader()) {
+				m_state = STATE_ERROR;
+			}
+		}
+		else if (m_state == STATE_STORED) {
+			// the bytes left in the bit buffer first, then the input buffer
+			while (m_storedLeft && done < size && m_bitCount >= 8) {
+				const uint8_t b = (uint8_t)m_bitBuf;
+				m_bitBuf >>= 8;
+				m_bitCount -= 8;
+				out[done++] = b;
+				window[m_outPos++ & mask] = b;
+				m_storedLeft--;
+			}
+			while (m_storedLeft && done < size) {
+				if (m_inPos == m_inEnd && !LoadInput()) {
+					m_state = STATE_ERROR;
+					break;
+				}
+				const size_t n = std::min({ (size_t)m_storedLeft, size - done, m_inEnd - m_inPos });
+				memcpy(out + done, &m_input[m_inPos], n);
+				for (size_t i = 0; i < n; i++) {
+					window[(m_outPos + i) & mask] = m_input[m_inPos + i];
+				}
+				m_inPos += n;
+				m_outPos += n;
+				done += n;
+				m_storedLeft -= (uint32_t)n;
+			}
+			if (!m_storedLeft && m_state == STATE_STORED) {
+				m_state = STATE_HEADER;
+			}
+		}
+		else if (m_state == STATE_CODES) {
+			while (done < size) {
+				int symbol = Decode(*m_lit);
+				if (symbol < 256) {
+					if (symbol < 0) {
+						m_state = STATE_ERROR;
+						break;
+					}
+					out[done++] = (uint8_t)symbol;
+					window[m_outPos++ & mask] = (uint8_t)symbol;
+					continue;
+				}
+				if (symbol == 256) {
+					m_state = STATE_HEADER;
+					break;
+				}
+
+				symbol -= 257;
+				if (symbol >= 29) {
+					m_state = STATE_ERROR;
+					break;
+				}
+				const unsigned length = s_lengthBase[symbol] + GetBits(s_lengthExtra[symbol]);
+
+				symbol = Decode(*m_dist);
+				if (symbol < 0 || symbol >= 30) {
+					m_state = STATE_ERROR;
+					break;
+				}
+				const unsigned distance = s_distanceBase[symbol] + GetBits(s_distanceExtra[symbol]);
+				if (distance > m_outPos || m_overrun) {
+					m_state = STATE_ERROR;
+					break;
+				}
+
+				// copied at the start of the outer loop
+				m_copyLength = length;
+				m_copyDistance = distance;
+				break;
+			}
+		}
+		else {
+			break; // STATE_DONE, STATE_ERROR
+		}
+
+		if (m_overrun) {
+			m_state = STATE_ERROR;
+		}
+	}
+
+	if (m_state == STATE_ERROR) {
+		m_copyLength = 0;
+		DLogIf(!done, L"InflateFile: invalid compressed data at {}", m_outPos);
+	}
+	m_inflatedBytes += done;
+
+	return done;
+}
+
+bool InflateFile::MoveTo(uint64_t pos)
+{
+	// the last checkpoint at or before the position
+	const auto it = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), pos,
+		[](uint64_t pos, const Checkpoint& cp) { return pos < cp.out; });
+	const Checkpoint& cp = *std::prev(it);
+
+	if (pos < m_outPos || cp.out > m_outPos) {
+		Restore(cp);
+		m_restores++;
+	}
+
+	uint8_t skip[16 * 1024];
+	while (m_outPos < pos) {
+		if (!Inflate(skip, (size_t)std::min<uint64_t>(sizeof(skip), pos - m_outPos))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+size_t InflateFile::Read(void* buffer, size_t size)
+{
+	if (m_pos >= m_length || (m_pos != m_outPos && !MoveTo(m_pos))) {
+		return 0;
+	}
+
+	const size_t n = Inflate((uint8_t*)buffer, (size_t)std::min<uint64_t>(size, m_length - m_pos));
+	m_pos += n;
+
+	return n;
+}
+
+bool InflateFile::Seek(uint64_t pos)
+{
+	if (pos > m_length) {
+		return false;
+	}
+	// the decompression is moved on the next read, BASS can seek several times before it
+	m_pos = pos;
+
+	return true;
+}
+
+void InflateFile::GetStats(InflateStats_t& stats) const
+{
+	stats.checkpoints   = m_checkpoints.size() - 1;
+	stats.inflatedBytes = m_inflatedBytes;
+	stats.restores      = m_restores;
+}
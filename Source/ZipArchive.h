@@ -0,0 +1,165 @@
+/*
+ *  Copyright (C) 2026 v0lt
+ */
+
+#pragma once
+
+#include "UserFile.h"
+
+//
+// Members of ZIP archives are played without extraction, the path of a member is
+// the archive path followed by the member name: "d:\music\album.zip\cd1\01.flac".
+// The archive is read through a UserFile (a mapped file or a read-ahead file),
+// stored members are a range of it, deflated members are decompressed while BASS reads them.
+//
+
+#define ZIP_METHOD_STORED  0
+#define ZIP_METHOD_DEFLATE 8
+
+#define ZIP_FLAG_ENCRYPTED 0x0001
+#define ZIP_FLAG_UTF8      0x0800
+
+struct ZipEntry_t {
+	std::wstring name; // as in the archive, '/' separated
+	uint16_t flags;
+	uint16_t method;
+	uint32_t crc32;
+	uint64_t compressedSize;
+	uint64_t size;
+	uint64_t localHeaderOffset;
+};
+
+// Splits the path at the first component that is an existing file with the .zip extension.
+bool SplitArchivePath(const std::wstring& path, std::wstring& archivePath, std::wstring& memberName);
+
+// Reads the central directory, ZIP64 included. Archives that span several disks are not supported.
+bool ReadZipDirectory(UserFile& archive, std::vector<ZipEntry_t>& entries);
+
+// The comparison ignores case and treats '\' as '/'.
+const ZipEntry_t* FindZipEntry(const std::vector<ZipEntry_t>& entries, const std::wstring& name);
+
+// The position of the member data, after its local header.
+// Fails if the data is not within the archive or a stored member has different sizes.
+bool GetZipDataOffset(UserFile& archive, const ZipEntry_t& entry, uint64_t& offset);
+
+// The member as a file that owns the archive file. nullptr for encrypted members and unsupported methods.
+std::unique_ptr<UserFile> OpenZipMember(std::unique_ptr<UserFile> archive, const ZipEntry_t& entry, uint64_t dataOffset);
+
+//
+// ZipRangeFile - a stored member, reads are forwarded to the archive file
+//
+
+class ZipRangeFile : public UserFile
+{
+	std::unique_ptr<UserFile> m_archive;
+	const uint64_t m_offset;
+	const uint64_t m_length;
+	uint64_t m_pos = 0;
+
+public:
+	ZipRangeFile(std::unique_ptr<UserFile> archive, uint64_t offset, uint64_t length);
+
+	uint64_t GetLength() override { return m_length; }
+	size_t Read(void* buffer, size_t size) override;
+	bool Seek(uint64_t pos) override;
+};
+
+//
+// InflateFile - a deflated member that is decompressed on the reading thread.
+// Deflate can only be decoded from the start, so while the member is decompressed a checkpoint
+// is saved at the first block boundary after every INFLATE_CHECKPOINT_SPAN bytes of output:
+// the position in the compressed data to the bit and the last 32 KiB of output (the window).
+// A seek restores the nearest checkpoint before the position and decompresses the rest,
+// a seek beyond the decompressed part decompresses up to it and saves the checkpoints on the way.
+// The index costs 32 KiB per span, 3% of the decompressed size with 1 MiB spans.
+//
+
+#define INFLATE_WINDOW_SIZE     32768
+#define INFLATE_INPUT_SIZE      (64 * 1024)
+#define INFLATE_FAST_BITS       10
+#define INFLATE_CHECKPOINT_SPAN (1024 * 1024)
+
+struct InflateStats_t {
+	uint64_t checkpoints;
+	uint64_t inflatedBytes; // decompressed bytes, the bytes skipped after seeks included
+	uint64_t restores;      // seeks that restarted the decompression from a checkpoint
+};
+
+class InflateFile : public UserFile
+{
+	struct Huffman {
+		uint16_t fast[1 << INFLATE_FAST_BITS]; // symbol << 4 | length of the codes up to INFLATE_FAST_BITS, 0 - longer code
+		uint16_t count[16];                    // number of codes of each length
+		uint16_t symbol[288];                  // symbols ordered by code
+	};
+
+	struct Checkpoint {
+		uint64_t out;  // position in the decompressed data
+		uint64_t in;   // position in the compressed data
+		unsigned bits; // bits of the byte at "in" that belong to the previous block
+		std::unique_ptr<uint8_t[]> window;
+	};
+
+	enum State {
+		STATE_HEADER, // the next block starts
+		STATE_STORED,
+		STATE_CODES,
+		STATE_DONE,
+		STATE_ERROR,
+	};
+
+	std::unique_ptr<UserFile> m_archive;
+	const uint64_t m_offset;
+	const uint64_t m_compressedSize;
+	const uint64_t m_length;
+	const uint64_t m_checkpointSpan;
+	uint64_t m_pos = 0; // the read position, the decompression continues from m_outPos
+
+	// input
+	std::unique_ptr<uint8_t[]> m_input;
+	uint64_t m_inBase = 0; // position of m_input in the compressed data
+	size_t m_inPos = 0;
+	size_t m_inEnd = 0;
+	uint64_t m_bitBuf = 0;
+	unsigned m_bitCount = 0;
+	bool m_overrun = false; // more bits were consumed than the compressed data has
+
+	// decompression
+	State m_state = STATE_HEADER;
+	bool m_final = false;
+	uint32_t m_storedLeft = 0;
+	unsigned m_copyLength = 0;
+	unsigned m_copyDistance = 0;
+	const Huffman* m_lit = nullptr;
+	const Huffman* m_dist = nullptr;
+	Huffman m_dynLit;
+	Huffman m_dynDist;
+	std::unique_ptr<uint8_t[]> m_window;
+	uint64_t m_outPos = 0;
+
+	std::vector<Checkpoint> m_checkpoints;
+	uint64_t m_inflatedBytes = 0;
+	uint64_t m_restores = 0;
+
+	bool LoadInput();
+	void Refill();
+	uint32_t GetBits(unsigned n);
+	int Decode(const Huffman& h);
+	bool ReadBlockHeader();
+	bool ReadDynamicTables();
+	void AddCheckpoint();
+	void Restore(const Checkpoint& cp);
+	size_t Inflate(uint8_t* out, size_t size);
+	bool MoveTo(uint64_t pos);
+
+public:
+	// checkpointSpan - UINT64_MAX disables the index, every backward seek decompresses from the start
+	InflateFile(std::unique_ptr<UserFile> archive, uint64_t offset, uint64_t compressedSize, uint64_t length,
+		uint64_t checkpointSpan = INFLATE_CHECKPOINT_SPAN);
+
+	uint64_t GetLength() override { return m_length; }
+	size_t Read(void* buffer, size_t size) override;
+	bool Seek(uint64_t pos) override;
+
+	void GetStats(InflateStats_t& stats) const;
+};
@@ -24,6 +24,9 @@
 #include <InitGuid.h>
 #include "BassSource.h"
 #include "PropPage.h"
+#include "SettingsCache.h"
+#include "SoundFontCache.h"
+#include "SoundFontCatalog.h"
 #include "dllmain.h"
 
 #define STR_GUID_REGISTRY "{FFFB1509-D0C1-4E23-8DAC-4BF554615BB6}" // need a large enough value to be at the end of the list
@@ -137,6 +140,12 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD  dwReason, LPVOID lpReserved)
 	if (dwReason == DLL_PROCESS_ATTACH) {
 		HInstance = hModule;
 	}
+	else if (dwReason == DLL_PROCESS_DETACH && !lpReserved) {
+		// FreeLibrary, at process exit the thread pool is already gone
+		SettingsCache::Shutdown();
+		SoundFontCache::Shutdown();
+		SoundFontCatalog::Shutdown();
+	}
 
 	return DllEntryPoint((HINSTANCE)(hModule), dwReason, lpReserved);
 }
@@ -9,6 +9,7 @@
 
 #pragma comment(lib, "winmm.lib")
 #pragma comment(lib, "Crypt32.lib")
+#pragma comment(lib, "winhttp.lib")
 
 #ifdef _WIN64
 #pragma comment(lib, "../Lib/x64/bass.lib")
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#ifdef _WIN32
+
 #define WIN32_LEAN_AND_MEAN // Exclude rarely-used stuff from Windows headers
 #define VC_EXTRALEAN        // Exclude rarely-used stuff from Windows headers
 
@@ -16,9 +18,18 @@
 
 #include <VersionHelpers.h>
 
+#else
+
+// portable core build (CMake)
+#include "Utils/Platform.h"
+
+#endif
+
 #include <algorithm>
 #include <vector>
 #include <list>
 #include <string>
+#if __has_include(<format>)
 #include <format>
+#endif
 #include <filesystem>